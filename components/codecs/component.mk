@@ -9,7 +9,6 @@ COMPONENT_ADD_LDFLAGS=-l$(COMPONENT_NAME) 	\
 	$(COMPONENT_PATH)/lib/libvorbisidec.a	\
 	$(COMPONENT_PATH)/lib/libogg.a			\
 	$(COMPONENT_PATH)/lib/libalac.a			\
-	$(COMPONENT_PATH)/lib/libresample16.a	\
 	$(COMPONENT_PATH)/lib/libopusfile.a		\
 	$(COMPONENT_PATH)/lib/libopus.a 		
 	
@@ -231,12 +231,62 @@ static void IRAM_ATTR DrawPixel24Fast( struct GDS_Device* Device, int X, int Y,
 	*FBOffset++ = Color >> 16; *FBOffset++ = Color >> 8; *FBOffset = Color;
 }
 
+static void IRAM_ATTR DrawHSpan1( struct GDS_Device* Device, int X, int Y, int Len, int Color ) {
+	uint8_t* FBOffset = Device->Framebuffer + ( Y >> 3 ) * Device->Width + X;
+	uint8_t Bit = BIT( Y & 0x07 );
+
+	if ( Color == GDS_COLOR_XOR ) while (Len--) *FBOffset++ ^= Bit;
+	else if ( Color == GDS_COLOR_BLACK ) while (Len--) *FBOffset++ &= ~Bit;
+	else while (Len--) *FBOffset++ |= Bit;
+}
+
+static void IRAM_ATTR DrawHSpan4( struct GDS_Device* Device, int X, int Y, int Len, int Color ) {
+	uint8_t* FBOffset = Device->Framebuffer + ( (Y * Device->Width + X) >> 1 );
+	// odd X is in high nibble, unless HighNibble is set
+	bool High = !Device->HighNibble;
+
+	Color &= 0x0f;
+	if (X & 0x01) {
+		*FBOffset = High ? (*FBOffset & 0x0f) | (Color << 4) : (*FBOffset & 0xf0) | Color;
+		FBOffset++; Len--;
+	}
+	if (Len >> 1) memset( FBOffset, Color | (Color << 4), Len >> 1 );
+	if (Len & 0x01) {
+		FBOffset += Len >> 1;
+		*FBOffset = High ? (*FBOffset & 0xf0) | Color : (*FBOffset & 0x0f) | (Color << 4);
+	}	
+}
+
+static void IRAM_ATTR DrawHSpan8( struct GDS_Device* Device, int X, int Y, int Len, int Color ) {
+	memset( Device->Framebuffer + Y * Device->Width + X, Color, Len );
+}
+
+static void IRAM_ATTR DrawHSpan16( struct GDS_Device* Device, int X, int Y, int Len, int Color ) {
+	uint16_t* FBOffset = (uint16_t*) Device->Framebuffer + Y * Device->Width + X;
+	uint16_t Pixel = __builtin_bswap16(Color);
+	while (Len--) *FBOffset++ = Pixel;
+}
+
+static void IRAM_ATTR DrawHSpan18( struct GDS_Device* Device, int X, int Y, int Len, int Color ) {
+	uint8_t* FBOffset = Device->Framebuffer + (Y * Device->Width + X) * 3;
+	uint8_t R = Color >> 12, G = (Color >> 6) & 0x3f, B = Color & 0x3f;
+	while (Len--) { *FBOffset++ = R; *FBOffset++ = G; *FBOffset++ = B; }
+}
+
+static void IRAM_ATTR DrawHSpan24( struct GDS_Device* Device, int X, int Y, int Len, int Color ) {
+	uint8_t* FBOffset = Device->Framebuffer + (Y * Device->Width + X) * 3;
+	uint8_t R = Color >> 16, G = Color >> 8, B = Color;
+	while (Len--) { *FBOffset++ = R; *FBOffset++ = G; *FBOffset++ = B; }
+}
+
 bool GDS_Init( struct GDS_Device* Device ) {
 	GDS_CHECK_FOR_DEVICE(Device,return false);
+	GDS_FontInit();
+	
 	if (Device->Depth > 8) Device->FramebufferSize = Device->Width * Device->Height * ((8 + Device->Depth - 1) / 8);
 	else Device->FramebufferSize = (Device->Width * Device->Height) / (8 / Device->Depth);
     
-    // set the proper DrawPixel function if not already set by driver
+    // set the proper DrawPixel & DrawHSpan functions if not already set by driver
     if (!Device->DrawPixelFast) {
         if (Device->Depth == 1) Device->DrawPixelFast = DrawPixel1Fast;
         else if (Device->Depth == 4 && Device->HighNibble) Device->DrawPixelFast = DrawPixel4FastHigh;
@@ -245,6 +295,15 @@ bool GDS_Init( struct GDS_Device* Device ) {
         else if (Device->Depth == 16) Device->DrawPixelFast = DrawPixel16Fast;	
         else if (Device->Depth == 24 && Device->Mode == GDS_RGB666) Device->DrawPixelFast = DrawPixel18Fast;	
         else if (Device->Depth == 24 && Device->Mode == GDS_RGB888) Device->DrawPixelFast = DrawPixel24Fast;	
+
+        if (!Device->DrawHSpan) {
+            if (Device->Depth == 1) Device->DrawHSpan = DrawHSpan1;
+            else if (Device->Depth == 4) Device->DrawHSpan = DrawHSpan4;
+            else if (Device->Depth == 8) Device->DrawHSpan = DrawHSpan8;
+            else if (Device->Depth == 16) Device->DrawHSpan = DrawHSpan16;
+            else if (Device->Depth == 24 && Device->Mode == GDS_RGB666) Device->DrawHSpan = DrawHSpan18;
+            else if (Device->Depth == 24 && Device->Mode == GDS_RGB888) Device->DrawHSpan = DrawHSpan24;
+        }
     }	
 	
 	// allocate FB unless explicitely asked not to
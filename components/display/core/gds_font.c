@@ -6,9 +6,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "gds_private.h"
 #include "gds.h"
 #include "gds_font.h"
@@ -29,73 +32,222 @@ static const uint8_t* GetCharPtr( const struct GDS_FontDef* Font, char Character
     return &Font->FontData[ ( Character - Font->StartChar ) * ( ( Font->Width * ( RoundUpFontHeight( Font ) / 8 ) ) + 1 ) ];
 }
 
-void GDS_FontDrawChar( struct GDS_Device* Device, char Character, int x, int y, int Color ) {
-    const uint8_t* GlyphData = NULL;
-    int GlyphColumnLen = 0;
-    int CharStartX =  0;
-    int CharStartY = 0;
-    int CharWidth = 0;
-    int CharHeight = 0;
-    int CharEndX = 0;
-    int CharEndY = 0;
-    int OffsetX = 0;
-    int OffsetY = 0;
-    int YByte = 0;
-    int YBit = 0;
-    int i = 0;
+/*
+ * Glyphs are converted once into runs of lit pixels (one run = horizontal segment
+ * of a row) so that drawing a character is a few span fills instead of testing 
+ * every bit and calling DrawPixel. Strings are cached the same way as a whole, 
+ * which makes scrolling or refreshing the same title just a replay of runs.
+ * Caches are shared by all devices and tasks, so lookup, insert and the drawing 
+ * of what they return are done under CacheMutex (eviction frees runs).
+ */
+#define GLYPH_CACHE_FONTS	4
+#define LINE_CACHE_SIZE		4
+
+struct GDS_Run {
+	uint16_t X;
+	uint8_t Y, Len;
+};
+
+struct GlyphRuns {
+	uint16_t Count;
+	struct GDS_Run Runs[];
+};
+
+static struct GlyphCache {
+	const struct GDS_FontDef* Font;
+	struct GlyphRuns** Glyphs;
+	uint32_t Used;
+} GlyphCache[GLYPH_CACHE_FONTS];
+
+static struct LineCache {
+	const struct GDS_FontDef* Font;
+	bool Monospace, Proportional;
+	char* Text;
+	int Count;
+	struct GDS_Run* Runs;
+	uint32_t Used;
+} LineCache[LINE_CACHE_SIZE];
+
+static uint32_t GlyphCacheClock, LineCacheClock;
+static SemaphoreHandle_t CacheMutex;
+static StaticSemaphore_t CacheMutexBuffer;
+
+void GDS_FontInit( void ) {
+    if ( !CacheMutex ) CacheMutex = xSemaphoreCreateMutexStatic( &CacheMutexBuffer );
+}
 
-    NullCheck( ( GlyphData = GetCharPtr( Device->Font, Character ) ), return );
+static struct GlyphRuns* BuildGlyphRuns( const struct GDS_FontDef* Font, char Character ) {
+    const uint8_t* GlyphData = GetCharPtr( Font, Character ) + 1;
+    int GlyphColumnLen = RoundUpFontHeight( Font ) / 8;
+    struct GlyphRuns* Glyph = NULL;
+    int Count = 0;
+
+    // count first, then fill
+    for ( int Pass = 0; Pass < 2; Pass++ ) {
+        for ( int y = 0, n = 0; y < Font->Height; y++ ) {
+            for ( int x = 0; x < Font->Width; ) {
+                if ( !( GlyphData[ x * GlyphColumnLen + y / 8 ] & BIT( y & 0x07 ) ) ) {
+                    x++;
+                    continue;
+                }
+
+                int Start = x;
+                while ( x < Font->Width && ( GlyphData[ x * GlyphColumnLen + y / 8 ] & BIT( y & 0x07 ) ) ) x++;
+
+                if ( Pass ) Glyph->Runs[ n++ ] = (struct GDS_Run) { .X = Start, .Y = y, .Len = x - Start };
+                else Count++;
+            }
+        }
 
-    if ( Character >= Device->Font->StartChar && Character <= Device->Font->EndChar ) {
-        /* The first byte in the glyph data is the width of the character in pixels, skip over */
-        GlyphData++;
-        GlyphColumnLen = RoundUpFontHeight( Device->Font ) / 8;
-        
-        CharWidth = GDS_FontGetCharWidth( Device, Character );
-        CharHeight = GDS_FontGetHeight( Device );
+        if ( !Pass ) {
+            NullCheck( ( Glyph = malloc( sizeof( struct GlyphRuns ) + Count * sizeof( struct GDS_Run ) ) ), return NULL );
+            Glyph->Count = Count;
+        }
+    }
+
+    return Glyph;
+}
+
+static const struct GlyphRuns* GetGlyphRuns( const struct GDS_FontDef* Font, char Character ) {
+    struct GlyphCache* Cache = NULL, *Oldest = GlyphCache;
+    int Index = Character - Font->StartChar;
+
+    for ( int i = 0; i < GLYPH_CACHE_FONTS && !Cache; i++ ) {
+        if ( GlyphCache[ i ].Font == Font ) Cache = GlyphCache + i;
+        else if ( GlyphCache[ i ].Used < Oldest->Used ) Oldest = GlyphCache + i;
+    }
 
-        CharStartX = x;
-        CharStartY = y;
-        
-        CharEndX = CharStartX + CharWidth;
-        CharEndY = CharStartY + CharHeight;
+    // new font, use a free slot (never used) or recycle least recently used one
+    if ( !Cache ) {
+        Cache = Oldest;
 
-        /* If the character is partially offscreen offset the end by
-        * distance between (coord) and 0.
-        */
-        OffsetX = ( CharStartX < 0 ) ? abs( CharStartX ) : 0;
-        OffsetY = ( CharStartY < 0 ) ? abs( CharStartY ) : 0;
+        if ( Cache->Glyphs ) {
+            for ( int i = 0; i <= Cache->Font->EndChar - Cache->Font->StartChar; i++ ) free( Cache->Glyphs[ i ] );
+            free( Cache->Glyphs );
+        }
+
+        Cache->Font = Font;
+        Cache->Glyphs = calloc( Font->EndChar - Font->StartChar + 1, sizeof( struct GlyphRuns* ) );
+        if ( !Cache->Glyphs ) {
+            Cache->Font = NULL;
+            Cache->Used = 0;
+            return NULL;
+        }
+    }
 
-        /* This skips into the proper column within the glyph data */
-        GlyphData+= ( OffsetX * GlyphColumnLen );
+    Cache->Used = ++GlyphCacheClock;
 
-        CharStartX+= OffsetX;
-        CharStartY+= OffsetY;
+    if ( !Cache->Glyphs[ Index ] ) Cache->Glyphs[ Index ] = BuildGlyphRuns( Font, Character );
+
+    return Cache->Glyphs[ Index ];
+}
+
+/* 
+ * Same clipping as the historical per-pixel renderer: anything left or above the screen
+ * is skipped and a character that reaches the right or bottom edge stops one pixel 
+ * before it, so the last column (of TextWidth) and row are never drawn
+ */
+static void DrawRuns( struct GDS_Device* Device, const struct GDS_Run* Runs, int Count, int x, int y, int Width, int Color ) {
+    int MaxX = Device->TextWidth - 1, MaxY = Device->Height - 1;
+
+    for ( ; Count--; Runs++ ) {
+        int X1 = x + Runs->X, X2 = X1 + Runs->Len, Y = y + Runs->Y;
+
+        if ( Runs->X >= Width || Y < 0 || Y >= MaxY ) continue;
+        if ( Runs->X + Runs->Len > Width ) X2 = x + Width;
+        if ( X1 < 0 ) X1 = 0;
+        if ( X2 > MaxX ) X2 = MaxX;
+        if ( X1 < X2 ) DrawHSpan( Device, X1, Y, X2 - X1, Color );
+    }
+}
+
+static void FontDrawChar( struct GDS_Device* Device, char Character, int x, int y, int Color ) {
+    const struct GlyphRuns* Glyph = NULL;
+    int CharWidth = 0;
+
+    if ( Character >= Device->Font->StartChar && Character <= Device->Font->EndChar ) {
+        CharWidth = GDS_FontGetCharWidth( Device, Character );
 
         /* Do not attempt to draw if this character is entirely offscreen */
-        if ( CharEndX < 0 || CharStartX >= Device->TextWidth || CharEndY < 0 || CharStartY >= Device->Height ) {
+        if ( x + CharWidth < 0 || x >= Device->TextWidth || y + Device->Font->Height < 0 || y >= Device->Height ) {
             ClipDebug( x, y );
             return;
         }
 
-        /* Do not attempt to draw past the end of the screen */
-        CharEndX = ( CharEndX >= Device->TextWidth ) ? Device->TextWidth - 1 : CharEndX;
-        CharEndY = ( CharEndY >= Device->Height ) ? Device->Height - 1 : CharEndY;
-		Device->Dirty = true;
+        NullCheck( ( Glyph = GetGlyphRuns( Device->Font, Character ) ), return );
+
+        Device->Dirty = true;
+        DrawRuns( Device, Glyph->Runs, Glyph->Count, x, y, CharWidth, Color );
+    }
+}
 
-        for ( x = CharStartX; x < CharEndX; x++ ) {
-            for ( y = CharStartY, i = 0; y < CharEndY && i < CharHeight; y++, i++ ) {
-                YByte = ( i + OffsetY ) / 8;
-                YBit = ( i + OffsetY ) & 0x07;
+void GDS_FontDrawChar( struct GDS_Device* Device, char Character, int x, int y, int Color ) {
+    xSemaphoreTake( CacheMutex, portMAX_DELAY );
+    FontDrawChar( Device, Character, x, y, Color );
+    xSemaphoreGive( CacheMutex );
+}
 
-                if ( GlyphData[ YByte ] & BIT( YBit ) ) {
-                    DrawPixel( Device, x, y, Color );
-                }            
-            }
+static const struct LineCache* GetLineRuns( struct GDS_Device* Display, const char* Text ) {
+    struct LineCache* Line = LineCache;
+    int Count = 0, x = 0;
 
-            GlyphData+= GlyphColumnLen;
+    for ( int i = 0; i < LINE_CACHE_SIZE; i++ ) {
+        struct LineCache* Entry = LineCache + i;
+        if ( Entry->Text && Entry->Font == Display->Font && Entry->Monospace == Display->FontForceMonospace &&
+             Entry->Proportional == Display->FontForceProportional && !strcmp( Entry->Text, Text ) ) {
+            Entry->Used = ++LineCacheClock;
+            return Entry;
         }
+        if ( Entry->Used < Line->Used ) Line = Entry;
     }
+
+    // re-use least recently used entry
+    free( Line->Text );
+    free( Line->Runs );
+    memset( Line, 0, sizeof( struct LineCache ) );
+
+    for ( const char* p = Text; *p; p++ ) {
+        if ( *p >= Display->Font->StartChar && *p <= Display->Font->EndChar ) {
+            const struct GlyphRuns* Glyph = GetGlyphRuns( Display->Font, *p );
+            NullCheck( Glyph, return NULL );
+            Count += Glyph->Count;
+        }
+    }
+
+    Line->Text = strdup( Text );
+    Line->Runs = malloc( Count * sizeof( struct GDS_Run ) + 1 );
+    if ( !Line->Text || !Line->Runs ) {
+        free( Line->Text );
+        free( Line->Runs );
+        Line->Text = NULL;
+        Line->Runs = NULL;
+        return NULL;
+    }
+
+    // concatenate glyphs, trimmed to the width they have in this string
+    for ( const char* p = Text; *p; p++ ) {
+        if ( *p < Display->Font->StartChar || *p > Display->Font->EndChar ) continue;
+
+        const struct GlyphRuns* Glyph = GetGlyphRuns( Display->Font, *p );
+        int CharWidth = GDS_FontGetCharWidth( Display, *p );
+
+        for ( int i = 0; i < Glyph->Count; i++ ) {
+            struct GDS_Run Run = Glyph->Runs[ i ];
+            if ( Run.X >= CharWidth ) continue;
+            if ( Run.X + Run.Len > CharWidth ) Run.Len = CharWidth - Run.X;
+            Run.X += x;
+            Line->Runs[ Line->Count++ ] = Run;
+        }
+
+        x += CharWidth;
+    }
+
+    Line->Font = Display->Font;
+    Line->Monospace = Display->FontForceMonospace;
+    Line->Proportional = Display->FontForceProportional;
+    Line->Used = ++LineCacheClock;
+
+    return Line;
 }
 
 const struct GDS_FontDef* GDS_SetFont( struct GDS_Device* Display, const struct GDS_FontDef* Font ) {
@@ -173,17 +325,32 @@ int GDS_FontMeasureString( struct GDS_Device* Display, const char* Text ) {
 }
 
 void GDS_FontDrawString( struct GDS_Device* Display, int x, int y, const char* Text, int Color ) {
-    int Len = 0;
-    int i = 0;
+    const struct LineCache* Line = NULL;
+    int Width = 0;
 
     NullCheck( Text, return );
 
-    for ( Len = strlen( Text ), i = 0; i < Len; i++ ) {
-        GDS_FontDrawChar( Display, *Text, x, y, Color );
+    Width = GDS_FontMeasureString( Display, Text );
 
-        x+= GDS_FontGetCharWidth( Display, *Text );
-        Text++;
+    if ( x + Width < 0 || x >= Display->TextWidth || y + Display->Font->Height < 0 || y >= Display->Height ) {
+        ClipDebug( x, y );
+        return;
     }
+
+    xSemaphoreTake( CacheMutex, portMAX_DELAY );
+
+    // use cached runs unless we are out of memory
+    if ( ( Line = GetLineRuns( Display, Text ) ) == NULL ) {
+        for ( ; *Text; Text++ ) {
+            FontDrawChar( Display, *Text, x, y, Color );
+            x+= GDS_FontGetCharWidth( Display, *Text );
+        }
+    } else {
+        Display->Dirty = true;
+        DrawRuns( Display, Line->Runs, Line->Count, x, y, Width, Color );
+    }
+
+    xSemaphoreGive( CacheMutex );
 }
 
 void GDS_FontDrawAnchoredString( struct GDS_Device* Display, TextAnchor Anchor, const char* Text, int Color ) {
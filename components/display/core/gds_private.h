@@ -122,6 +122,8 @@ struct GDS_Device {
 	// must provide for depth other than 1 (vertical) and 4 (may provide for optimization)
 	void (*DrawPixelFast)( struct GDS_Device* Device, int X, int Y, int Color );
 	void (*DrawBitmapCBR)(struct GDS_Device* Device, uint8_t *Data, int Width, int Height, int Color );
+	// horizontal run of pixels, set by default when DrawPixelFast is (may provide for optimization)
+	void (*DrawHSpan)( struct GDS_Device* Device, int X, int Y, int Len, int Color );
 	// may provide for optimization
 	void (*DrawRGB)( struct GDS_Device* Device, uint8_t *Image,int x, int y, int Width, int Height, int RGB_Mode );
 	void (*ClearWindow)( struct GDS_Device* Device, int x1, int y1, int x2, int y2, int Color );
@@ -138,6 +140,7 @@ struct GDS_Device {
 
 bool GDS_Reset( struct GDS_Device* Device );
 bool GDS_Init( struct GDS_Device* Device );
+void GDS_FontInit( void );
 
 static inline bool IsPixelVisible( struct GDS_Device* Device, int x, int y )  {
     bool Result = (
@@ -162,4 +165,9 @@ static inline void IRAM_ATTR DrawPixel( struct GDS_Device* Device, int x, int y,
     }
 }
 
+static inline void IRAM_ATTR DrawHSpan( struct GDS_Device* Device, int x, int y, int Len, int Color ) {
+    if ( Device->DrawHSpan ) Device->DrawHSpan( Device, x, y, Len, Color );
+    else for ( Len += x; x < Len; x++ ) Device->DrawPixelFast( Device, x, y, Color );
+}
+
 #endif
\ No newline at end of file
@@ -106,9 +106,10 @@ bool GDS_TextLine(struct GDS_Device* Device, int N, int Pos, int Attr, char *Tex
 	// erase if requested
 	if (Attr & GDS_TEXT_CLEAR) {
 		int Y_min = max(0, Device->Lines[N].Y), Y_max = max(0, Device->Lines[N].Y + Device->Lines[N].Font->Height);
-		for (int c = (Attr & GDS_TEXT_CLEAR_EOL) ? X : 0; c < Device->TextWidth; c++) 
+		int X_min = (Attr & GDS_TEXT_CLEAR_EOL) ? max(0, X) : 0;
+		if (X_min < Device->TextWidth) 
 			for (int y = Y_min; y < Y_max; y++)
-				Device->DrawPixelFast( Device, c, y, GDS_COLOR_BLACK );
+				DrawHSpan( Device, X_min, y, Device->TextWidth - X_min, GDS_COLOR_BLACK );
 	}
 		
 	GDS_FontDrawString( Device, X, Device->Lines[N].Y, Text, GDS_COLOR_WHITE );
@@ -13,6 +13,7 @@
 #include "esp_log.h"
 #include "globdefs.h"
 #include "platform_config.h"
+#include "topology.h"
 #include "tools.h"
 #include "display.h"
 #include "services.h"
@@ -163,7 +164,9 @@ void display_init(char *welcome) {
 		displayer.by = 2;
 		displayer.pause = 3600;
 		displayer.speed = 33;
-		displayer.task = xTaskCreateStatic( (TaskFunction_t) displayer_task, "common_displayer", DISPLAYER_STACK_SIZE, NULL, ESP_TASK_PRIO_MIN + 1, xStack, &xTaskBuffer);
+		displayer.task = xTaskCreateStaticPinnedToCore( (TaskFunction_t) displayer_task, "common_displayer", DISPLAYER_STACK_SIZE, NULL, 
+														topology_priority("common_displayer", ESP_TASK_PRIO_MIN + 1), xStack, &xTaskBuffer,
+														topology_core("common_displayer", tskNO_AFFINITY));
 		
 		// set lines for "fixed" text mode
 		GDS_TextSetFontAuto(display, 1, GDS_FONT_LINE_1, -3);
@@ -13,10 +13,11 @@
 #include "esp_app_format.h"
 #include "tools.h"
 #include "messaging.h"
+#include "topology.h"
 
 extern esp_err_t process_recovery_ota(const char * bin_url, char * bin_buffer, uint32_t length);
 static const char * TAG = "squeezelite_cmd";
-#define SQUEEZELITE_THREAD_STACK_SIZE (8*1024)
+#define SQUEEZELITE_THREAD_STACK_SIZE (12*1024)
 
 const __attribute__((section(".rodata_desc"))) esp_app_desc_t esp_app_desc = {
 
@@ -133,7 +134,8 @@ static int launchsqueezelite(int argc, char **argv) {
 
 	ESP_LOGD(TAG,"Starting Squeezelite Thread");
 	xTaskCreateStaticPinnedToCore(squeezelite_thread, "squeezelite", SQUEEZELITE_THREAD_STACK_SIZE, 
-					  NULL, CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT, xStack, &xTaskBuffer, CONFIG_PTHREAD_TASK_CORE_DEFAULT);
+					  NULL, topology_priority("squeezelite", CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT), xStack, &xTaskBuffer, 
+					  topology_core("squeezelite", CONFIG_PTHREAD_TASK_CORE_DEFAULT));
 	ESP_LOGD(TAG ,"Back to console thread!");
 
     return 0;
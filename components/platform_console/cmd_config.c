@@ -177,8 +177,8 @@ static struct {
 #endif
 #if RESAMPLE16
     struct arg_lit *resample;
-    struct arg_str *resample_parms; //" -R -u [params]\tResample, params = (b|l|m)[:i],\n"
-//			   "   \t\t\t b = basic linear interpolation, l = 13 taps, m = 21 taps, i = interpolate filter coefficients\n"
+    struct arg_str *resample_parms; //" -R -u [params]\tResample, params = (b|l|m|h),\n"
+//			   "   \t\t\t b = basic linear interpolation, l = 8 taps, m = 16 taps, h = 32 taps polyphase\n"
 #endif
     struct arg_int *rate; //			   "  -Z <rate>\t\tReport rate to server in helo as the maximum sample rate we can support\n"
     struct arg_end *end;
@@ -1385,7 +1385,7 @@ static void register_squeezelite_config(void) {
 #endif
 #if RESAMPLE16
     squeezelite_args.resample = arg_lit0("R", "resample", "Activate Resample");
-    squeezelite_args.resample_parms = arg_str0("u", "resample_parms", "(b|l|m)[:i]", "Resample, params. b = basic linear interpolation, l = 13 taps, m = 21 taps, i = interpolate filter coefficients");
+    squeezelite_args.resample_parms = arg_str0("u", "resample_parms", "(b|l|m|h)", "Resample, params. b = basic linear interpolation, l = 8 taps, m = 16 taps, h = 32 taps polyphase");
 #endif
     squeezelite_args.rate = arg_int0("Z", "max_rate", "<n>", "Report rate to server in helo as the maximum sample rate we can support");
     squeezelite_args.end = arg_end(6);
@@ -31,6 +31,8 @@
 #include "messaging.h"				  
 #include "platform_console.h"
 #include "tools.h"
+#include "trace.h"
+#include "topology.h"
 
 #ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
 #pragma message("Runtime stats enabled")
@@ -55,6 +57,17 @@ EXT_RAM_ATTR static struct {
 #endif  
     struct arg_end *end;
 } set_services_args;
+EXT_RAM_ATTR static struct {
+	struct arg_lit *start;
+	struct arg_lit *stop;
+	struct arg_lit *rate;
+	struct arg_int *top;
+	struct arg_end *end;
+} memtrack_args;
+EXT_RAM_ATTR static struct {
+	struct arg_str *profile;
+	struct arg_end *end;
+} topology_args;
 static const char * TAG = "cmd_system";
 
 //static void register_setbtsource();
@@ -62,6 +75,8 @@ static void register_free();
 static void register_setdevicename();
 static void register_heap();
 static void register_dump_heap();
+static void register_memtrack();
+static void register_topology();
 static void register_abort();
 static void register_version();
 static void register_restart();
@@ -91,6 +106,8 @@ void register_system()
     register_free();
     register_heap();
     register_dump_heap();
+    register_memtrack();
+    register_topology();
     register_abort();
     register_version();
     register_restart();
@@ -524,6 +541,88 @@ static void register_dump_heap()
 
 }
 
+/* 'memtrack' command tracks allocations per call site */
+static int memtrack(int argc, char **argv)
+{
+    const size_t size = 2048;
+    int nerrors = arg_parse_msg(argc, argv, (struct arg_hdr **)&memtrack_args);
+    if (nerrors != 0) {
+        return 1;
+    }
+    if (memtrack_args.stop->count) {
+        memtrack_stop();
+        cmd_send_messaging(argv[0], MESSAGING_INFO, "Allocation tracking stopped");
+        return 0;
+    }
+    if (memtrack_args.start->count && !memtrack_start()) {
+        cmd_send_messaging(argv[0], MESSAGING_ERROR, "Unable to start tracking (needs CONFIG_MEMTRACK and memory for tables)");
+        return 1;
+    }
+    char *buf = malloc_init_external(size);
+    if (buf == NULL) {
+        cmd_send_messaging(argv[0], MESSAGING_ERROR, "failed to allocate buffer for report");
+        return 1;
+    }
+    memtrack_report(buf, size, memtrack_args.top->count ? memtrack_args.top->ival[0] : 10, memtrack_args.rate->count);
+    cmd_send_messaging(argv[0], MESSAGING_INFO, "%s", buf);
+    free(buf);
+    return 0;
+}
+
+static void register_memtrack()
+{
+    memtrack_args.start = arg_lit0("s", "start", "Start tracking allocations");
+    memtrack_args.stop = arg_lit0("x", "stop", "Stop tracking and release tables");
+    memtrack_args.rate = arg_lit0("r", "rate", "Sort call sites by allocation rate instead of live size");
+    memtrack_args.top = arg_int0("n", "top", "<n>", "Number of call sites to list (default 10)");
+    memtrack_args.end = arg_end(4);
+    const esp_console_cmd_t cmd = {
+        .command = "memtrack",
+        .help = "Heap regions and allocations per call site (map addresses with addr2line)",
+        .hint = NULL,
+        .func = &memtrack,
+        .argtable = &memtrack_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
+/* 'topology' command shows where long-lived tasks run and switches profile */
+static int topology(int argc, char **argv)
+{
+    const size_t size = 2048;
+    int nerrors = arg_parse_msg(argc, argv, (struct arg_hdr **)&topology_args);
+    if (nerrors != 0) {
+        return 1;
+    }
+    if (topology_args.profile->count && !topology_set_profile(topology_args.profile->sval[0])) {
+        cmd_send_messaging(argv[0], MESSAGING_ERROR, "Unknown profile %s", topology_args.profile->sval[0]);
+        return 1;
+    }
+    char *buf = malloc_init_external(size);
+    if (buf == NULL) {
+        cmd_send_messaging(argv[0], MESSAGING_ERROR, "failed to allocate buffer for report");
+        return 1;
+    }
+    topology_report(buf, size);
+    cmd_send_messaging(argv[0], MESSAGING_INFO, "%s", buf);
+    free(buf);
+    return 0;
+}
+
+static void register_topology()
+{
+    topology_args.profile = arg_str0("p", "profile", "audio|legacy", "Switch task profile (priorities apply now, cores when tasks restart)");
+    topology_args.end = arg_end(2);
+    const esp_console_cmd_t cmd = {
+        .command = "topology",
+        .help = "Core, priority and CPU share of audio, network and display tasks",
+        .hint = NULL,
+        .func = &topology,
+        .argtable = &topology_args
+    };
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd) );
+}
+
 static void register_setdevicename()
 {
 	char * default_host_name = config_alloc_get_str("host_name",NULL,"Squeezelite");
@@ -25,6 +25,7 @@
 #include "mdns.h"
 #include "mbedtls/version.h"
 #include <mbedtls/x509.h>
+#include "topology.h"
 #endif
 
 #include "util.h"
@@ -97,7 +98,7 @@ static void		rtsp_thread(void *arg);
 static void 	search_remote(void *args);
 #endif
 static void		cleanup_rtsp(raop_ctx_t *ctx, bool abort);
-static bool 	handle_rtsp(raop_ctx_t *ctx, int sock);
+static bool 	handle_rtsp(raop_ctx_t *ctx, int sock, http_reader_t *reader);
 
 static char*	rsa_apply(unsigned char *input, int inlen, int *outlen, int mode);
 static int  	base64_pad(char *src, char **padded);
@@ -197,7 +198,8 @@ struct raop_ctx_s *raop_create(uint32_t host, char *name,
 	
     ctx->xTaskBuffer = (StaticTask_t*) heap_caps_malloc(sizeof(StaticTask_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
 	ctx->thread = xTaskCreateStaticPinnedToCore( (TaskFunction_t) rtsp_thread, "RTSP", RTSP_STACK_SIZE, ctx, 
-												 ESP_TASK_PRIO_MIN + 2, ctx->xStack, ctx->xTaskBuffer, CONFIG_PTHREAD_TASK_CORE_DEFAULT);
+												 topology_priority("RTSP", ESP_TASK_PRIO_MIN + 2), ctx->xStack, ctx->xTaskBuffer, 
+												 topology_core("RTSP", CONFIG_PTHREAD_TASK_CORE_DEFAULT));
 #endif
 
 	return ctx;
@@ -372,6 +374,7 @@ static void rtsp_thread(void *arg) {
 #endif	
 	raop_ctx_t *ctx = (raop_ctx_t*) arg;
 	int  sock = -1;
+	http_reader_t reader = { 0 };
 
 	while (ctx->running) {
 		fd_set rfds;
@@ -395,21 +398,24 @@ static void rtsp_thread(void *arg) {
 		FD_ZERO(&rfds);
 		FD_SET(sock, &rfds);
 
-		n = select(sock + 1, &rfds, NULL, NULL, &timeout);
+		// a request might already be sitting in reader's buffer
+		n = http_pending(&reader) ? 1 : select(sock + 1, &rfds, NULL, NULL, &timeout);
 		
 		if (!n && !ctx->abort) continue;
 
-		if (n > 0) res = handle_rtsp(ctx, sock);
+		if (n > 0) res = handle_rtsp(ctx, sock, &reader);
 
 		if (n < 0 || !res || ctx->abort) {
 			cleanup_rtsp(ctx, true);
 			closesocket(sock);
+			http_reader_free(&reader);
 			LOG_INFO("RTSP close %u", sock);
 			sock = -1;
 		}
 	}
 	
 	if (sock != -1) closesocket(sock);
+	http_reader_free(&reader);
 
 #ifndef WIN32
 	xTaskNotifyGive(ctx->joiner);
@@ -421,16 +427,15 @@ static void rtsp_thread(void *arg) {
 
 
 /*----------------------------------------------------------------------------*/
-static bool handle_rtsp(raop_ctx_t *ctx, int sock)
+static bool handle_rtsp(raop_ctx_t *ctx, int sock, http_reader_t *reader)
 {
 	char *buf = NULL, *body = NULL, method[16] = "";
 	key_data_t headers[16], resp[8] = { {NULL, NULL} };
 	int len;
 	bool success = true;
 	
-	if (!http_parse(sock, method, headers, &body, &len)) {
-		NFREE(body);
-		kd_free(headers);
+	// headers and body point into reader's buffer, they must not be freed
+	if (!http_read(sock, reader, method, sizeof(method), headers, sizeof(headers) / sizeof(key_data_t), &body, &len)) {
 		return false;
 	}
 	
@@ -524,8 +529,8 @@ static bool handle_rtsp(raop_ctx_t *ctx, int sock)
 		ctx->active_remote.destroy_mutex = xSemaphoreCreateBinary();
 		ctx->active_remote.xTaskBuffer = (StaticTask_t*) heap_caps_malloc(sizeof(StaticTask_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
 		ctx->active_remote.thread = xTaskCreateStaticPinnedToCore( (TaskFunction_t) search_remote, "search_remote", SEARCH_STACK_SIZE, ctx, 
-																	ESP_TASK_PRIO_MIN + 2, ctx->active_remote.xStack, ctx->active_remote.xTaskBuffer,
-																	CONFIG_PTHREAD_TASK_CORE_DEFAULT );
+																	topology_priority("search_remote", ESP_TASK_PRIO_MIN + 2), ctx->active_remote.xStack, 
+																	ctx->active_remote.xTaskBuffer, topology_core("search_remote", CONFIG_PTHREAD_TASK_CORE_DEFAULT) );
 #endif		
 
 	} else if (!strcmp(method, "SETUP") && ((buf = kd_lookup(headers, "Transport")) != NULL)) {
@@ -661,10 +666,8 @@ static bool handle_rtsp(raop_ctx_t *ctx, int sock)
 		LOG_INFO("[%p]: responding:\n%s", ctx, buf ? buf : "<void>");
 	}
 
-	NFREE(body);
 	NFREE(buf);
 	kd_free(resp);
-	kd_free(headers);
 
 	return true;
 }
@@ -53,9 +53,11 @@
 #else
 #include "esp_pthread.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include <mbedtls/version.h>
 #include <mbedtls/aes.h>
 #include "alac_wrapper.h"
+#include "topology.h"
 #endif
 
 #define NTP2MS(ntp) ((((ntp) >> 10) * 1000L) >> 22)
@@ -64,6 +66,14 @@
 #define TS2NTP(ts, rate)  (((((u64_t) (ts)) << 16) / (rate)) << 16)
 #define MS2TS(ms, rate) ((((u64_t) (ms)) * (rate)) / 1000)
 #define TS2MS(ts, rate) NTP2MS(TS2NTP(ts,rate))
+#define NTP2US(ntp) ((((ntp) >> 32) * 1000000LL) + ((((ntp) & 0xffffffff) * 1000000LL) >> 32))
+#define US2NTP(us) (((((u64_t) (us)) / 1000000) << 32) | (((((u64_t) (us)) % 1000000) << 32) + 999999) / 1000000)
+
+#ifdef WIN32
+#define gettime_us() ((u64_t) gettime_ms() * 1000)
+#else
+#define gettime_us() ((u64_t) esp_timer_get_time())
+#endif
 
 extern log_level 	raop_loglevel;
 static log_level 	*loglevel = &raop_loglevel;
@@ -83,6 +93,14 @@ static log_level 	*loglevel = &raop_loglevel;
 #define NTP_SYNC	(0x02)
 
 #define RESEND_TO	250
+#define RESEND_HOLES	16		// missing ranges tracked at once
+#define RESEND_MERGE	4		// received frames worth requesting again to join two holes
+#define RESEND_RTT_MIN	10
+
+#define CLOCK_WINDOW	32		// NTP exchanges kept (~90s)
+#define CLOCK_BEST		6		// lowest roundtrips used for estimation
+#define CLOCK_SPAN		20000000	// minimum time span (us) to estimate skew
+#define CLOCK_MAX_SKEW	500e-6
 
 enum { DATA = 0, CONTROL, TIMING };
 
@@ -91,7 +109,7 @@ uint32_t buffer_frames = ((150 * RAOP_SAMPLE_RATE * 2) / (352 * 100));
 
 typedef u16_t seq_t;
 typedef struct __attribute__((__packed__)) audio_buffer_entry {   // decoded audio packets
-	u32_t rtptime, last_resend;
+	u32_t rtptime;
 	s16_t *data;
     u16_t len;    
     u8_t ready;
@@ -120,13 +138,31 @@ typedef struct rtp_s {
 		unsigned short rport, lport;
 		int sock;
 	} rtp_sockets[3]; 					 // data, control, timing
-	struct timing_s {
-		u64_t local, remote;
-	} timing;
+	struct clock_s {
+		struct clock_sample_s {
+			u64_t local;		// local time (us) at middle of exchange
+			s64_t offset;		// remote - local (us)
+			u32_t rtt;			// roundtrip minus remote processing (us)
+		} samples[CLOCK_WINDOW];
+		int count;
+		u64_t ref;				// model is remote = local + offset + (local - ref) * skew
+		s64_t offset;
+		double skew;
+	} clock;
 	struct {
 		u32_t 	rtp, time;
 		u8_t  	status;
 	} synchro;
+	struct resend_s {
+		struct resend_hole_s {
+			seq_t first, last;
+			u32_t sent;			// last request (ms), valid once tries is set
+			u8_t tries;
+			bool timed;			// roundtrip already sampled
+		} holes[RESEND_HOLES];	// in sequence order
+		int count;
+		u32_t srtt, rttvar;		// control channel roundtrip (ms)
+	} resend;
 	int latency;			// rtp hold depth in samples
 	u32_t resent_req, resent_rec;	// total resent + recovered frames
 	u32_t silent_frames;	// total silence frames
@@ -157,7 +193,12 @@ static void 	buffer_release(abuf_t *audio_buffer);
 static void 	buffer_reset(abuf_t *audio_buffer);
 static void 	buffer_push_packet(rtp_t *ctx);
 static bool 	rtp_request_resend(rtp_t *ctx, seq_t first, seq_t last);
+static void 	resend_add(rtp_t *ctx, seq_t first, seq_t last);
+static void 	resend_fill(rtp_t *ctx, seq_t seqno, bool resent);
+static void 	resend_service(rtp_t *ctx);
 static bool 	rtp_request_timing(rtp_t *ctx);
+static void 	clock_add(struct clock_s *clock, u64_t t1, u64_t t2, u64_t t3, u64_t t4);
+static u64_t 	clock_to_local(struct clock_s *clock, u64_t remote);
 static int	  	seq_order(seq_t a, seq_t b);
 #ifdef WIN32
 static void 	*rtp_thread_func(void *arg);
@@ -230,6 +271,8 @@ rtp_resp_t rtp_init(struct in_addr host, int latency, char *aeskey, char *aesiv,
 	ctx->first_seqno = -1;
 	ctx->latency = latency;
 	ctx->ab_read = ctx->ab_write;
+	ctx->resend.srtt = RESEND_TO / 2;
+	ctx->resend.rttvar = RESEND_TO / 8;
 
 #ifdef __RTP_STORE
 	ctx->rtpIN = fopen("airplay.rtpin", "wb");
@@ -281,8 +324,8 @@ rtp_resp_t rtp_init(struct in_addr host, int latency, char *aeskey, char *aesiv,
 #else
 	ctx->xTaskBuffer = (StaticTask_t*) heap_caps_malloc(sizeof(StaticTask_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
 	ctx->thread = xTaskCreateStaticPinnedToCore( (TaskFunction_t) rtp_thread_func, "RTP_thread", RTP_STACK_SIZE, ctx,
-									 CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT + 1, ctx->xStack, ctx->xTaskBuffer,
-									 CONFIG_PTHREAD_TASK_CORE_DEFAULT );
+									 topology_priority("RTP_thread", CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT + 1), ctx->xStack, ctx->xTaskBuffer,
+									 topology_core("RTP_thread", CONFIG_PTHREAD_TASK_CORE_DEFAULT) );
 #endif
 	
 	// cleanup everything if we failed
@@ -433,7 +476,7 @@ static void alac_decode(rtp_t *ctx, s16_t *dest, char *buf, int len, u16_t *outs
 
 
 /*---------------------------------------------------------------------------*/
-static void buffer_put_packet(rtp_t *ctx, seq_t seqno, unsigned rtptime, bool first, char *data, int len) {
+static void buffer_put_packet(rtp_t *ctx, seq_t seqno, unsigned rtptime, bool first, bool resent, char *data, int len) {
 	abuf_t *abuf = NULL;
 
 	pthread_mutex_lock(&ctx->ab_mutex);
@@ -455,6 +498,7 @@ static void buffer_put_packet(rtp_t *ctx, seq_t seqno, unsigned rtptime, bool fi
 		ctx->ab_write = seqno - 1;
 		ctx->ab_read = ctx->ab_write + 1;
         ctx->resent_req = ctx->resent_rec = ctx->silent_frames = ctx->discarded = 0;        
+		ctx->resend.count = 0;
 		if (ctx->first_seqno != -1) {
         	LOG_INFO("[%p]: 1st accepted packet:%d, now playing", ctx, seqno);                                    
 			ctx->state = RTP_PLAY;
@@ -491,18 +535,15 @@ static void buffer_put_packet(rtp_t *ctx, seq_t seqno, unsigned rtptime, bool fi
 			// this is a shitstorm, reset buffer
             LOG_WARN("[%p] too many missing frames %hu seq: %hu, (W:%hu R:%hu)", ctx, seqno - ctx->ab_write - 1, seqno, ctx->ab_write, ctx->ab_read);
             ctx->ab_read = seqno;            
+			ctx->resend.count = 0;
 		} else {
-            // request re-send missed frames and evaluate resent date as a whole *after*
-            if (ctx->state == RTP_PLAY) rtp_request_resend(ctx, ctx->ab_write + 1, seqno-1);
-            
-            // resend date is after all requests have been sent
-            u32_t now = gettime_ms();
-            
-            // set expected timing of missed frames for buffer_push_packet and set last_resend date
+            // set expected timing of missed frames for buffer_push_packet and the resend scheduler
             for (seq_t i = ctx->ab_write + 1; seq_order(i, seqno); i++) {
                 ctx->audio_buffer[BUFIDX(i)].rtptime = rtptime - (seqno-i)*ctx->frame_size;
-                ctx->audio_buffer[BUFIDX(i)].last_resend = now;
             }
+
+            // requests are sent by resend_service once we have released the buffer
+            resend_add(ctx, ctx->ab_write + 1, seqno - 1);
             LOG_DEBUG("[%p]: packet newer seqno:%hu rtptime:%u (W:%hu R:%hu)", ctx, seqno, rtptime, ctx->ab_write, ctx->ab_read);            
         }        
 
@@ -510,6 +551,7 @@ static void buffer_put_packet(rtp_t *ctx, seq_t seqno, unsigned rtptime, bool fi
 	} else if (seq_order(ctx->ab_read, seqno + 1)) {
 		// recovered packet, not yet sent
 		ctx->resent_rec++;
+		resend_fill(ctx, seqno, resent);
 		LOG_DEBUG("[%p]: packet recovered seqno:%hu rtptime:%u (W:%hu R:%hu)", ctx, seqno, rtptime, ctx->ab_write, ctx->ab_read);
 	} else {
         // too late
@@ -537,6 +579,8 @@ static void buffer_put_packet(rtp_t *ctx, seq_t seqno, unsigned rtptime, bool fi
 	}
 
 	pthread_mutex_unlock(&ctx->ab_mutex);
+
+	resend_service(ctx);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -591,24 +635,109 @@ static void buffer_push_packet(rtp_t *ctx) {
 	}
 
 	LOG_SDEBUG("playtime %u %d [W:%hu R:%hu] %d", playtime, playtime - now, ctx->ab_write, ctx->ab_read, curframe->ready);
-   
-    // try to request resend missing packet in order, explore up to 32 frames
-    for (int step = max((ctx->ab_write - ctx->ab_read + 1) / 32, 1), 
-         i = 0, first = 0; 
-         seq_order(ctx->ab_read + i, ctx->ab_write); i += step) {
-             
-        abuf_t* frame = ctx->audio_buffer + BUFIDX(ctx->ab_read + i);
-
-        // stop when we reach a ready frame or a recent pending resend
-        if (first && (frame->ready || now - frame->last_resend <= RESEND_TO)) {
-            if (!rtp_request_resend(ctx, first, ctx->ab_read + i - 1)) break;
-            first = 0;
-            i += step - 1;
-        } else if (!frame->ready && now - frame->last_resend > RESEND_TO) {
-            if (!first) first = ctx->ab_read + i;
-            frame->last_resend = now;
-        }
-    }
+}
+
+/*---------------------------------------------------------------------------*/
+// track a new missing range, holes are always created after the last one
+static void resend_add(rtp_t *ctx, seq_t first, seq_t last) {
+	struct resend_s *resend = &ctx->resend;
+
+	// when table is full, grow the last hole and re-request what we already have in between
+	if (resend->count == RESEND_HOLES) {
+		resend->holes[resend->count - 1].last = last;
+		resend->holes[resend->count - 1].tries = 0;
+		resend->holes[resend->count - 1].timed = false;
+		return;
+	}
+
+	resend->holes[resend->count++] = (struct resend_hole_s) { first, last, 0, 0, false };
+}
+
+/*---------------------------------------------------------------------------*/
+// a missing frame has arrived, shrink or split its hole and measure roundtrip
+static void resend_fill(rtp_t *ctx, seq_t seqno, bool resent) {
+	struct resend_s *resend = &ctx->resend;
+	struct resend_hole_s *hole;
+	int i;
+
+	for (i = 0; i < resend->count && seq_order(resend->holes[i].last, seqno); i++);
+	if (i == resend->count || seq_order(seqno, resend->holes[i].first)) return;
+	hole = resend->holes + i;
+
+	// only first answer to a single request is a valid sample (late or retried ones are ambiguous)
+	if (resent && hole->tries == 1 && !hole->timed) {
+		u32_t rtt = gettime_ms() - hole->sent;
+		u32_t delta = rtt > resend->srtt ? rtt - resend->srtt : resend->srtt - rtt;
+		resend->rttvar = (3 * resend->rttvar + delta) / 4;
+		resend->srtt = (7 * resend->srtt + rtt) / 8;
+		// rest of that hole is on its way, don't sample it again
+		hole->timed = true;
+	}
+
+	if (hole->first == hole->last) {
+		memmove(hole, hole + 1, (--resend->count - i) * sizeof(*hole));
+	} else if (seqno == hole->first) {
+		hole->first++;
+	} else if (seqno == hole->last) {
+		hole->last--;
+	} else if (resend->count < RESEND_HOLES) {
+		memmove(hole + 1, hole, (resend->count++ - i) * sizeof(*hole));
+		hole[1].first = seqno + 1;
+		hole->last = seqno - 1;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+// (re)request holes that are due, joining close ones, and give up on frames only
+// when an answer could not arrive before they are replaced by silence
+static void resend_service(rtp_t *ctx) {
+	struct resend_s *resend = &ctx->resend;
+	struct { seq_t first, last; } requests[RESEND_HOLES];
+	int i, n = 0;
+	u32_t now = gettime_ms(), hold = max((ctx->latency * 1000) / (8 * RAOP_SAMPLE_RATE), 100);
+
+	pthread_mutex_lock(&ctx->ab_mutex);
+
+	if (ctx->state != RTP_PLAY || ctx->synchro.status != (RTP_SYNC | NTP_SYNC)) {
+		pthread_mutex_unlock(&ctx->ab_mutex);
+		return;
+	}
+
+	u32_t rto = min(max(resend->srtt + 4 * resend->rttvar, RESEND_RTT_MIN), RESEND_TO);
+
+	for (i = 0; i < resend->count; i++) {
+		struct resend_hole_s *hole = resend->holes + i;
+
+		// frames already played or created, ready ones at the edges and the ones we can't get in time
+		if (seq_order(hole->first, ctx->ab_read)) hole->first = ctx->ab_read;
+		while (seq_order(hole->first, hole->last + 1)) {
+			abuf_t *abuf = ctx->audio_buffer + BUFIDX(hole->first);
+			u32_t playtime = ctx->synchro.time + ((abuf->rtptime - ctx->synchro.rtp) * 10) / (RAOP_SAMPLE_RATE / 100);
+			if (!abuf->ready && (s32_t) (playtime - hold - now) >= (s32_t) resend->srtt) break;
+			hole->first++;
+		}
+		while (seq_order(hole->first, hole->last + 1) && ctx->audio_buffer[BUFIDX(hole->last)].ready) hole->last--;
+
+		if (!seq_order(hole->first, hole->last + 1)) {
+			memmove(hole, hole + 1, (--resend->count - i) * sizeof(*hole));
+			i--;
+			continue;
+		}
+
+		// answer might still be on its way
+		if (hole->tries && now - hole->sent < rto) continue;
+
+		// join with previous request if the gap is small enough
+		if (!n || (seq_t) (hole->first - requests[n-1].last - 1) > RESEND_MERGE) requests[n++].first = hole->first;
+		requests[n-1].last = hole->last;
+
+		hole->sent = now;
+		if (hole->tries < 255) hole->tries++;
+	}
+
+	pthread_mutex_unlock(&ctx->ab_mutex);
+
+	for (i = 0; i < n; i++) rtp_request_resend(ctx, requests[i].first, requests[i].last);
 }
 
 
@@ -644,6 +773,7 @@ static void rtp_thread_func(void *arg) {
 
 		if (select(sock + 1, &fds, NULL, NULL, &timeout) <= 0) {
             if (ctx->stalled++ == 30*10) ctx->cmd_cb(RAOP_STALLED);
+			resend_service(ctx);
             continue;
         }
 
@@ -697,7 +827,7 @@ static void rtp_thread_func(void *arg) {
 					LOG_INFO("[%p]: 1st audio packet received", ctx);
 				}
 
-				buffer_put_packet(ctx, seqno, rtptime, packet[1] & 0x80, pktp, plen);
+				buffer_put_packet(ctx, seqno, rtptime, packet[1] & 0x80, type == 0x56, pktp, plen);
 
 				break;
 			}
@@ -708,17 +838,22 @@ static void rtp_thread_func(void *arg) {
 				u64_t remote = (((u64_t) ntohl(*(u32_t*)(pktp+8))) << 32) + ntohl(*(u32_t*)(pktp+12));
 				u32_t rtp_now = ntohl(*(u32_t*)(pktp+16));
 				u16_t flags = ntohs(*(u16_t*)(pktp+2));
-				u32_t remote_gap = NTP2MS(remote - ctx->timing.remote);
 
-				// try to get NTP every 3 sec or every time if we are not synced
-				if (!count-- || !(ctx->synchro.status & NTP_SYNC)) {
+				// try to get NTP every 3 sec or every time if we don't have enough exchanges
+				if (!count-- || ctx->clock.count < CLOCK_BEST) {
 					rtp_request_timing(ctx);
 					count = 3;
 				}
 
+				if (!(ctx->synchro.status & NTP_SYNC)) break;
+
+				// local time of remote timestamp, through filtered clock
+				u64_t local = clock_to_local(&ctx->clock, NTP2US(remote));
+				s64_t gap = local - gettime_us();
+
 				// something is wrong, we should not have such gap
-				if (remote_gap > 10000) {
-					LOG_WARN("discarding remote timing information %u", remote_gap);
+				if (gap > 10000000LL || gap < -10000000LL) {
+					LOG_WARN("discarding remote timing information %lld", gap);
 					break;
 				}
 
@@ -730,7 +865,7 @@ static void rtp_thread_func(void *arg) {
 				if (ctx->latency < MIN_LATENCY) ctx->latency = MIN_LATENCY;
 				else if (ctx->latency > MAX_LATENCY) ctx->latency = MAX_LATENCY;
 				ctx->synchro.rtp = rtp_now - ctx->latency;
-				ctx->synchro.time = ctx->timing.local + remote_gap;
+				ctx->synchro.time = local / 1000;
 
 				// now we are synced on RTP frames
 				ctx->synchro.status |= RTP_SYNC;
@@ -752,33 +887,27 @@ static void rtp_thread_func(void *arg) {
 
 			// NTP timing packet
 			case 0x53: {
-				u32_t reference   = ntohl(*(u32_t*)(pktp+12)); // only low 32 bits in our case
-				u64_t remote 	  =(((u64_t) ntohl(*(u32_t*)(pktp+16))) << 32) + ntohl(*(u32_t*)(pktp+20));
-				u32_t roundtrip   = gettime_ms() - reference;
-				
+				u64_t received  = gettime_us();
+				u64_t reference = (((u64_t) ntohl(*(u32_t*)(pktp+8))) << 32) + ntohl(*(u32_t*)(pktp+12));
+				u64_t remote_rx = (((u64_t) ntohl(*(u32_t*)(pktp+16))) << 32) + ntohl(*(u32_t*)(pktp+20));
+				u64_t remote_tx = (((u64_t) ntohl(*(u32_t*)(pktp+24))) << 32) + ntohl(*(u32_t*)(pktp+28));
+				u32_t roundtrip = received - NTP2US(reference);
+
 				// better discard sync packets when roundtrip is suspicious
-				if (roundtrip > 100) {
+				if (roundtrip > 100000) {
 					// ask for another one only if we are not synced already
 					if (!(ctx->synchro.status & NTP_SYNC)) rtp_request_timing(ctx);
-					LOG_WARN("[%p]: discarding NTP roundtrip of %u ms", ctx, roundtrip);
+					LOG_WARN("[%p]: discarding NTP roundtrip of %u us", ctx, roundtrip);
 					break;
 				}
 
-				/*
-				  The expected elapsed remote time should be exactly the same as
-				  elapsed local time between the two request, corrected by the
-				  drifting
-				u64_t expected = ctx->timing.remote + MS2NTP(reference - ctx->timing.local);
-				*/
-
-				ctx->timing.remote = remote;
-				ctx->timing.local = reference;
+				clock_add(&ctx->clock, NTP2US(reference), NTP2US(remote_rx), NTP2US(remote_tx), received);
 
 				// now we are synced on NTP (mutex not needed)
 				ctx->synchro.status |= NTP_SYNC;
 
-				LOG_DEBUG("[%p]: Timing references local:%llu, remote:%llx (delta:%lld, sum:%lld, adjust:%lld, gaps:%d)",
-						  ctx, ctx->timing.local, ctx->timing.remote);
+				LOG_DEBUG("[%p]: Timing references local:%llu, offset:%lld us, skew:%d ppb, rtt:%u us (samples:%d)",
+						  ctx, ctx->clock.ref, ctx->clock.offset, (int) (ctx->clock.skew * 1e9), roundtrip, ctx->clock.count);
 
 				break;
 			}
@@ -804,19 +933,20 @@ static void rtp_thread_func(void *arg) {
 /*---------------------------------------------------------------------------*/
 static bool rtp_request_timing(rtp_t *ctx) {
 	unsigned char req[32];
-	u32_t now = gettime_ms();
+	u64_t now = US2NTP(gettime_us());
 	int i;
 	struct sockaddr_in host;
 
-	LOG_DEBUG("[%p]: timing request now:%u (port: %hu)", ctx, now, ctx->rtp_sockets[TIMING].rport);
+	LOG_DEBUG("[%p]: timing request now:%llx (port: %hu)", ctx, now, ctx->rtp_sockets[TIMING].rport);
 
 	req[0] = 0x80;
 	req[1] = 0x52|0x80;
 	*(u16_t*)(req+2) = htons(7);
 	*(u32_t*)(req+4) = htonl(0);  // dummy
 	for (i = 0; i < 16; i++) req[i+8] = 0;
-	*(u32_t*)(req+24) = 0;
-	*(u32_t*)(req+28) = htonl(now); // this is not a real NTP, but a 32 ms counter in the low part of the NTP
+	// this is not a real NTP, but local us clock is what answer's originate timestamp must give back
+	*(u32_t*)(req+24) = htonl(now >> 32);
+	*(u32_t*)(req+28) = htonl(now);
 
 	if (ctx->host.s_addr != INADDR_ANY) {
 		host.sin_family = AF_INET;
@@ -835,6 +965,68 @@ static bool rtp_request_timing(rtp_t *ctx) {
 	return true;
 }
 
+/*---------------------------------------------------------------------------*/
+// add an NTP exchange (all in us) and re-estimate offset and skew from the lowest roundtrips
+static void clock_add(struct clock_s *clock, u64_t t1, u64_t t2, u64_t t3, u64_t t4) {
+	struct clock_sample_s *sample, *best[CLOCK_BEST];
+	s64_t rtt = (s64_t) (t4 - t1) - (s64_t) (t3 - t2);
+	int i, j, n = 0;
+
+	// drop oldest sample when window is full
+	if (clock->count == CLOCK_WINDOW) memmove(clock->samples, clock->samples + 1, --clock->count * sizeof(struct clock_sample_s));
+	sample = clock->samples + clock->count++;
+
+	sample->rtt = rtt > 0 ? rtt : 0;
+	sample->local = t1 + (t4 - t1) / 2;
+	sample->offset = ((s64_t) (t2 - t1) + (s64_t) (t3 - t4)) / 2;
+
+	// keep the lowest roundtrips, they are the less affected by queuing asymmetry
+	for (i = 0; i < clock->count; i++) {
+		sample = clock->samples + i;
+		if (n == CLOCK_BEST && sample->rtt >= best[n - 1]->rtt) continue;
+		if (n < CLOCK_BEST) n++;
+		for (j = n - 1; j > 0 && best[j - 1]->rtt > sample->rtt; j--) best[j] = best[j - 1];
+		best[j] = sample;
+	}
+
+	// regression of offset against local time, relative to the most recent selected sample
+	u64_t ref = best[0]->local, first = best[0]->local;
+	double sx = 0, sy = 0, sxx = 0, sxy = 0;
+
+	for (i = 1; i < n; i++) {
+		if (best[i]->local > ref) ref = best[i]->local;
+		if (best[i]->local < first) first = best[i]->local;
+	}
+
+	for (i = 0; i < n; i++) {
+		double x = (s64_t) (best[i]->local - ref), y = best[i]->offset - best[0]->offset;
+		sx += x; sy += y; sxx += x * x; sxy += x * y;
+	}
+
+	double det = n * sxx - sx * sx, skew = clock->skew;
+
+	// only update skew when samples are spread enough, then smooth it 
+	if (n >= 3 && ref - first >= CLOCK_SPAN && det > 0) {
+		skew = (n * sxy - sx * sy) / det;
+		if (skew > CLOCK_MAX_SKEW) skew = CLOCK_MAX_SKEW;
+		else if (skew < -CLOCK_MAX_SKEW) skew = -CLOCK_MAX_SKEW;
+		skew = clock->skew + (skew - clock->skew) / 8;
+	}
+
+	// offset at ref is the mean of selected samples moved along skew
+	clock->offset = best[0]->offset + (s64_t) ((sy - skew * sx) / n);
+	clock->skew = skew;
+	clock->ref = ref;
+}
+
+/*---------------------------------------------------------------------------*/
+// local time (us) of a remote time (us)
+static u64_t clock_to_local(struct clock_s *clock, u64_t remote) {
+	// first guess ignores skew, which is enough to apply it then
+	u64_t local = remote - clock->offset;
+	return remote - clock->offset - (s64_t) ((s64_t) (local - clock->ref) * clock->skew);
+}
+
 /*---------------------------------------------------------------------------*/
 static bool rtp_request_resend(rtp_t *ctx, seq_t first, seq_t last) {
 	unsigned char req[8];    // *not* a standard RTCP NACK
@@ -36,7 +36,6 @@ extern log_level	util_loglevel;
 static log_level 		*loglevel = &util_loglevel;
 
 static char *ltrim(char *s);
-static int read_line(int fd, char *line, int maxlen, int timeout);
 
 /*----------------------------------------------------------------------------*/
 /* 																			  */
@@ -352,120 +351,169 @@ static char *ltrim(char *s)
 /*----------------------------------------------------------------------------*/
 
 /*----------------------------------------------------------------------------*/
-bool http_parse(int sock, char *method, key_data_t *rkd, char **body, int *len)
+int http_parse_request(char *buf, int len, char *method, int size, key_data_t *rkd, int max, char **body, int *blen)
 {
-	char line[256], *dp;
-	unsigned j;
-	int i, timeout = 100;
-
-	rkd[0].key = NULL;
-
-	if ((i = read_line(sock, line, sizeof(line), timeout)) <= 0) {
-		if (i < 0) {
-			LOG_ERROR("cannot read method", NULL);
+	char *p, *eol, *head_end = NULL;
+	int i, head_len, clen = 0;
+
+	// locate end of headers without touching buffer, request might be incomplete
+	for (p = buf; p < buf + len && (p = memchr(p, '\n', buf + len - p)) != NULL; p++) {
+		if (p + 1 < buf + len && p[1] == '\n') {
+			head_end = p + 2;
+			break;
+		}
+		if (p + 2 < buf + len && p[1] == '\r' && p[2] == '\n') {
+			head_end = p + 3;
+			break;
 		}
-		return false;
 	}
 
-	if (!sscanf(line, "%s", method)) {
-		LOG_ERROR("missing method", NULL);
-		return false;
+	if (!head_end) return len >= HTTP_MAX_HEADERS ? -1 : 0;
+	head_len = head_end - buf;
+
+	// Content-Length is needed before anything can be modified
+	for (p = buf; (p = memchr(p, '\n', head_end - p)) != NULL && p + 16 < head_end; ) {
+		if (!strncasecmp(++p, "Content-Length:", 15)) {
+			clen = atoi(p + 15);
+			break;
+		}
 	}
 
-	i = *len = 0;
+	if (clen < 0) return -1;
+	if (len - head_len < clen) return 0;
 
-	while (read_line(sock, line, sizeof(line), timeout) > 0) {
+	// now we have it all, NUL-terminate in place
+	head_end[-1] = '\0';
+	eol = strchr(buf, '\n');
+	if (eol) *eol = '\0';
+	else eol = head_end - 1;
+	if (eol > buf && eol[-1] == '\r') eol[-1] = '\0';
 
-		LOG_SDEBUG("sock: %u, received %s", line);
+	for (i = 0; i < size - 1 && buf[i] && buf[i] != ' '; i++) method[i] = buf[i];
+	method[i] = '\0';
+	if (!i) return -1;
 
-		// line folding should be deprecated
-		if (i && rkd[i].key && (line[0] == ' ' || line[0] == '\t')) {
-			for(j = 0; j < strlen(line); j++) if (line[j] != ' ' && line[j] != '\t') break;
-			rkd[i].data = realloc(rkd[i].data, strlen(rkd[i].data) + strlen(line + j) + 1);
-			strcat(rkd[i].data, line + j);
-			continue;
-		}
+	for (i = 0, p = eol + 1; p < head_end - 1 && *p != '\r' && *p != '\n'; p = eol + 1) {
+		char *dp;
 
-		dp = strstr(line,":");
+		if ((eol = strchr(p, '\n')) == NULL) eol = head_end - 1;
 
-		if (!dp){
-			LOG_ERROR("Request failed, bad header", NULL);
-			kd_free(rkd);
-			return false;
+		// line folding should be deprecated, blank previous EOL to join lines
+		while (eol < head_end - 1 && (eol[1] == ' ' || eol[1] == '\t')) {
+			*eol = ' ';
+			if (eol[-1] == '\r') eol[-1] = ' ';
+			if ((eol = strchr(eol, '\n')) == NULL) eol = head_end - 1;
 		}
 
-		*dp = 0;
-		rkd[i].key = strdup(line);
-		rkd[i].data = strdup(ltrim(dp + 1));
+		*eol = '\0';
+		if (eol > p && eol[-1] == '\r') eol[-1] = '\0';
 
-		if (!strcasecmp(rkd[i].key, "Content-Length")) *len = atol(rkd[i].data);
+		if ((dp = strchr(p, ':')) == NULL || i >= max - 1) {
+			LOG_ERROR("Request failed, bad or too many headers", NULL);
+			rkd[0].key = NULL;
+			return -1;
+		}
 
-		i++;
-		rkd[i].key = NULL;
+		*dp = '\0';
+		rkd[i].key = p;
+		rkd[i++].data = ltrim(dp + 1);
 	}
 
-	if (*len) {
-		int size = 0;
+	rkd[i].key = NULL;
 
-		*body = malloc(*len + 1);
-		while (*body && size < *len) {
-			int bytes = recv(sock, *body + size, *len - size, 0);
-			if (bytes <= 0) break;
-			size += bytes;
-		}
-
-		(*body)[*len] = '\0';
+	*body = clen ? head_end : NULL;
+	*blen = clen;
 
-		if (!*body || size != *len) {
-			LOG_ERROR("content length receive error %d %d", *len, size);
-		}
-	}
+	return head_len + clen;
+}
 
-	return true;
+/*----------------------------------------------------------------------------*/
+void http_reader_free(http_reader_t *reader)
+{
+	NFREE(reader->buf);
+	memset(reader, 0, sizeof(http_reader_t));
 }
 
+/*----------------------------------------------------------------------------*/
+bool http_pending(http_reader_t *reader)
+{
+	return reader->fill > reader->used;
+}
 
 /*----------------------------------------------------------------------------*/
-static int read_line(int fd, char *line, int maxlen, int timeout)
+bool http_read(int sock, http_reader_t *reader, char *method, int size, key_data_t *rkd, int max, char **body, int *len)
 {
-	int i,rval;
-	int count=0;
-	struct pollfd pfds;
-	char ch;
-
-	*line = 0;
-	pfds.fd = fd;
-	pfds.events = POLLIN;
-
-	for(i = 0; i < maxlen; i++){
-		if (poll(&pfds, 1, timeout)) rval=recv(fd, &ch, 1, 0);
-		else return 0;
-
-		if (rval == -1) {
-			if (errno == EAGAIN) return 0;
-			LOG_ERROR("fd: %d read error: %s", fd, strerror(errno));
-			return -1;
+	struct pollfd pfds = { .fd = sock, .events = POLLIN };
+	int n, idle = 0;
+
+	// release previous request and restore first byte of next one
+	if (reader->used) {
+		reader->buf[reader->used] = reader->saved;
+		reader->fill -= reader->used;
+		memmove(reader->buf, reader->buf + reader->used, reader->fill);
+		reader->used = 0;
+	}
+
+	// don't keep a large buffer (artwork) once it is not needed anymore
+	if (reader->size > HTTP_READER_SIZE && reader->fill < HTTP_READER_SIZE) {
+		char *buf = realloc(reader->buf, HTTP_READER_SIZE + 1);
+		if (buf) {
+			reader->buf = buf;
+			reader->size = HTTP_READER_SIZE;
 		}
+	}
 
-		if (rval == 0) {
-			LOG_INFO("disconnected on the other end %u", fd);
-			return 0;
+	rkd[0].key = NULL;
+	*body = NULL;
+	*len = 0;
+
+	while ((n = http_parse_request(reader->buf, reader->fill, method, size, rkd, max, body, len)) == 0) {
+		// grow buffer by chunks to fit body, with one byte for NUL-termination
+		if (reader->fill == reader->size) {
+			int size = reader->size ? reader->size * 2 : HTTP_READER_SIZE;
+			char *buf = size <= HTTP_MAX_BODY ? realloc(reader->buf, size + 1) : NULL;
+			if (!buf) {
+				LOG_ERROR("can't grow request buffer to %d", size);
+				return false;
+			}
+			reader->buf = buf;
+			reader->size = size;
 		}
 
-		if (ch == '\n') {
-			*line=0;
-			return count;
+		// nothing buffered means peer is quiet, otherwise give it some time to finish
+		if (poll(&pfds, 1, 100) <= 0) {
+			if (!reader->fill || ++idle > 10) return false;
+			continue;
 		}
 
-		if (ch=='\r') continue;
+		n = recv(sock, reader->buf + reader->fill, reader->size - reader->fill, 0);
 
-		*line++=ch;
-		count++;
-		if (count >= maxlen-1) break;
+		if (n < 0) {
+			if (errno == EAGAIN) continue;
+			LOG_ERROR("fd: %d read error: %s", sock, strerror(errno));
+			return false;
+		}
+
+		if (n == 0) {
+			LOG_INFO("disconnected on the other end %u", sock);
+			return false;
+		}
+
+		reader->fill += n;
+		idle = 0;
 	}
 
-	*line = 0;
-	return count;
+	if (n < 0) {
+		LOG_ERROR("malformed request", NULL);
+		return false;
+	}
+
+	// NUL-terminate body but save what was there as it might be next request
+	reader->used = n;
+	reader->saved = reader->buf[n];
+	reader->buf[n] = '\0';
+
+	return true;
 }
 
 
@@ -76,7 +76,24 @@ int 		conn_socket(unsigned short port);typedef struct {
 	char *data;
 } key_data_t;
 
-bool 		http_parse(int sock, char *method, key_data_t *rkd, char **body, int *len);char*		http_send(int sock, char *method, key_data_t *rkd);
+#define HTTP_READER_SIZE	4096
+#define HTTP_MAX_HEADERS	8192
+#define HTTP_MAX_BODY		(1024*1024)
+
+// buffered reader, request headers and body point into buf until next http_read
+typedef struct {
+	char *buf;
+	int size, fill;
+	int used;
+	char saved;
+} http_reader_t;
+
+int 		http_parse_request(char *buf, int len, char *method, int size, key_data_t *rkd, int max, char **body, int *blen);
+bool 		http_read(int sock, http_reader_t *reader, char *method, int size, key_data_t *rkd, int max, char **body, int *len);
+bool 		http_pending(http_reader_t *reader);
+void 		http_reader_free(http_reader_t *reader);
+
+char*		http_send(int sock, char *method, key_data_t *rkd);
 
 char*		kd_lookup(key_data_t *kd, char *key);
 bool 		kd_add(key_data_t *kd, char *key, char *value);
@@ -10,7 +10,6 @@
 #include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/timers.h"
 #include "freertos/queue.h"
 #include "esp_task.h"
 #include "esp_log.h"
@@ -21,6 +20,7 @@
 
 #define GPIO_EXP_INTR	0x100
 #define	GPIO_EXP_WRITE	0x200
+#define GPIO_EXP_INPUT	8		// maximum bytes read for inputs at once
 
 /* 
  shadow register is both output and input, so we assume that reading to the
@@ -43,8 +43,9 @@ typedef struct gpio_exp_s {
 	struct gpio_exp_isr_s {
 		gpio_isr_t handler;
 		void *arg;
-		TimerHandle_t timer;
+		TickType_t debounce, due;
 	} isr[32];
+	uint32_t debouncing;
 	struct gpio_exp_model_s const *model;
 } gpio_exp_t;
 
@@ -61,20 +62,20 @@ static void   IRAM_ATTR intr_isr_handler(void* arg);
 static gpio_exp_t* find_expander(gpio_exp_t *expander, int *gpio);
 
 static esp_err_t mpr121_init(gpio_exp_t* self);
-static uint32_t  mpr121_read(gpio_exp_t* self);
+static uint32_t  mpr121_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged);
 static void      mpr121_write(gpio_exp_t* self);
 
 static void 	pca9535_set_direction(gpio_exp_t* self);
-static uint32_t pca9535_read(gpio_exp_t* self);
+static uint32_t pca9535_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged);
 static void 	pca9535_write(gpio_exp_t* self);
 
-static uint32_t	pca85xx_read(gpio_exp_t* self);
+static uint32_t	pca85xx_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged);
 static void 	pca85xx_write(gpio_exp_t* self);
 
 static esp_err_t mcp23017_init(gpio_exp_t* self);
 static void      mcp23017_set_pull_mode(gpio_exp_t* self);
 static void      mcp23017_set_direction(gpio_exp_t* self);
-static uint32_t  mcp23017_read(gpio_exp_t* self);
+static uint32_t  mcp23017_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged);
 static void      mcp23017_write(gpio_exp_t* self);
 
 static esp_err_t mcp23s17_init(gpio_exp_t* self);
@@ -84,20 +85,29 @@ static uint32_t  mcp23s17_read(gpio_exp_t* self);
 static void      mcp23s17_write(gpio_exp_t* self);
 
 static void   service_handler(void *arg);
-static void   debounce_handler( TimerHandle_t xTimer );
+static esp_err_t expander_read(gpio_exp_t *self, uint32_t *value, uint32_t *flagged);
 
 static esp_err_t i2c_write(uint8_t port, uint8_t addr, uint8_t reg, uint32_t data, int len);
-static uint32_t  i2c_read(uint8_t port, uint8_t addr, uint8_t reg, int len);
+static esp_err_t i2c_read_inputs(gpio_exp_t **list, int count, uint8_t (*data)[GPIO_EXP_INPUT]);
 
 static spi_device_handle_t spi_config(struct gpio_exp_phy_s *phy);
 static esp_err_t           spi_write(spi_device_handle_t handle, uint8_t addr, uint8_t reg, uint32_t data, int len);
 static uint32_t            spi_read(spi_device_handle_t handle, uint8_t addr, uint8_t reg, int len);
 
+/* 
+ I2C chips describe their input registers (<reg> = 0xff for none) so that all 
+ expanders of a bus can be read in a single transaction, then <decode> returns 
+ the pins and the ones that flagged an interrupt. Others provide <read>
+*/
 static const struct gpio_exp_model_s {
 	char *model;
 	gpio_int_type_t trigger;
 	esp_err_t (*init)(gpio_exp_t* self);
 	uint32_t  (*read)(gpio_exp_t* self);
+	struct {
+		uint8_t reg, len;
+	} input;
+	uint32_t  (*decode)(gpio_exp_t* self, uint8_t *data, uint32_t *flagged);
 	void      (*write)(gpio_exp_t* self);
 	void      (*set_direction)(gpio_exp_t* self);
 	void      (*set_pull_mode)(gpio_exp_t* self);
@@ -105,23 +115,27 @@ static const struct gpio_exp_model_s {
 	{ .model = "mpr121",
 	  .trigger = GPIO_INTR_LOW_LEVEL,
 	  .init = mpr121_init,
-	  .read = mpr121_read,
+	  .input = { 0x00, 2 },
+	  .decode = mpr121_decode,
 	  .write = mpr121_write, },	
 	{ .model = "pca9535",
 	  .trigger = GPIO_INTR_LOW_LEVEL,
 	  .set_direction = pca9535_set_direction,
-	  .read = pca9535_read,
+	  .input = { 0x00, 2 },
+	  .decode = pca9535_decode,
 	  .write = pca9535_write, },
 	{ .model = "pca85xx",
 	  .trigger = GPIO_INTR_LOW_LEVEL,
-	  .read = pca85xx_read,
+	  .input = { 0xff, 2 },
+	  .decode = pca85xx_decode,
 	  .write = pca85xx_write, },
 	{ .model = "mcp23017",
 	  .trigger = GPIO_INTR_LOW_LEVEL,
 	  .init = mcp23017_init,
 	  .set_direction = mcp23017_set_direction,
 	  .set_pull_mode = mcp23017_set_pull_mode,
-	  .read = mcp23017_read,
+	  .input = { 0x0e, 6 },
+	  .decode = mcp23017_decode,
 	  .write = mcp23017_write, },
 	{ .model = "mcp23s17",
 	  .trigger = GPIO_INTR_LOW_LEVEL,
@@ -235,8 +249,7 @@ esp_err_t gpio_exp_isr_handler_add(int gpio, gpio_isr_t isr_handler, uint32_t de
 
 	expander->isr[gpio].handler = isr_handler;
 	expander->isr[gpio].arg = arg;
-	if (debounce) expander->isr[gpio].timer = xTimerCreate("gpioExpDebounce", pdMS_TO_TICKS(debounce), 
-	                                                       pdFALSE, expander->isr + gpio, debounce_handler );
+	expander->isr[gpio].debounce = pdMS_TO_TICKS(debounce);
 
 	return ESP_OK;
 }
@@ -248,7 +261,7 @@ esp_err_t gpio_exp_isr_handler_remove(int gpio, struct gpio_exp_s *expander) {
 	if (gpio < GPIO_NUM_MAX && !expander) return gpio_isr_handler_remove(gpio);
 	if ((expander = find_expander(expander, &gpio)) == NULL) return ESP_ERR_INVALID_ARG;
 
-	if (expander->isr[gpio].timer) xTimerDelete(expander->isr[gpio].timer, portMAX_DELAY);
+	expander->debouncing &= ~(1 << gpio);
 	memset(expander->isr + gpio, 0, sizeof(struct gpio_exp_isr_s));
 
 	return ESP_OK;
@@ -265,7 +278,7 @@ esp_err_t gpio_exp_set_direction(int gpio, gpio_mode_t mode, gpio_exp_t *expande
 
 	if (mode == GPIO_MODE_INPUT) {
 		expander->r_mask |= 1 << gpio;
-		expander->shadow = expander->model->read(expander);
+		expander_read(expander, &expander->shadow, NULL);
 		expander->age = ~xTaskGetTickCount();
 	} else {
 		expander->w_mask |= 1 << gpio;
@@ -299,12 +312,15 @@ int gpio_exp_get_level(int gpio, int age, gpio_exp_t *expander) {
 		return (expander->shadow >> gpio) & 0x01;
 	}
 
-	// re-read the expander if data is too old
-	if (age >= 0 && now - expander->age >= pdMS_TO_TICKS(age)) {
-		uint32_t value = expander->model->read(expander);
-		expander->pending |= (expander->shadow ^ value) & expander->r_mask;
-		expander->shadow = value;
-		expander->age = now;
+	// re-read the expander if data is too old, unless its interrupt keeps it up to date
+	if (age >= 0 && (expander->intr < 0 || expander->intr_pending) && now - expander->age >= pdMS_TO_TICKS(age)) {
+		uint32_t flagged, value;
+		// on failure, keep what we had and try again next time
+		if (expander_read(expander, &value, &flagged) == ESP_OK) {
+			expander->pending |= ((expander->shadow ^ value) | flagged) & expander->r_mask;
+			expander->shadow = value;
+			expander->age = now;
+		}
 	}
 
 	// clear pending bit
@@ -428,64 +444,170 @@ static void IRAM_ATTR intr_isr_handler(void* arg) {
 }
 
 /****************************************************************************************
- * INTR debounce handler
+ * Read all expanders with a pending interrupt, one transaction per I2C port
+ */
+static void service_interrupts(void) {
+	gpio_exp_t *list[sizeof(expanders)/sizeof(gpio_exp_t)];
+	uint8_t data[sizeof(expanders)/sizeof(gpio_exp_t)][GPIO_EXP_INPUT];
+	uint32_t done = 0, failed = 0;
+	int n = 0;
+
+	/* If we want a smarter bitmap of expanders with a pending interrupt
+	   we'll have to disable interrupts while clearing that bitmap. For 
+	   now, a loop will do */
+	for (int i = 0; i < n_expanders; i++) {
+		// no interrupt for that gpio or not pending (safe as interrupt is disabled)
+		if (expanders[i].intr < 0 || !expanders[i].intr_pending) continue;
+		xSemaphoreTake(expanders[i].mutex, pdMS_TO_TICKS(50));
+		list[n++] = expanders + i;
+	}
+
+	TickType_t now = xTaskGetTickCount();
+
+	for (int i = 0; i < n; i++) {
+		gpio_exp_t *expander = list[i];
+		uint32_t value, flagged = 0;
+
+		// read GPIOs and clear all pending status, along with others on the same bus
+		if (expander->model->read) {
+			value = expander->model->read(expander);
+		} else {
+			if (!(done & (1 << i))) {
+				gpio_exp_t *burst[sizeof(expanders)/sizeof(gpio_exp_t)];
+				uint8_t input[sizeof(expanders)/sizeof(gpio_exp_t)][GPIO_EXP_INPUT] = { };
+				uint32_t grouped = 0, bad = 0;
+				int count = 0;
+
+				for (int j = i; j < n; j++) {
+					if (list[j]->model->read || list[j]->phy.port != expander->phy.port) continue;
+					burst[count++] = list[j];
+					grouped |= 1 << j;
+				}
+
+				// a single NACK fails the whole burst, so then read devices one by one
+				if (i2c_read_inputs(burst, count, input) != ESP_OK) {
+					for (int k = 0; k < count; k++) {
+						if (count == 1 || i2c_read_inputs(burst + k, 1, input + k) != ESP_OK) bad |= 1 << k;
+					}
+				}
+				done |= grouped;
+
+				// results come in burst order, put them back where they belong
+				for (int j = i, k = 0; k < count; j++) {
+					if (!(grouped & (1 << j))) continue;
+					if (bad & (1 << k)) failed |= 1 << j;
+					memcpy(data[j], input[k++], GPIO_EXP_INPUT);
+				}
+			}
+
+			// keep shadow and interrupt pending so that a failed device is read again
+			if (failed & (1 << i)) continue;
+			value = expander->model->decode(expander, data[i], &flagged);
+		}
+
+		expander->age = now;
+		expander->intr_pending = false;
+
+		expander->pending |= ((expander->shadow ^ value) | flagged) & expander->r_mask;
+		expander->shadow = value;
+	}
+
+	// a device that can't be read keeps its level interrupt asserted, don't spin on it
+	if (failed) vTaskDelay(pdMS_TO_TICKS(10));
+
+	// re-enable interrupts now that they have all been cleared
+	for (int i = 0; i < n; i++) gpio_intr_enable(list[i]->intr);
+
+	for (int i = 0; i < n; i++) {
+		gpio_exp_t *expander = list[i];
+		uint32_t pending = expander->pending;
+
+		expander->pending = 0;
+		xSemaphoreGive(expander->mutex);
+		ESP_LOGD(TAG, "Handling GPIO %d reads 0x%04x and has 0x%04x pending", expander->first, expander->shadow, pending);
+
+		// debounced pins are handled once they have been quiet long enough
+		for (; pending; pending &= pending - 1) {
+			int gpio = __builtin_ctz(pending);
+			struct gpio_exp_isr_s *isr = expander->isr + gpio;
+
+			if (isr->debounce) {
+				isr->due = now + isr->debounce;
+				expander->debouncing |= 1 << gpio;
+			} else if (isr->handler) {
+				isr->handler(isr->arg);
+			}
+		}
+	}
+}
+
+/****************************************************************************************
+ * Call handlers of pins that are done debouncing, return time to wait for next ones
  */
-static void debounce_handler( TimerHandle_t xTimer ) {
-	struct gpio_exp_isr_s *isr = (struct gpio_exp_isr_s*) pvTimerGetTimerID (xTimer);
-	isr->handler(isr->arg);
+static TickType_t service_debounce(void) {
+	TickType_t now = xTaskGetTickCount(), wait = portMAX_DELAY;
+
+	for (int i = 0; i < n_expanders; i++) {
+		gpio_exp_t *expander = expanders + i;
+
+		for (uint32_t pins = expander->debouncing; pins; pins &= pins - 1) {
+			int gpio = __builtin_ctz(pins);
+			struct gpio_exp_isr_s *isr = expander->isr + gpio;
+			TickType_t left = isr->due - now;
+
+			if ((int32_t) left <= 0) {
+				expander->debouncing &= ~(1 << gpio);
+				if (isr->handler) isr->handler(isr->arg);
+			} else if (left < wait) {
+				wait = left;
+			}
+		}
+	}
+
+	return wait;
 }
 
 /****************************************************************************************
  * Service task
  */
 void service_handler(void *arg) {
+	TickType_t wait = portMAX_DELAY;
+
 	while (1) {
 		queue_request_t request;
-		uint32_t notif = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		uint32_t notif = ulTaskNotifyTake(pdTRUE, wait);
 
 		// we have been notified of an interrupt
-		if (notif == GPIO_EXP_INTR) {
-			/* If we want a smarter bitmap of expanders with a pending interrupt
-			   we'll have to disable interrupts while clearing that bitmap. For 
-			   now, a loop will do */
-			for (int i = 0; i < n_expanders; i++) {
-				gpio_exp_t *expander = expanders + i;
-
-				// no interrupt for that gpio or not pending (safe as interrupt is disabled)
-				if (expander->intr < 0 || !expander->intr_pending) continue;
-
-				xSemaphoreTake(expander->mutex, pdMS_TO_TICKS(50));
-
-				// read GPIOs and clear all pending status
-				uint32_t value = expander->model->read(expander);
-				expander->age = xTaskGetTickCount();
-				
-				// re-enable interrupt now that it has been cleared
-				expander->intr_pending = false;
-				gpio_intr_enable(expander->intr);				
-				
-				uint32_t pending = expander->pending | ((expander->shadow ^ value) & expander->r_mask);
-				expander->shadow = value;
-				expander->pending = 0;
-
-				xSemaphoreGive(expander->mutex);
-				ESP_LOGD(TAG, "Handling GPIO %d reads 0x%04x and has 0x%04x pending", expander->first, expander->shadow, pending);
-				
-				for (int gpio = 31, clz = 0; pending && clz < 31; pending <<= (clz + 1)) {
-					clz = __builtin_clz(pending);
-					gpio -= clz;
-					if (expander->isr[gpio].timer) xTimerReset(expander->isr[gpio].timer, 1);	// todo 0
-					else if (expander->isr[gpio].handler) expander->isr[gpio].handler(expander->isr[gpio].arg);
-				}	
-			}
-		}
+		if (notif == GPIO_EXP_INTR) service_interrupts();
 
 		// check if we have some other pending requests
 		while (xQueueReceive(message_queue, &request, 0) == pdTRUE) {
 			esp_err_t err = gpio_exp_set_level(request.gpio, request.level, true, request.expander);
 			if (err != ESP_OK) ESP_LOGW(TAG, "Can't execute async GPIO %d write request (%d)", request.gpio, err);  
 		}
+
+		wait = service_debounce();
+	}
+}
+
+/****************************************************************************************
+ * Read one expander, using its input registers when on I2C
+ */
+static esp_err_t expander_read(gpio_exp_t *self, uint32_t *value, uint32_t *flagged) {
+	uint8_t data[1][GPIO_EXP_INPUT] = { };
+	uint32_t dummy;
+
+	if (!flagged) flagged = &dummy;
+	*flagged = 0;
+
+	if (self->model->read) {
+		*value = self->model->read(self);
+		return ESP_OK;
 	}
+
+	esp_err_t err = i2c_read_inputs(&self, 1, data);
+	if (err == ESP_OK) *value = self->model->decode(self, data[0], flagged);
+	return err;
 }
 
 /****************************************************************************************
@@ -548,9 +670,9 @@ static esp_err_t mpr121_init(gpio_exp_t* self) {
 	return err;
 }
 
-static uint32_t mpr121_read(gpio_exp_t* self) {
+static uint32_t mpr121_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged) {
 	// only return the lower 12 bits of the pin status registers
-	return i2c_read(self->phy.port, self->phy.addr, 0x00, 2) & 0x0fff;
+	return (data[0] | (data[1] << 8)) & 0x0fff;
 }
 
 static void mpr121_write(gpio_exp_t* self) {
@@ -564,8 +686,8 @@ static void pca9535_set_direction(gpio_exp_t* self) {
 	i2c_write(self->phy.port, self->phy.addr, 0x06, self->r_mask, 2);
 }
 
-static uint32_t pca9535_read(gpio_exp_t* self) {
-	return i2c_read(self->phy.port, self->phy.addr, 0x00, 2);
+static uint32_t pca9535_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged) {
+	return data[0] | (data[1] << 8);
 }
 
 static void pca9535_write(gpio_exp_t* self) {
@@ -575,10 +697,10 @@ static void pca9535_write(gpio_exp_t* self) {
 /****************************************************************************************
  * PCA85xx family : read and write
  */
-static uint32_t pca85xx_read(gpio_exp_t* self) {
+static uint32_t pca85xx_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged) {
 	// must return the full set of pins, not just inputs
-	uint32_t data = i2c_read(self->phy.port, self->phy.addr, 0xff, 2);
-	return (data & self->r_mask) | (self->shadow & ~self->r_mask);
+	uint32_t value = data[0] | (data[1] << 8);
+	return (value & self->r_mask) | (self->shadow & ~self->r_mask);
 }
 
 static void pca85xx_write(gpio_exp_t* self) {
@@ -600,11 +722,12 @@ static void pca85xx_write(gpio_exp_t* self) {
  */
 static esp_err_t mcp23017_init(gpio_exp_t* self) {
 	/*
-	0111 x10x = same bank, mirrot single int, no sequentµial, open drain, active low
+	0101 x10x = same bank, mirrot single int, sequential, open drain, active low
 	not sure about this funny change of mapping of the control register itself, really?
+	(sequential is needed to read INTF, INTCAP and GPIO in one go)
 	*/
-	esp_err_t err = i2c_write(self->phy.port, self->phy.addr, 0x05, 0x74, 1);
-	err |= i2c_write(self->phy.port, self->phy.addr, 0x0a, 0x74, 1);
+	esp_err_t err = i2c_write(self->phy.port, self->phy.addr, 0x05, 0x54, 1);
+	err |= i2c_write(self->phy.port, self->phy.addr, 0x0a, 0x54, 1);
 
 	// no interrupt on comparison or on change
 	err |= i2c_write(self->phy.port, self->phy.addr, 0x04, 0x00, 2);
@@ -623,9 +746,11 @@ static void mcp23017_set_pull_mode(gpio_exp_t* self) {
 	i2c_write(self->phy.port, self->phy.addr, 0x0c, self->pullup, 2);
 }
 
-static uint32_t mcp23017_read(gpio_exp_t* self) {
-	// read the pins value, not the stored one @interrupt
-	return i2c_read(self->phy.port, self->phy.addr, 0x12, 2);
+static uint32_t mcp23017_decode(gpio_exp_t* self, uint8_t *data, uint32_t *flagged) {
+	// INTF tells which pins fired, even if they bounced back since. Then we want 
+	// the pins value (GPIO), not the stored one @interrupt (INTCAP)
+	*flagged = data[0] | (data[1] << 8);
+	return data[4] | (data[5] << 8);
 }
 
 static void mcp23017_write(gpio_exp_t* self) {
@@ -701,38 +826,38 @@ static esp_err_t i2c_write(uint8_t port, uint8_t addr, uint8_t reg, uint32_t dat
 }
 
 /****************************************************************************************
- * I2C read up to 32 bits
+ * I2C read of the input registers of a list of expanders on the same port, at once
  */
-static uint32_t i2c_read(uint8_t port, uint8_t addr, uint8_t reg, int len) {
-	uint32_t data = 0;
-	
+static esp_err_t i2c_read_inputs(gpio_exp_t **list, int count, uint8_t (*data)[GPIO_EXP_INPUT]) {
 	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
 
-    i2c_master_start(cmd);
+	// one repeated start per device and a single stop, so the bus is acquired only once
+	for (int i = 0; i < count; i++) {
+		uint8_t addr = list[i]->phy.addr, reg = list[i]->model->input.reg;
+		int len = list[i]->model->input.len;
 
-	// when using a register, write it's value then the device address again
-	if (reg != 0xff) {
-		i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, I2C_MASTER_NACK);
-		i2c_master_write_byte(cmd, reg, I2C_MASTER_NACK);
 		i2c_master_start(cmd);
+
+		// when using a register, write it's value then the device address again
+		if (reg != 0xff) {
+			i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, I2C_MASTER_NACK);
+			i2c_master_write_byte(cmd, reg, I2C_MASTER_NACK);
+			i2c_master_start(cmd);
+		}
+
 		i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_READ, I2C_MASTER_NACK);
-	} else {
-		i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_READ, I2C_MASTER_NACK);
+		i2c_master_read(cmd, data[i], len, I2C_MASTER_LAST_NACK);
 	}
-	
-	// works with our endianness
-	if (len > 1) i2c_master_read(cmd, (uint8_t*) &data, len, I2C_MASTER_LAST_NACK);
-	else i2c_master_read_byte(cmd, (uint8_t*) &data, I2C_MASTER_NACK);
-		
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(port, cmd, 100 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
-	
+
+	i2c_master_stop(cmd);
+	esp_err_t ret = i2c_master_cmd_begin(list[0]->phy.port, cmd, (100 + count * 10) / portTICK_RATE_MS);
+	i2c_cmd_link_delete(cmd);
+
 	if (ret != ESP_OK) {
-		ESP_LOGW(TAG, "I2C read failed");
+		ESP_LOGW(TAG, "I2C read of %d expander(s) failed", count);
 	}
 
-	return data;
+	return ret;
 }
 
 /***************************************************************************************
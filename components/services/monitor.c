@@ -25,6 +25,7 @@
 #include "messaging.h"
 #include "cJSON.h"
 #include "tools.h"
+#include "trace.h"
 
 #define PSEUDO_IDLE_STACK_SIZE	(6*1024)
 
@@ -133,14 +134,29 @@ static void monitor_trace(uint32_t now) {
 	cJSON_AddNumberToObject(top,"min_free_iram",heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
 	cJSON_AddNumberToObject(top,"free_spiram",heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
 	cJSON_AddNumberToObject(top,"min_free_spiram",heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+	cJSON_AddNumberToObject(top,"largest_iram",heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+	cJSON_AddNumberToObject(top,"largest_spiram",heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
 
-	ESP_LOGI(TAG, "Heap internal:%zu (min:%zu) external:%zu (min:%zu) dma:%zu (min:%zu)",
+	ESP_LOGI(TAG, "Heap internal:%zu (min:%zu, largest:%zu) external:%zu (min:%zu, largest:%zu) dma:%zu (min:%zu, largest:%zu)",
 			heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
 			heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+			heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL),
 			heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
 			heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM),
+			heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM),
 			heap_caps_get_free_size(MALLOC_CAP_DMA),
-			heap_caps_get_minimum_free_size(MALLOC_CAP_DMA));
+			heap_caps_get_minimum_free_size(MALLOC_CAP_DMA),
+			heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
+
+	// when allocations are tracked, show who is churning the heap the most
+	if (memtrack_active()) {
+		char *report = malloc_init_external(1024);
+		if (report) {
+			memtrack_report(report, 1024, 3, true);
+			ESP_LOGI(TAG, "%s", report);
+			free(report);
+		}	
+	}
 
 	task_stats(top);
 
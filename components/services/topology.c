@@ -0,0 +1,205 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_task.h"
+#include "platform_config.h"
+#include "topology.h"
+
+/*
+ Wi-Fi, lwIP and BT controller run on core 0, so the "audio" profile keeps what
+ produces samples on time (output, decoders and RTP) alone on core 1 and moves
+ network, http and display work to core 0. The "legacy" profile is the placement
+ that used to be hard-coded at each creation site. Priorities can be changed on
+ the fly but core affinity only applies to tasks created after a switch
+*/
+
+#define ANY		tskNO_AFFINITY
+#define PRIO	CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT
+#define MIN		ESP_TASK_PRIO_MIN
+#define CORE	CONFIG_PTHREAD_TASK_CORE_DEFAULT
+
+static const task_topology_t audio[] = {
+	{ "output_i2s", 		1, 		PRIO + 10, 	false },
+	{ "decode", 			1, 		PRIO + 2, 	false },
+	{ "RTP_thread", 		1, 		PRIO + 3, 	false },
+	{ "cspot_player", 		1, 		PRIO + 5, 	true },
+	{ "stream", 			0, 		PRIO + 1, 	false },
+	{ "squeezelite", 		0, 		PRIO, 		false },
+	{ "RTSP", 				0, 		MIN + 2, 	false },
+	{ "search_remote", 		0, 		MIN + 1, 	false },
+	{ "playerInstance", 	0, 		PRIO, 		true },
+	{ "CSpotTrackQueue", 	0, 		PRIO + 2, 	true },
+	{ "mercury_dispatcher", 0, 		PRIO + 3, 	true },
+	{ "sb_displayer", 		0, 		MIN + 1, 	false },
+	{ "common_displayer", 	0, 		MIN + 1, 	false },
+	{ "dac_ctrl", 			0, 		PRIO + 10, 	false },
+	{ "multiroom", 			0, 		PRIO + 2, 	false },
+	{ NULL }
+};
+
+static const task_topology_t legacy[] = {
+	{ "output_i2s", 		0, 		PRIO + 10, 	false },
+	{ "decode", 			CORE, 	PRIO, 		false },
+	{ "RTP_thread", 		CORE, 	PRIO + 1, 	false },
+	{ "cspot_player", 		1, 		PRIO + 5, 	true },
+	{ "stream", 			CORE, 	PRIO, 		false },
+	{ "squeezelite", 		CORE, 	PRIO, 		false },
+	{ "RTSP", 				CORE, 	MIN + 2, 	false },
+	{ "search_remote", 		CORE, 	MIN + 2, 	false },
+	{ "playerInstance", 	0, 		PRIO, 		true },
+	{ "CSpotTrackQueue", 	1, 		PRIO + 2, 	true },
+	{ "mercury_dispatcher", 1, 		PRIO + 3, 	true },
+	{ "sb_displayer", 		ANY, 	MIN + 1, 	false },
+	{ "common_displayer", 	ANY, 	MIN + 1, 	false },
+	{ "dac_ctrl", 			ANY, 	PRIO + 10, 	false },
+	{ "multiroom", 			CORE, 	PRIO + 1, 	false },
+	{ NULL }
+};
+
+static const struct {
+	const char *name;
+	const task_topology_t *tasks;
+} profiles[] = { { "audio", audio }, { "legacy", legacy } };
+
+static const char *TAG = "topology";
+static int active = -1;
+
+/****************************************************************************************
+ *
+ */
+static void topology_load(void) {
+	char *p = config_alloc_get_default(NVS_TYPE_STR, "task_profile", (void*) profiles[0].name, 0);
+	int i;
+
+	for (i = sizeof(profiles) / sizeof(*profiles) - 1; i > 0 && (!p || strcasecmp(p, profiles[i].name)); i--);
+	active = i;
+
+	ESP_LOGI(TAG, "using task profile %s", profiles[active].name);
+	free(p);
+}
+
+/****************************************************************************************
+ *
+ */
+const task_topology_t* topology_get(const char *name) {
+	if (active < 0) topology_load();
+
+	for (const task_topology_t *task = profiles[active].tasks; name && task->name; task++) {
+		if (!strcmp(task->name, name)) return task;
+	}
+
+	return NULL;
+}
+
+/****************************************************************************************
+ *
+ */
+int topology_core(const char *name, int core) {
+	const task_topology_t *task = topology_get(name);
+	return task ? task->core : core;
+}
+
+/****************************************************************************************
+ *
+ */
+int topology_priority(const char *name, int priority) {
+	const task_topology_t *task = topology_get(name);
+	return task ? task->priority : priority;
+}
+
+/****************************************************************************************
+ *
+ */
+const char* topology_profile(void) {
+	if (active < 0) topology_load();
+	return profiles[active].name;
+}
+
+/****************************************************************************************
+ *
+ */
+bool topology_set_profile(const char *profile) {
+	int i;
+
+	for (i = sizeof(profiles) / sizeof(*profiles) - 1; i >= 0 && strcasecmp(profile, profiles[i].name); i--);
+	if (i < 0) return false;
+
+	active = i;
+	config_set_value(NVS_TYPE_STR, "task_profile", profiles[active].name);
+
+	// running tasks get their new priority now, affinity will follow when they are re-created
+	for (const task_topology_t *task = profiles[active].tasks; task->name; task++) {
+		// FreeRTOS truncates names and asserts when asked for a name longer than what it stores
+		char name[configMAX_TASK_NAME_LEN];
+		strlcpy(name, task->name, sizeof(name));
+		TaskHandle_t handle = xTaskGetHandle(name);
+		if (handle) vTaskPrioritySet(handle, task->priority);
+	}
+
+	ESP_LOGI(TAG, "switched to task profile %s", profiles[active].name);
+	return true;
+}
+
+/****************************************************************************************
+ *
+ */
+size_t topology_report(char *buf, size_t size) {
+	if (active < 0) topology_load();
+
+	const task_topology_t *tasks = profiles[active].tasks;
+	size_t n = snprintf(buf, size, "profile: %s\n%-20s core prio   cpu\n", profiles[active].name, "task");
+
+#ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+	// CPU share is measured between two reports, per core (so it can reach 100% on each) and 
+	// both profiles list tasks in the same order so counters survive a switch
+	static uint32_t previous[sizeof(audio) / sizeof(*audio)], last_total;
+	UBaseType_t count = uxTaskGetNumberOfTasks();
+	TaskStatus_t *status = malloc(count * sizeof(TaskStatus_t));
+	uint32_t total = 0;
+
+	if (status) count = uxTaskGetSystemState(status, count, &total);
+	else count = 0;
+#endif
+
+	for (int i = 0; tasks[i].name && n < size; i++) {
+		char core[8] = "any";
+		if (tasks[i].core != ANY) snprintf(core, sizeof(core), "%d", tasks[i].core);
+		n += snprintf(buf + n, size - n, "%-20s %4s %4d", tasks[i].name, core, tasks[i].priority);
+
+#ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+		UBaseType_t j;
+		for (j = 0; j < count && strncmp(status[j].pcTaskName, tasks[i].name, configMAX_TASK_NAME_LEN - 1); j++);
+
+		if (j < count && n < size) {
+			uint32_t elapsed = total - last_total;
+			if (elapsed && last_total) n += snprintf(buf + n, size - n, " %4u%%", (unsigned) (100ULL * (status[j].ulRunTimeCounter - previous[i]) / elapsed));
+			else n += snprintf(buf + n, size - n, "     -");
+			previous[i] = status[j].ulRunTimeCounter;
+		} else if (n < size) {
+			n += snprintf(buf + n, size - n, "   n/a");
+		}
+#endif
+
+		if (n < size) n += snprintf(buf + n, size - n, "\n");
+	}
+
+#ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+	last_total = total;
+	free(status);
+#endif
+
+	return n < size ? n : size - 1;
+}
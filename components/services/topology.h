@@ -0,0 +1,38 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Placement of long-lived tasks, looked up by task name when they are created.
+ * Core can be tskNO_AFFINITY, priority is absolute and psram is only honored
+ * by creators that allocate the stack themselves */
+typedef struct {
+	const char *name;
+	int core, priority;
+	bool psram;
+} task_topology_t;
+
+const task_topology_t* 	topology_get(const char *name);
+int 					topology_core(const char *name, int core);
+int 					topology_priority(const char *name, int priority);
+const char* 			topology_profile(void);
+bool 					topology_set_profile(const char *profile);
+size_t 					topology_report(char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,6 +32,7 @@
 #include "platform_config.h"
 #include "nvs_utilities.h"
 #include "tools.h"
+#include "topology.h"
 
 static class cspotPlayer *player;
 
@@ -244,6 +245,8 @@ void cspotPlayer::eventHandler(std::unique_ptr<cspot::SpircHandler::Event> event
     }
     case cspot::SpircHandler::EventType::DEPLETED:
         trackStatus = TRACK_END;
+        // last byte has been sent to sink, mark where audio will end
+        cmdHandler(CSPOT_END_MARK);
         CSPOT_LOG(info, "playlist ended, no track left to play");
         break;
     case cspot::SpircHandler::EventType::VOLUME:
@@ -406,19 +409,20 @@ void cspotPlayer::runTask() {
             // exit when player has stopped (received a DISC)
             while (state == LINKED) {
                 ctx->session->handlePacket();
+                spirc->flushNotify();
 
-                // low-accuracy polling events
+                // events are timestamped by sink when they reach the DAC, so polling only delays notification
                 if (trackStatus == TRACK_NOTIFY) {
-                    // inform Spotify that next track has started (don't need to be super accurate)
-                    uint32_t started;
-                    cmdHandler(CSPOT_QUERY_STARTED, &started);
+                    // inform Spotify that next track has started and where we are now
+                    uint32_t started, elapsed;
+                    cmdHandler(CSPOT_QUERY_STARTED, &started, &elapsed);
                     if (started) {
-                        CSPOT_LOG(info, "next track's audio has reached DAC (offset %d)", startOffset);
+                        CSPOT_LOG(info, "next track's audio has reached DAC %d ms ago (offset %d)", elapsed, startOffset);
                         if (notify) spirc->notifyAudioReachedPlayback();
                         else notify = true;
-                        cmdHandler(CSPOT_TRACK_INFO, trackInfo.duration, startOffset, trackInfo.artist.c_str(),
+                        cmdHandler(CSPOT_TRACK_INFO, trackInfo.duration, startOffset + elapsed, trackInfo.artist.c_str(),
                                     trackInfo.album.c_str(), trackInfo.name.c_str(), trackInfo.imageUrl.c_str());
-                        spirc->updatePositionMs(startOffset);
+                        spirc->updatePositionMs(startOffset + elapsed);
                         startOffset = 0;
                         trackStatus = TRACK_STREAM;
                     }
@@ -468,6 +472,13 @@ void cspotPlayer::runTask() {
 struct cspot_s* cspot_create(const char *name, httpd_handle_t server, int port, cspot_cmd_cb_t cmd_cb, cspot_data_cb_t data_cb) {
 	bell::setDefaultLogger();
     bell::enableTimestampLogging(true);
+    bell::Task::placement = [](const char* name, int* priority, int* core, bool* psram) {
+        const task_topology_t *task = topology_get(name);
+        if (!task) return;
+        *priority = task->priority;
+        *core = task->core;
+        *psram = task->psram;
+    };
     player = new cspotPlayer(name, server, port, cmd_cb, data_cb);
     player->startTask();
 	return (cspot_s*) player;
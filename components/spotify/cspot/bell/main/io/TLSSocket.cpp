@@ -4,12 +4,121 @@
 #include <mbedtls/entropy.h>      // for mbedtls_entropy_free, mbedtls_entro...
 #include <mbedtls/net_sockets.h>  // for mbedtls_net_connect, mbedtls_net_free
 #include <mbedtls/ssl.h>          // for mbedtls_ssl_conf_authmode, mbedtls_...
+#include <mbedtls/version.h>      // for MBEDTLS_VERSION_NUMBER
+#include <chrono>                 // for steady_clock, minutes
 #include <cstring>                // for strlen, NULL
+#include <list>                   // for list
+#include <mutex>                  // for mutex, scoped_lock
 #include <stdexcept>              // for runtime_error
 
 #include "BellLogger.h"  // for AbstractLogger, BELL_LOG
 #include "X509Bundle.h"  // for shouldVerify, attach
 
+namespace {
+/**
+ * Sessions of the most recently used hosts, shared by all TLSSockets so that
+ * reconnecting to the same server is an abbreviated handshake (ticket or
+ * session-id) instead of a full one with certificate verification.
+ */
+class TLSSessionCache {
+ public:
+  static constexpr size_t maxEntries = 6;
+  static constexpr size_t maxBytes = 12 * 1024;
+  static constexpr std::chrono::minutes maxAge{60};
+
+  ~TLSSessionCache() {
+    for (auto& entry : entries) {
+      mbedtls_ssl_session_free(&entry.session);
+    }
+  }
+
+  // Offers the cached session of this host to the upcoming handshake
+  bool restore(const std::string& key, mbedtls_ssl_context* ssl) {
+    std::scoped_lock lock(mutex);
+    for (auto it = entries.begin(); it != entries.end(); it++) {
+      if (it->key != key) {
+        continue;
+      }
+      if (std::chrono::steady_clock::now() - it->stored > maxAge) {
+        erase(it);
+        return false;
+      }
+      entries.splice(entries.begin(), entries, it);
+      return mbedtls_ssl_set_session(ssl, &it->session) == 0;
+    }
+    return false;
+  }
+
+  // Keeps the session of an established connection, evicting the oldest ones
+  void save(const std::string& key, mbedtls_ssl_context* ssl) {
+    std::scoped_lock lock(mutex);
+    forgetLocked(key);
+
+    entries.emplace_front();
+    auto& entry = entries.front();
+    entry.key = key;
+    entry.stored = std::chrono::steady_clock::now();
+    mbedtls_ssl_session_init(&entry.session);
+    if (mbedtls_ssl_get_session(ssl, &entry.session) != 0) {
+      erase(entries.begin());
+      return;
+    }
+    entry.size = sizeOf(&entry.session);
+    bytes += entry.size;
+
+    while (entries.size() > maxEntries ||
+           (bytes > maxBytes && entries.size() > 1)) {
+      erase(std::prev(entries.end()));
+    }
+  }
+
+  void forget(const std::string& key) {
+    std::scoped_lock lock(mutex);
+    forgetLocked(key);
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    mbedtls_ssl_session session;
+    std::chrono::steady_clock::time_point stored;
+    size_t size = 0;
+  };
+
+  std::mutex mutex;
+  std::list<Entry> entries;  // most recently used first
+  size_t bytes = 0;
+
+  void forgetLocked(const std::string& key) {
+    for (auto it = entries.begin(); it != entries.end(); it++) {
+      if (it->key == key) {
+        erase(it);
+        return;
+      }
+    }
+  }
+
+  void erase(std::list<Entry>::iterator it) {
+    bytes -= it->size;
+    mbedtls_ssl_session_free(&it->session);
+    entries.erase(it);
+  }
+
+  // Heap held by a session (ticket and peer certificate), as serialized
+  static size_t sizeOf(const mbedtls_ssl_session* session) {
+    size_t len = sizeof(mbedtls_ssl_session);
+#if MBEDTLS_VERSION_NUMBER >= 0x02130000
+    size_t serialized = 0;
+    mbedtls_ssl_session_save(session, NULL, 0, &serialized);
+    len += serialized;
+#endif
+    return len;
+  }
+};
+
+TLSSessionCache sessionCache;
+}  // namespace
+
 /**
  * Platform TLSSocket implementation for the mbedtls
  */
@@ -69,12 +178,21 @@ void bell::TLSSocket::open(const std::string& hostUrl, uint16_t port) {
   mbedtls_ssl_set_bio(&ssl, &server_fd, mbedtls_net_send, mbedtls_net_recv,
                       NULL);
 
+  // server falls back to a full handshake if it does not accept the session
+  std::string sessionKey = hostUrl + ":" + std::to_string(port);
+  bool offered = sessionCache.restore(sessionKey, &ssl);
+
   while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
     if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
       BELL_LOG(error, "http_tls", "failed! config returned %d\n", ret);
+      sessionCache.forget(sessionKey);
       throw std::runtime_error("mbedtls_ssl_handshake error");
     }
   }
+
+  BELL_LOG(debug, "http_tls", "handshake with %s done (session %s)\n",
+           sessionKey.c_str(), offered ? "offered" : "new");
+  sessionCache.save(sessionKey, &ssl);
 }
 
 size_t bell::TLSSocket::read(uint8_t* buf, size_t len) {
@@ -24,6 +24,11 @@ class Task {
   std::string TASK;
   int stackSize, core;
   bool runOnPSRAM;
+#ifdef ESP_PLATFORM
+  // lets the platform override placement of tasks it knows by name
+  inline static void (*placement)(const char* name, int* priority, int* core,
+                                  bool* runOnPSRAM) = nullptr;
+#endif
   Task(std::string taskName, int stackSize, int priority, int core,
        bool runOnPSRAM = true) {
     this->TASK = taskName;
@@ -35,7 +40,10 @@ class Task {
     this->priority = CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT + priority;
     if (this->priority <= ESP_TASK_PRIO_MIN)
       this->priority = ESP_TASK_PRIO_MIN + 1;
-    if (runOnPSRAM) {
+    if (placement)
+      placement(this->TASK.c_str(), &this->priority, &this->core,
+                &this->runOnPSRAM);
+    if (this->runOnPSRAM) {
       this->xStack = (StackType_t*)heap_caps_malloc(
           this->stackSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
     }
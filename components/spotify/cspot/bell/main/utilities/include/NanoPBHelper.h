@@ -11,6 +11,8 @@
 std::vector<uint8_t> pbEncode(const pb_msgdesc_t* fields,
                               const void* src_struct);
 
+pb_ostream_t pb_ostream_from_vector(std::vector<uint8_t>& vec);
+
 pb_bytes_array_t* vectorToPbArray(const std::vector<uint8_t>& vectorToPack);
 
 void packString(char*& dst, std::string stringToPack);
@@ -32,6 +34,18 @@ T pbDecode(const pb_msgdesc_t* fields, std::vector<uint8_t>& data) {
   return result;
 }
 
+template <typename T>
+void pbDecode(T& result, const pb_msgdesc_t* fields, const uint8_t* data,
+              size_t size) {
+  // Create stream
+  pb_istream_t stream = pb_istream_from_buffer(data, size);
+
+  // Decode the message
+  if (pb_decode(&stream, fields, &result) == false) {
+    printf("Decode failed: %s\n", PB_GET_ERROR(&stream));
+  }
+}
+
 template <typename T>
 void pbDecode(T& result, const pb_msgdesc_t* fields,
               std::vector<uint8_t>& data) {
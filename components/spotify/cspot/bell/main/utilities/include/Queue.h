@@ -3,7 +3,9 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <mutex>
 #include <queue>
+#include <utility>
 
 namespace bell {
 template <typename dataType>
@@ -28,6 +30,15 @@ class Queue {
     lk.unlock();
     m_cv.notify_one();
   }
+  /// <summary> Move a new element in the queue. </summary>
+  /// <param name="data"> New element. </param>
+  void push(dataType&& data) {
+    m_forceExit.store(false);
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_queue.push(std::move(data));
+    lk.unlock();
+    m_cv.notify_one();
+  }
   /// <summary> Check queue empty. </summary>
   /// <returns> True if the queue is empty. </returns>
   bool isEmpty() const {
@@ -42,7 +53,7 @@ class Queue {
     if (m_queue.empty()) {
       return false;
     } else {
-      popped_value = m_queue.front();
+      popped_value = std::move(m_queue.front());
       m_queue.pop();
       return true;
     }
@@ -56,7 +67,7 @@ class Queue {
               [&]() -> bool { return !m_queue.empty() || m_forceExit.load(); });
     if (m_forceExit.load())
       return false;
-    popped_value = m_queue.front();
+    popped_value = std::move(m_queue.front());
     m_queue.pop();
     return true;
   }
@@ -73,7 +84,7 @@ class Queue {
       return false;
     if (m_queue.empty())
       return false;
-    popped_value = m_queue.front();
+    popped_value = std::move(m_queue.front());
     m_queue.pop();
     return true;
   }
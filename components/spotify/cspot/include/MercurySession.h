@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>          // for array
 #include <atomic>         // for atomic
+#include <cstddef>        // for size_t
 #include <cstdint>        // for uint8_t, uint64_t, uint32_t
 #include <functional>     // for function
 #include <memory>         // for shared_ptr
@@ -24,10 +26,16 @@ class MercurySession : public bell::Task, public cspot::Session {
   ~MercurySession();
   typedef std::vector<std::vector<uint8_t>> DataParts;
 
+  // Part of a received packet, only valid while the response callback runs
+  struct DataView {
+    const uint8_t* data;
+    size_t size;
+  };
+
   struct Response {
     Header mercuryHeader;
     uint8_t flags;
-    DataParts parts;
+    std::vector<DataView> parts;
     uint64_t sequenceId;
     bool fail;
   };
@@ -101,6 +109,18 @@ class MercurySession : public bell::Task, public cspot::Session {
 
  private:
   const int PING_TIMEOUT_MS = 2 * 60 * 1000 + 5000;
+  const int REQUEST_TIMEOUT_MS = 10 * 1000;
+  const int DISPATCH_WAIT_MS = 200;
+
+  // Requests in flight, slot is sequence id modulo table size
+  static constexpr size_t MAX_PENDING = 16;
+
+  template <typename Id, typename Callback>
+  struct Pending {
+    Id sequenceId = 0;  // 0 marks a free slot
+    unsigned long long deadline;
+    Callback callback;
+  };
 
   std::shared_ptr<cspot::TimeProvider> timeProvider;
   Header tempMercuryHeader = {};
@@ -111,9 +131,10 @@ class MercurySession : public bell::Task, public cspot::Session {
   void runTask() override;
   void reconnect();
 
-  std::unordered_map<uint64_t, ResponseCallback> callbacks;
+  std::mutex pendingMutex;
+  std::array<Pending<uint64_t, ResponseCallback>, MAX_PENDING> callbacks;
+  std::array<Pending<uint32_t, AudioKeyCallback>, MAX_PENDING> audioKeyCallbacks;
   std::unordered_map<std::string, ResponseCallback> subscriptions;
-  std::unordered_map<uint32_t, AudioKeyCallback> audioKeyCallbacks;
 
   uint64_t sequenceId = 1;
   uint32_t audioKeySequence = 1;
@@ -128,6 +149,8 @@ class MercurySession : public bell::Task, public cspot::Session {
   std::atomic<bool> executeEstabilishedCallback = false;
 
   void failAllPending();
+  void failExpired();
+  void dispatch(cspot::Packet& packet);
 
   Response decodeResponse(const std::vector<uint8_t>& data);
 };
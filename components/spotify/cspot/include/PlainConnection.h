@@ -35,6 +35,14 @@ class PlainConnection {
   std::vector<uint8_t> recvPacket();
 
   void readBlock(const uint8_t* dst, size_t size);
+
+  /**
+   * @brief Read at least size bytes, and up to capacity if the socket already
+   * has them, so that callers can batch several small reads into one
+   * 
+   * @returns number of bytes actually read
+   */
+  size_t readAtLeast(uint8_t* dst, size_t size, size_t capacity);
   size_t writeBlock(const std::vector<uint8_t>& data);
 
  private:
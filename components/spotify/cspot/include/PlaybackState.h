@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>  // for size_t
 #include <stdint.h>  // for uint8_t, uint32_t
 #include <memory>    // for shared_ptr
 #include <string>    // for string
@@ -20,6 +21,15 @@ class PlaybackState {
 
   std::vector<uint8_t> frameData;
 
+  // Track list is the bulk of a frame but rarely changes, so its encoded
+  // form is kept and copied into frames until it is marked as changed
+  std::vector<TrackReference>* trackList = nullptr;
+  std::vector<uint8_t> encodedTrackList;
+  bool trackListChanged = true;
+
+  static bool pbEncodeTrackList(pb_ostream_t* stream, const pb_field_t* field,
+                                void* const* arg);
+
   void addCapability(
       CapabilityType typ, int intValue = -1,
       std::vector<std::string> stringsValue = std::vector<std::string>());
@@ -84,14 +94,26 @@ class PlaybackState {
      */
   void syncWithRemote();
 
+  /**
+   * @brief Sets the list of tracks to be sent in frames.
+   *
+   * @param tracks track list, must outlive this object
+   */
+  void setTrackList(std::vector<TrackReference>* tracks);
+
+  /**
+   * @brief To be called whenever content of the track list changes.
+   */
+  void markTrackListChanged();
+
   /**
      * @brief Encodes current frame into binary data via protobuf.
      *
      * @param typ message type to include in frame type
-     * @return std::vector<uint8_t> binary frame data
+     * @return binary frame data, valid until next call
      */
-  std::vector<uint8_t> encodeCurrentFrame(MessageType typ);
+  const std::vector<uint8_t>& encodeCurrentFrame(MessageType typ);
 
-  bool decodeRemoteFrame(std::vector<uint8_t>& data);
+  bool decodeRemoteFrame(const uint8_t* data, size_t size);
 };
 }  // namespace cspot
@@ -1,6 +1,7 @@
 #ifndef SHANNON_H
 #define SHANNON_H
 
+#include <cstddef>  // for size_t
 #include <cstdint>  // for uint32_t, uint8_t
 #include <vector>   // for vector
 
@@ -16,6 +17,11 @@ class Shannon {
   void decrypt(std::vector<uint8_t>& buf);       /* finalize + MAC */
   void finish(std::vector<uint8_t>& buf);        /* finalise MAC */
 
+  /* same as above, in place on raw memory */
+  void encrypt(uint8_t* buf, size_t len);
+  void decrypt(uint8_t* buf, size_t len);
+  void finish(uint8_t* buf, size_t len);
+
  private:
   static constexpr unsigned int FOLD = Shannon::N;
   static constexpr unsigned int INITKONST = 0x6996c53a;
@@ -1,6 +1,7 @@
 #ifndef SHANNONCONNECTION_H
 #define SHANNONCONNECTION_H
 
+#include <cstddef>  // for size_t
 #include <cstdint>  // for uint8_t, uint32_t
 #include <memory>   // for shared_ptr, unique_ptr
 #include <mutex>    // for mutex
@@ -15,6 +16,8 @@ class PlainConnection;
 }  // namespace cspot
 
 #define MAC_SIZE 4
+#define HEADER_SIZE 3
+#define RECV_BUFFER_SIZE 2048
 namespace cspot {
 class ShannonConnection {
  private:
@@ -22,7 +25,13 @@ class ShannonConnection {
   std::unique_ptr<Shannon> recvCipher;
   uint32_t sendNonce = 0;
   uint32_t recvNonce = 0;
-  std::vector<uint8_t> cipherPacket(uint8_t cmd, std::vector<uint8_t>& data);
+
+  // ciphertext read ahead from socket, consumed from recvStart to recvFill
+  std::vector<uint8_t> recvBuffer;
+  size_t recvStart = 0, recvFill = 0;
+  std::vector<uint8_t> sendBuffer;
+  void fillRecvBuffer(size_t size);
+
   std::mutex writeMutex;
   std::mutex readMutex;
 
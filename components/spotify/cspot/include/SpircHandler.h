@@ -1,13 +1,16 @@
 #pragma once
 
+#include <stddef.h>    // for size_t
 #include <stdint.h>    // for uint32_t, uint8_t
 #include <functional>  // for function
 #include <memory>      // for shared_ptr, unique_ptr
+#include <mutex>       // for mutex
 #include <string>      // for string
 #include <variant>     // for variant
 #include <vector>      // for vector
 
 #include "CDNAudioFile.h"  // for CDNTrackStream, CDNTrackStream::Track...
+#include "MercurySession.h"  // for MercurySession::DataParts
 #include "TrackQueue.h"
 #include "protobuf/spirc.pb.h"  // for MessageType
 
@@ -54,6 +57,9 @@ class SpircHandler {
 
   void notifyAudioReachedPlayback();
   void notifyAudioEnded();
+
+  // Sends state changes held back by coalescing, to be called periodically
+  void flushNotify();
   void updatePositionMs(uint32_t position);
   void setRemoteVolume(int volume);
   void loadTrackFromURI(const std::string& uri);
@@ -70,13 +76,21 @@ class SpircHandler {
 
   std::shared_ptr<cspot::PlaybackState> playbackState;
 
+  // Bursts of state changes within that window are sent as one frame
+  const int NOTIFY_COALESCE_MS = 100;
+
+  std::mutex notifyMutex, frameMutex;
+  bool notifyPending = false;
+  unsigned long long lastNotifyTimestamp = 0;
+  MercurySession::DataParts frameParts = MercurySession::DataParts(1);
+
   void sendCmd(MessageType typ);
 
   void sendEvent(EventType type);
   void sendEvent(EventType type, EventData data);
 
   bool skipSong(TrackQueue::SkipDirection dir);
-  void handleFrame(std::vector<uint8_t>& data);
+  void handleFrame(const uint8_t* data, size_t size);
   void notify();
 };
 }  // namespace cspot
@@ -30,6 +30,16 @@ struct TrackInfo {
   void loadPbEpisode(Episode* pbEpisode, const std::vector<uint8_t>& gid);
 };
 
+// Everything needed to play a track once resolved, kept for a while so that
+// skipping back or re-loading a context does not go through the steps again
+struct ResolvedTrack {
+  std::vector<uint8_t> gid;
+  TrackInfo trackInfo;
+  std::string identifier, cdnUrl;
+  std::vector<uint8_t> trackId, fileId, audioKey;
+  unsigned long long expiresAt;
+};
+
 class QueuedTrack {
  public:
   QueuedTrack(TrackReference& ref, std::shared_ptr<cspot::Context> ctx,
@@ -74,6 +84,10 @@ class QueuedTrack {
 
   void expire();
 
+  // --- Resolver cache ---
+  ResolvedTrack getResolved();
+  void loadResolved(const ResolvedTrack& resolved);
+
  private:
   std::shared_ptr<cspot::Context> ctx;
 
@@ -108,6 +122,8 @@ class TrackQueue : public bell::Task {
 
  private:
   static const int MAX_TRACKS_PRELOAD = 3;
+  static const int MAX_TRACKS_RESOLVED = 8;
+  static const int RESOLVED_EXPIRY_MS = 10 * 60 * 1000;
 
   std::shared_ptr<cspot::AccessKeyFetcher> accessKeyFetcher;
   std::shared_ptr<PlaybackState> playbackState;
@@ -115,6 +131,7 @@ class TrackQueue : public bell::Task {
   std::shared_ptr<bell::WrappedSemaphore> processSemaphore;
 
   std::deque<std::shared_ptr<QueuedTrack>> preloadedTracks;
+  std::deque<ResolvedTrack> resolvedTracks;
   std::vector<TrackReference> currentTracks;
   std::mutex tracksMutex, runningMutex;
 
@@ -129,6 +146,7 @@ class TrackQueue : public bell::Task {
   bool isRunning = false;
 
   void processTrack(std::shared_ptr<QueuedTrack> track);
+  void cacheResolved(std::shared_ptr<QueuedTrack> track);
   bool queueNextTrack(int offset = 0, uint32_t positionMs = 0);
 };
 }  // namespace cspot
@@ -1,6 +1,7 @@
 #include "MercurySession.h"
 
 #include <string.h>     // for memcpy
+#include <algorithm>    // for min
 #include <memory>       // for shared_ptr
 #include <mutex>        // for scoped_lock
 #include <stdexcept>    // for runtime_error
@@ -39,7 +40,7 @@ void MercurySession::runTask() {
     cspot::Packet packet = {};
     try {
       packet = shanConn->recvPacket();
-      CSPOT_LOG(info, "Received packet, command: %d", packet.command);
+      CSPOT_LOG(debug, "Received packet, command: %d", packet.command);
 
       if (static_cast<RequestType>(packet.command) == RequestType::PING) {
         timeProvider->syncWithPingPacket(packet.data);
@@ -47,7 +48,7 @@ void MercurySession::runTask() {
         this->lastPingTimestamp = timeProvider->getSyncedTimestamp();
         this->shanConn->sendPacket(0x49, packet.data);
       } else {
-        this->packetQueue.push(packet);
+        this->packetQueue.push(std::move(packet));
       }
     } catch (const std::runtime_error& e) {
       CSPOT_LOG(error, "Error while receiving packet: %s", e.what());
@@ -109,18 +110,20 @@ bool MercurySession::triggerTimeout() {
 }
 
 void MercurySession::unregister(uint64_t sequenceId) {
-  auto callback = this->callbacks.find(sequenceId);
+  std::scoped_lock lock(this->pendingMutex);
+  auto& slot = this->callbacks[sequenceId % MAX_PENDING];
 
-  if (callback != this->callbacks.end()) {
-    this->callbacks.erase(callback);
+  if (slot.sequenceId == sequenceId) {
+    slot = {};
   }
 }
 
 void MercurySession::unregisterAudioKey(uint32_t sequenceId) {
-  auto callback = this->audioKeyCallbacks.find(sequenceId);
+  std::scoped_lock lock(this->pendingMutex);
+  auto& slot = this->audioKeyCallbacks[sequenceId % MAX_PENDING];
 
-  if (callback != this->audioKeyCallbacks.end()) {
-    this->audioKeyCallbacks.erase(callback);
+  if (slot.sequenceId == sequenceId) {
+    slot = {};
   }
 }
 
@@ -138,13 +141,25 @@ std::string MercurySession::getCountryCode() {
 void MercurySession::handlePacket() {
   Packet packet = {};
 
-  this->packetQueue.wtpop(packet, 200);
+  // Returns as soon as a packet is queued, the wait only bounds how long
+  // the caller's own polling is delayed when nothing comes in
+  bool received = this->packetQueue.wtpop(packet, DISPATCH_WAIT_MS);
 
   if (executeEstabilishedCallback && this->connectionReadyCallback != nullptr) {
     executeEstabilishedCallback = false;
     this->connectionReadyCallback();
   }
 
+  // Handle whatever arrived meanwhile before giving control back
+  while (received) {
+    dispatch(packet);
+    received = this->packetQueue.pop(packet);
+  }
+
+  failExpired();
+}
+
+void MercurySession::dispatch(cspot::Packet& packet) {
   switch (static_cast<RequestType>(packet.command)) {
     case RequestType::COUNTRY_CODE_RESPONSE: {
       this->countryCode = std::string();
@@ -155,15 +170,23 @@ void MercurySession::handlePacket() {
     }
     case RequestType::AUDIO_KEY_FAILURE_RESPONSE:
     case RequestType::AUDIO_KEY_SUCCESS_RESPONSE: {
-      // this->lastRequestTimestamp = -1;
-
       // First four bytes mark the sequence id
       auto seqId = ntohl(extract<uint32_t>(packet.data, 0));
+      AudioKeyCallback callback = nullptr;
+
+      {
+        std::scoped_lock lock(this->pendingMutex);
+        auto& slot = this->audioKeyCallbacks[seqId % MAX_PENDING];
+        if (slot.sequenceId == seqId) {
+          callback = std::move(slot.callback);
+          slot = {};
+        }
+      }
 
-      if (this->audioKeyCallbacks.count(seqId) > 0) {
+      if (callback) {
         auto success = static_cast<RequestType>(packet.command) ==
                        RequestType::AUDIO_KEY_SUCCESS_RESPONSE;
-        this->audioKeyCallbacks[seqId](success, packet.data);
+        callback(success, packet.data);
       }
 
       break;
@@ -174,19 +197,36 @@ void MercurySession::handlePacket() {
       CSPOT_LOG(debug, "Received mercury packet");
 
       auto response = this->decodeResponse(packet.data);
-      if (this->callbacks.count(response.sequenceId) > 0) {
-        auto seqId = response.sequenceId;
-        this->callbacks[response.sequenceId](response);
-        this->callbacks.erase(this->callbacks.find(seqId));
+      ResponseCallback callback = nullptr;
+
+      {
+        std::scoped_lock lock(this->pendingMutex);
+        auto& slot = this->callbacks[response.sequenceId % MAX_PENDING];
+        if (slot.sequenceId == response.sequenceId) {
+          callback = std::move(slot.callback);
+          slot = {};
+        }
+      }
+
+      if (callback) {
+        callback(response);
       }
       break;
     }
     case RequestType::SUBRES: {
       auto response = decodeResponse(packet.data);
+      ResponseCallback callback = nullptr;
+
+      {
+        std::scoped_lock lock(this->pendingMutex);
+        auto it = this->subscriptions.find(response.mercuryHeader.uri);
+        if (it != this->subscriptions.end()) {
+          callback = it->second;
+        }
+      }
 
-      auto uri = std::string(response.mercuryHeader.uri);
-      if (this->subscriptions.count(uri) > 0) {
-        this->subscriptions[uri](response);
+      if (callback) {
+        callback(response);
       }
       break;
     }
@@ -195,49 +235,119 @@ void MercurySession::handlePacket() {
   }
 }
 
+void MercurySession::failExpired() {
+  std::vector<ResponseCallback> expired;
+  std::vector<AudioKeyCallback> expiredKeys;
+  auto now = getCurrentTimestamp();
+
+  {
+    std::scoped_lock lock(this->pendingMutex);
+
+    for (auto& slot : this->callbacks) {
+      if (slot.sequenceId && now > slot.deadline) {
+        CSPOT_LOG(error, "Mercury request %llu timed out", slot.sequenceId);
+        expired.push_back(std::move(slot.callback));
+        slot = {};
+      }
+    }
+
+    for (auto& slot : this->audioKeyCallbacks) {
+      if (slot.sequenceId && now > slot.deadline) {
+        CSPOT_LOG(error, "Audio key request %u timed out", slot.sequenceId);
+        expiredKeys.push_back(std::move(slot.callback));
+        slot = {};
+      }
+    }
+  }
+
+  // Callbacks might issue new requests, so they run unlocked
+  Response response = {};
+  response.fail = true;
+
+  for (auto& callback : expired) {
+    if (callback)
+      callback(response);
+  }
+
+  for (auto& callback : expiredKeys) {
+    if (callback)
+      callback(false, {});
+  }
+}
+
 void MercurySession::failAllPending() {
+  std::vector<ResponseCallback> pending;
+  std::vector<AudioKeyCallback> pendingKeys;
+  std::unordered_map<std::string, ResponseCallback> subscriptions;
+
+  {
+    std::scoped_lock lock(this->pendingMutex);
+
+    for (auto& slot : this->callbacks) {
+      if (slot.sequenceId)
+        pending.push_back(std::move(slot.callback));
+      slot = {};
+    }
+
+    for (auto& slot : this->audioKeyCallbacks) {
+      if (slot.sequenceId)
+        pendingKeys.push_back(std::move(slot.callback));
+      slot = {};
+    }
+
+    // Remove references
+    subscriptions.swap(this->subscriptions);
+  }
+
   Response response = {};
   response.fail = true;
 
   // Fail all callbacks
-  for (auto& it : this->callbacks) {
-    it.second(response);
+  for (auto& callback : pending) {
+    if (callback)
+      callback(response);
+  }
+
+  for (auto& callback : pendingKeys) {
+    if (callback)
+      callback(false, {});
   }
 
   // Fail all subscriptions
-  for (auto& it : this->subscriptions) {
+  for (auto& it : subscriptions) {
     it.second(response);
   }
-
-  // Remove references
-  this->subscriptions = {};
-  this->callbacks = {};
 }
 
 MercurySession::Response MercurySession::decodeResponse(
     const std::vector<uint8_t>& data) {
   Response response = {};
-  response.parts = {};
 
-  auto sequenceLength = ntohs(extract<uint16_t>(data, 0));
+  if (data.size() < 15) {
+    response.fail = true;
+    return response;
+  }
+
   response.sequenceId = hton64(extract<uint64_t>(data, 2));
 
   auto partsNumber = ntohs(extract<uint16_t>(data, 11));
+  size_t headerSize = ntohs(extract<uint16_t>(data, 13));
 
-  auto headerSize = ntohs(extract<uint16_t>(data, 13));
-  auto headerBytes =
-      std::vector<uint8_t>(data.begin() + 15, data.begin() + 15 + headerSize);
+  // Parts are not copied, they point into the packet
+  response.parts.reserve(partsNumber);
 
-  auto pos = 15 + headerSize;
-  while (pos < data.size()) {
-    auto partSize = ntohs(extract<uint16_t>(data, pos));
+  size_t pos = 15 + headerSize;
+  while (pos + 2 <= data.size()) {
+    size_t partSize = ntohs(extract<uint16_t>(data, pos));
+    if (pos + 2 + partSize > data.size())
+      break;
 
-    response.parts.push_back(std::vector<uint8_t>(
-        data.begin() + pos + 2, data.begin() + pos + 2 + partSize));
+    response.parts.push_back({data.data() + pos + 2, partSize});
     pos += 2 + partSize;
   }
 
-  pbDecode(response.mercuryHeader, Header_fields, headerBytes);
+  pbDecode(response.mercuryHeader, Header_fields, data.data() + 15,
+           std::min(headerSize, data.size() - 15));
   response.fail = false;
 
   return response;
@@ -264,19 +374,40 @@ uint64_t MercurySession::executeSubscription(RequestType method,
     method = RequestType::SEND;
   }
 
-  if (method == RequestType::SUB) {
-    this->subscriptions.insert({uri, subscription});
-  }
-
   auto headerBytes = pbEncode(Header_fields, &tempMercuryHeader);
 
-  this->callbacks.insert({sequenceId, callback});
+  uint64_t sequenceId;
+  ResponseCallback evicted = nullptr;
+
+  {
+    std::scoped_lock lock(this->pendingMutex);
+    sequenceId = this->sequenceId++;
+
+    if (method == RequestType::SUB) {
+      this->subscriptions.insert({uri, subscription});
+    }
+
+    // Table is full, oldest request gives up its slot
+    auto& slot = this->callbacks[sequenceId % MAX_PENDING];
+    if (slot.sequenceId) {
+      CSPOT_LOG(error, "Too many mercury requests, dropping %llu",
+                slot.sequenceId);
+      evicted = std::move(slot.callback);
+    }
+    slot = {sequenceId, getCurrentTimestamp() + REQUEST_TIMEOUT_MS, callback};
+  }
+
+  if (evicted) {
+    Response response = {};
+    response.fail = true;
+    evicted(response);
+  }
 
   // Structure: [Sequence size] [SequenceId] [0x1] [Payloads number]
   // [Header size] [Header] [Payloads (size + data)]
 
   // Pack sequenceId
-  auto sequenceIdBytes = pack<uint64_t>(hton64(this->sequenceId));
+  auto sequenceIdBytes = pack<uint64_t>(hton64(sequenceId));
   auto sequenceSizeBytes = pack<uint16_t>(htons(sequenceIdBytes.size()));
 
   sequenceIdBytes.insert(sequenceIdBytes.begin(), sequenceSizeBytes.begin(),
@@ -302,9 +433,6 @@ uint64_t MercurySession::executeSubscription(RequestType method,
                            payload[x].end());
   }
 
-  // Bump sequence id
-  this->sequenceId += 1;
-
   try {
     this->shanConn->sendPacket(
         static_cast<std::underlying_type<RequestType>::type>(method),
@@ -313,28 +441,43 @@ uint64_t MercurySession::executeSubscription(RequestType method,
     // @TODO: handle disconnect
   }
 
-  return this->sequenceId - 1;
+  return sequenceId;
 }
 
 uint32_t MercurySession::requestAudioKey(const std::vector<uint8_t>& trackId,
                                          const std::vector<uint8_t>& fileId,
                                          AudioKeyCallback audioCallback) {
   auto buffer = fileId;
+  uint32_t sequenceId;
+  AudioKeyCallback evicted = nullptr;
 
   // Store callback
-  this->audioKeyCallbacks.insert({this->audioKeySequence, audioCallback});
+  {
+    std::scoped_lock lock(this->pendingMutex);
+    sequenceId = this->audioKeySequence++;
+
+    auto& slot = this->audioKeyCallbacks[sequenceId % MAX_PENDING];
+    if (slot.sequenceId) {
+      CSPOT_LOG(error, "Too many audio key requests, dropping %u",
+                slot.sequenceId);
+      evicted = std::move(slot.callback);
+    }
+    slot = {sequenceId, getCurrentTimestamp() + REQUEST_TIMEOUT_MS,
+            audioCallback};
+  }
+
+  if (evicted) {
+    evicted(false, {});
+  }
 
   // Structure: [FILEID] [TRACKID] [4 BYTES SEQUENCE ID] [0x00, 0x00]
   buffer.insert(buffer.end(), trackId.begin(), trackId.end());
-  auto audioKeySequenceBuffer = pack<uint32_t>(htonl(this->audioKeySequence));
+  auto audioKeySequenceBuffer = pack<uint32_t>(htonl(sequenceId));
   buffer.insert(buffer.end(), audioKeySequenceBuffer.begin(),
                 audioKeySequenceBuffer.end());
   auto suffix = std::vector<uint8_t>({0x00, 0x00});
   buffer.insert(buffer.end(), suffix.begin(), suffix.end());
 
-  // Bump audio key sequence
-  this->audioKeySequence += 1;
-
   // Used for broken connection detection
   // this->lastRequestTimestamp = timeProvider->getSyncedTimestamp();
   try {
@@ -343,5 +486,5 @@ uint32_t MercurySession::requestAudioKey(const std::vector<uint8_t>& trackId,
   } catch (...) {
     // @TODO: Handle disconnect
   }
-  return audioKeySequence - 1;
+  return sequenceId;
 }
@@ -132,13 +132,18 @@ std::vector<uint8_t> PlainConnection::sendPrefixPacket(
 }
 
 void PlainConnection::readBlock(const uint8_t* dst, size_t size) {
+  readAtLeast((uint8_t*)dst, size, size);
+}
+
+size_t PlainConnection::readAtLeast(uint8_t* dst, size_t size,
+                                    size_t capacity) {
   unsigned int idx = 0;
   ssize_t n;
   int retries = 0;
 
   while (idx < size) {
   READ:
-    if ((n = recv(this->apSock, (char*)&dst[idx], size - idx, 0)) <= 0) {
+    if ((n = recv(this->apSock, (char*)&dst[idx], capacity - idx, 0)) <= 0) {
       switch (getErrno()) {
         case EAGAIN:
         case ETIMEDOUT:
@@ -157,6 +162,8 @@ void PlainConnection::readBlock(const uint8_t* dst, size_t size) {
     }
     idx += n;
   }
+
+  return idx;
 }
 
 size_t PlainConnection::writeBlock(const std::vector<uint8_t>& data) {
@@ -16,6 +16,7 @@
 #include "Packet.h"              // for cspot
 #include "pb.h"                  // for pb_bytes_array_t, PB_BYTES_ARRAY_T_A...
 #include "pb_decode.h"           // for pb_release
+#include "pb_encode.h"           // for pb_encode, pb_write
 #include "protobuf/spirc.pb.h"
 
 using namespace cspot;
@@ -25,6 +26,9 @@ PlaybackState::PlaybackState(std::shared_ptr<cspot::Context> ctx) {
   innerFrame = {};
   remoteFrame = {};
 
+  // Usual frame size, saves growing the buffer in steps on first sends
+  frameData.reserve(2048);
+
   // Prepare callbacks for decoding of remote frame track data
   remoteFrame.state.track.funcs.decode = &TrackReference::pbDecodeTrackList;
   remoteFrame.state.track.arg = &remoteTracks;
@@ -144,17 +148,51 @@ void PlaybackState::setVolume(uint32_t volume) {
   ctx->config.volume = volume;
 }
 
-bool PlaybackState::decodeRemoteFrame(std::vector<uint8_t>& data) {
+bool PlaybackState::decodeRemoteFrame(const uint8_t* data, size_t size) {
   pb_release(Frame_fields, &remoteFrame);
 
   remoteTracks.clear();
 
-  pbDecode(remoteFrame, Frame_fields, data);
+  pbDecode(remoteFrame, Frame_fields, data, size);
 
   return true;
 }
 
-std::vector<uint8_t> PlaybackState::encodeCurrentFrame(MessageType typ) {
+void PlaybackState::setTrackList(std::vector<TrackReference>* tracks) {
+  trackList = tracks;
+  trackListChanged = true;
+
+  innerFrame.state.track.funcs.encode = &PlaybackState::pbEncodeTrackList;
+  innerFrame.state.track.arg = this;
+}
+
+void PlaybackState::markTrackListChanged() {
+  trackListChanged = true;
+}
+
+bool PlaybackState::pbEncodeTrackList(pb_ostream_t* stream,
+                                      const pb_field_t* field,
+                                      void* const* arg) {
+  auto self = static_cast<PlaybackState*>(*arg);
+
+  // Re-encode only when needed, buffer keeps its capacity
+  if (self->trackListChanged) {
+    void* tracks = self->trackList;
+    pb_ostream_t trackStream = pb_ostream_from_vector(self->encodedTrackList);
+
+    self->encodedTrackList.clear();
+    if (!TrackReference::pbEncodeTrackList(&trackStream, field, &tracks)) {
+      return false;
+    }
+    self->trackListChanged = false;
+  }
+
+  return pb_write(stream, self->encodedTrackList.data(),
+                  self->encodedTrackList.size());
+}
+
+const std::vector<uint8_t>& PlaybackState::encodeCurrentFrame(
+    MessageType typ) {
   // Prepare current frame info
   innerFrame.version = 1;
   innerFrame.seq_nr = this->seqNum;
@@ -170,7 +208,12 @@ std::vector<uint8_t> PlaybackState::encodeCurrentFrame(MessageType typ) {
 
   this->seqNum += 1;
 
-  return pbEncode(Frame_fields, &innerFrame);
+  // Frame buffer is reused, it only grows when the frame does
+  frameData.clear();
+  pb_ostream_t stream = pb_ostream_from_vector(frameData);
+  pb_encode(&stream, Frame_fields, &innerFrame);
+
+  return frameData;
 }
 
 // Wraps messy nanopb setters. @TODO: find a better way to handle this
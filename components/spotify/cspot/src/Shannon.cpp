@@ -258,8 +258,10 @@ void Shannon::maconly(std::vector<uint8_t>& bufVec) {
 }
 
 void Shannon::encrypt(std::vector<uint8_t>& bufVec) {
-  size_t nbytes = bufVec.size();
-  uint8_t* buf = bufVec.data();
+  this->encrypt(bufVec.data(), bufVec.size());
+}
+
+void Shannon::encrypt(uint8_t* buf, size_t nbytes) {
   uint8_t* endbuf;
   uint32_t t = 0;
 
@@ -306,8 +308,10 @@ void Shannon::encrypt(std::vector<uint8_t>& bufVec) {
 }
 
 void Shannon::decrypt(std::vector<uint8_t>& bufVec) {
-  size_t nbytes = bufVec.size();
-  uint8_t* buf = bufVec.data();
+  this->decrypt(bufVec.data(), bufVec.size());
+}
+
+void Shannon::decrypt(uint8_t* buf, size_t nbytes) {
   uint8_t* endbuf;
   uint32_t t = 0;
 
@@ -353,8 +357,10 @@ void Shannon::decrypt(std::vector<uint8_t>& bufVec) {
 }
 
 void Shannon::finish(std::vector<uint8_t>& bufVec) {
-  size_t nbytes = bufVec.size();
-  uint8_t* buf = bufVec.data();
+  this->finish(bufVec.data(), bufVec.size());
+}
+
+void Shannon::finish(uint8_t* buf, size_t nbytes) {
   int i;
 
   /* handle any previously buffered bytes */
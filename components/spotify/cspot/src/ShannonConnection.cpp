@@ -1,5 +1,7 @@
 #include "ShannonConnection.h"
 
+#include <algorithm>    // for copy
+#include <cstring>      // for memcmp
 #include <type_traits>  // for remove_extent_t
 
 #include "BellLogger.h"       // for AbstractLogger
@@ -33,75 +35,105 @@ void ShannonConnection::wrapConnection(
   // Set initial nonce
   this->sendCipher->nonce(pack<uint32_t>(htonl(0)));
   this->recvCipher->nonce(pack<uint32_t>(htonl(0)));
+
+  // Frame buffers are kept for the whole session
+  this->recvBuffer.resize(RECV_BUFFER_SIZE);
+  this->recvStart = this->recvFill = 0;
+  this->sendBuffer.reserve(RECV_BUFFER_SIZE);
 }
 
 void ShannonConnection::sendPacket(uint8_t cmd, std::vector<uint8_t>& data) {
   std::scoped_lock lock(this->writeMutex);
-  auto rawPacket = this->cipherPacket(cmd, data);
 
-  // Shannon encrypt the packet and write it to sock
-  this->sendCipher->encrypt(rawPacket);
-  this->conn->writeBlock(rawPacket);
+  // Frame is [Command] [Size] [Raw data] [Mac], built in a reused buffer
+  size_t size = HEADER_SIZE + data.size();
+  this->sendBuffer.resize(size + MAC_SIZE);
+  this->sendBuffer[0] = cmd;
+  this->sendBuffer[1] = (data.size() >> 8) & 0xff;
+  this->sendBuffer[2] = data.size() & 0xff;
+  std::copy(data.begin(), data.end(), this->sendBuffer.begin() + HEADER_SIZE);
 
-  // Generate mac
-  std::vector<uint8_t> mac(MAC_SIZE);
-  this->sendCipher->finish(mac);
+  // Shannon encrypt header and body at once, then generate mac
+  this->sendCipher->encrypt(this->sendBuffer.data(), size);
+  this->sendCipher->finish(this->sendBuffer.data() + size, MAC_SIZE);
 
   // Update the nonce
   this->sendNonce += 1;
   this->sendCipher->nonce(pack<uint32_t>(htonl(this->sendNonce)));
 
-  // Write the mac to sock
-  this->conn->writeBlock(mac);
+  // Write the whole frame to sock
+  this->conn->writeBlock(this->sendBuffer);
+}
+
+void ShannonConnection::fillRecvBuffer(size_t size) {
+  // Move what's left of previous read to front and make room if needed
+  if (this->recvStart) {
+    std::copy(this->recvBuffer.begin() + this->recvStart,
+              this->recvBuffer.begin() + this->recvFill,
+              this->recvBuffer.begin());
+    this->recvFill -= this->recvStart;
+    this->recvStart = 0;
+  }
+
+  if (size > this->recvBuffer.size()) {
+    this->recvBuffer.resize(size);
+  }
+
+  // Get whatever the socket already has, as long as it fits
+  if (this->recvFill < size) {
+    this->recvFill += this->conn->readAtLeast(
+        this->recvBuffer.data() + this->recvFill, size - this->recvFill,
+        this->recvBuffer.size() - this->recvFill);
+  }
 }
 
 cspot::Packet ShannonConnection::recvPacket() {
   std::scoped_lock lock(this->readMutex);
 
-  std::vector<uint8_t> data(3);
   // Receive 3 bytes, cmd + int16 size
-  this->conn->readBlock(data.data(), 3);
-  this->recvCipher->decrypt(data);
+  if (this->recvFill - this->recvStart < HEADER_SIZE) {
+    fillRecvBuffer(HEADER_SIZE);
+  }
 
-  auto readSize = ntohs(extract<uint16_t>(data, 1));
-  auto packetData = std::vector<uint8_t>(readSize);
+  uint8_t* header = this->recvBuffer.data() + this->recvStart;
+  this->recvCipher->decrypt(header, HEADER_SIZE);
 
-  // Read and decode if the packet has an actual body
-  if (readSize > 0) {
-    this->conn->readBlock(packetData.data(), readSize);
-    this->recvCipher->decrypt(packetData);
+  uint8_t cmd = header[0];
+  size_t readSize = (header[1] << 8) | header[2];
+  size_t frameSize = HEADER_SIZE + readSize + MAC_SIZE;
+
+  // Body and mac are likely there already, otherwise wait for them
+  if (this->recvFill - this->recvStart < frameSize) {
+    fillRecvBuffer(frameSize);
   }
 
-  // Read mac
-  std::vector<uint8_t> mac(MAC_SIZE);
-  this->conn->readBlock(mac.data(), MAC_SIZE);
+  uint8_t* body = this->recvBuffer.data() + this->recvStart + HEADER_SIZE;
+  this->recvCipher->decrypt(body, readSize);
 
-  // Generate mac
-  std::vector<uint8_t> mac2(MAC_SIZE);
-  this->recvCipher->finish(mac2);
+  // Generate mac and check it against received one
+  uint8_t mac[MAC_SIZE];
+  this->recvCipher->finish(mac, MAC_SIZE);
 
-  if (mac != mac2) {
+  if (memcmp(mac, body + readSize, MAC_SIZE)) {
     CSPOT_LOG(error, "Shannon read: Mac doesn't match");
   }
 
   // Update the nonce
   this->recvNonce += 1;
   this->recvCipher->nonce(pack<uint32_t>(htonl(this->recvNonce)));
-  uint8_t cmd = 0;
-  if (data.size() > 0) {
-    cmd = data[0];
-  }
-  // data[0] == cmd
-  return Packet{cmd, packetData};
-}
 
-std::vector<uint8_t> ShannonConnection::cipherPacket(
-    uint8_t cmd, std::vector<uint8_t>& data) {
-  // Generate packet structure, [Command] [Size] [Raw data]
-  auto sizeRaw = pack<uint16_t>(htons(uint16_t(data.size())));
+  Packet packet{cmd, std::vector<uint8_t>(body, body + readSize)};
+
+  this->recvStart += frameSize;
+  if (this->recvStart == this->recvFill) {
+    this->recvStart = this->recvFill = 0;
 
-  sizeRaw.insert(sizeRaw.begin(), cmd);
-  sizeRaw.insert(sizeRaw.end(), data.begin(), data.end());
+    // Don't hold on to memory after an unusually large frame
+    if (this->recvBuffer.size() > RECV_BUFFER_SIZE) {
+      this->recvBuffer.resize(RECV_BUFFER_SIZE);
+      this->recvBuffer.shrink_to_fit();
+    }
+  }
 
-  return sizeRaw;
+  return packet;
 }
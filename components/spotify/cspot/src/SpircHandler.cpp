@@ -64,11 +64,11 @@ void SpircHandler::subscribeToMercury() {
     this->ctx->config.countryCode = this->ctx->session->getCountryCode();
   };
   auto subscriptionLambda = [this](MercurySession::Response& res) {
-    if (res.fail)
+    if (res.fail || res.parts.empty())
       return;
     CSPOT_LOG(debug, "Received subscription response");
 
-    this->handleFrame(res.parts[0]);
+    this->handleFrame(res.parts[0].data, res.parts[0].size);
   };
 
   ctx->session->executeSubscription(
@@ -123,9 +123,9 @@ void SpircHandler::disconnect() {
   this->ctx->session->disconnect();
 }
 
-void SpircHandler::handleFrame(std::vector<uint8_t>& data) {
+void SpircHandler::handleFrame(const uint8_t* data, size_t size) {
   // Decode received spirc frame
-  playbackState->decodeRemoteFrame(data);
+  playbackState->decodeRemoteFrame(data, size);
 
   switch (playbackState->remoteFrame.typ) {
     case MessageType_kMessageTypeNotify: {
@@ -242,6 +242,36 @@ void SpircHandler::setRemoteVolume(int volume) {
 }
 
 void SpircHandler::notify() {
+  {
+    std::scoped_lock lock(notifyMutex);
+    auto now = getCurrentTimestamp();
+
+    // First change of a burst goes out at once, following ones wait
+    if (now - lastNotifyTimestamp < NOTIFY_COALESCE_MS) {
+      notifyPending = true;
+      return;
+    }
+
+    lastNotifyTimestamp = now;
+    notifyPending = false;
+  }
+
+  this->sendCmd(MessageType_kMessageTypeNotify);
+}
+
+void SpircHandler::flushNotify() {
+  {
+    std::scoped_lock lock(notifyMutex);
+    auto now = getCurrentTimestamp();
+
+    if (!notifyPending || now - lastNotifyTimestamp < NOTIFY_COALESCE_MS) {
+      return;
+    }
+
+    lastNotifyTimestamp = now;
+    notifyPending = false;
+  }
+
   this->sendCmd(MessageType_kMessageTypeNotify);
 }
 
@@ -268,15 +298,16 @@ std::shared_ptr<TrackPlayer> SpircHandler::getTrackPlayer() {
 }
 
 void SpircHandler::sendCmd(MessageType typ) {
-  // Serialize current player state
-  auto encodedFrame = playbackState->encodeCurrentFrame(typ);
+  std::scoped_lock lock(frameMutex);
+
+  // Serialize current player state, parts keep their capacity
+  frameParts[0] = playbackState->encodeCurrentFrame(typ);
 
   auto responseLambda = [=](MercurySession::Response& res) {
   };
-  auto parts = MercurySession::DataParts({encodedFrame});
   ctx->session->execute(MercurySession::RequestType::SEND,
                         "hm://remote/user/" + ctx->config.username + "/",
-                        responseLambda, parts);
+                        responseLambda, frameParts);
 }
 void SpircHandler::setEventHandler(EventHandler handler) {
   this->eventHandler = handler;
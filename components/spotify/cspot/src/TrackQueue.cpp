@@ -319,6 +319,24 @@ void QueuedTrack::expire() {
   }
 }
 
+ResolvedTrack QueuedTrack::getResolved() {
+  return ResolvedTrack{ref.gid, trackInfo, identifier, cdnUrl,
+                       trackId, fileId,    audioKey,   0};
+}
+
+void QueuedTrack::loadResolved(const ResolvedTrack& resolved) {
+  trackInfo = resolved.trackInfo;
+  identifier = resolved.identifier;
+  cdnUrl = resolved.cdnUrl;
+  trackId = resolved.trackId;
+  fileId = resolved.fileId;
+  audioKey = resolved.audioKey;
+
+  CSPOT_LOG(info, "Track %s already resolved", trackInfo.name.c_str());
+  state = State::READY;
+  loadedSemaphore->give();
+}
+
 void QueuedTrack::stepLoadMetadata(
     Track* pbTrack, Episode* pbEpisode, std::mutex& trackListMutex,
     std::shared_ptr<bell::WrappedSemaphore> updateSemaphore) {
@@ -344,10 +362,12 @@ void QueuedTrack::stepLoadMetadata(
     // Parse the metadata
     if (ref.type == TrackReference::Type::TRACK) {
       pb_release(Track_fields, pbTrack);
-      pbDecode(*pbTrack, Track_fields, res.parts[0]);
+      pbDecode(*pbTrack, Track_fields, res.parts[0].data,
+               res.parts[0].size);
     } else {
       pb_release(Episode_fields, pbEpisode);
-      pbDecode(*pbEpisode, Episode_fields, res.parts[0]);
+      pbDecode(*pbEpisode, Episode_fields, res.parts[0].data,
+               res.parts[0].size);
     }
 
     // Parse received metadata
@@ -372,10 +392,8 @@ TrackQueue::TrackQueue(std::shared_ptr<cspot::Context> ctx,
   processSemaphore = std::make_shared<bell::WrappedSemaphore>();
   playableSemaphore = std::make_shared<bell::WrappedSemaphore>();
 
-  // Assign encode callback to track list
-  playbackState->innerFrame.state.track.funcs.encode =
-      &TrackReference::pbEncodeTrackList;
-  playbackState->innerFrame.state.track.arg = &currentTracks;
+  // Track list is what gets sent in frames
+  playbackState->setTrackList(&currentTracks);
   pbTrack = Track_init_zero;
   pbEpisode = Episode_init_zero;
 
@@ -421,6 +439,12 @@ void TrackQueue::runTask() {
     } else {
       std::scoped_lock lock(tracksMutex);
 
+      // Keep the window full so that upcoming tracks are resolved together
+      // instead of waiting for the previous one to be ready
+      while (preloadedTracks.size() < MAX_TRACKS_PRELOAD &&
+             queueNextTrack(preloadedTracks.size()))
+        ;
+
       trackQueue = preloadedTracks;
     }
 
@@ -494,10 +518,7 @@ void TrackQueue::processTrack(std::shared_ptr<QueuedTrack> track) {
       track->stepLoadCDNUrl(accessKey);
 
       if (track->state == QueuedTrack::State::READY) {
-        if (preloadedTracks.size() < MAX_TRACKS_PRELOAD) {
-          // Queue a new track to preload
-          queueNextTrack(preloadedTracks.size());
-        }
+        cacheResolved(track);
       }
       break;
     default:
@@ -519,17 +540,57 @@ bool TrackQueue::queueNextTrack(int offset, uint32_t positionMs) {
     preloadedTracks.pop_front();
   }
 
+  auto track = std::make_shared<QueuedTrack>(currentTracks[requestedRefIndex],
+                                             ctx, positionMs);
+
+  // Drop outdated entries, CDN urls don't last forever
+  auto now = ctx->timeProvider->getSyncedTimestamp();
+  resolvedTracks.erase(
+      std::remove_if(
+          resolvedTracks.begin(), resolvedTracks.end(),
+          [now](const ResolvedTrack& item) { return item.expiresAt < now; }),
+      resolvedTracks.end());
+
+  // Track might have been resolved recently
+  auto resolved = std::find_if(resolvedTracks.begin(), resolvedTracks.end(),
+                               [&track](const ResolvedTrack& item) {
+                                 return item.gid == track->ref.gid;
+                               });
+
+  if (resolved != resolvedTracks.end()) {
+    track->loadResolved(*resolved);
+  }
+
   if (offset <= 0) {
-    preloadedTracks.push_front(std::make_shared<QueuedTrack>(
-        currentTracks[requestedRefIndex], ctx, positionMs));
+    preloadedTracks.push_front(track);
   } else {
-    preloadedTracks.push_back(std::make_shared<QueuedTrack>(
-        currentTracks[requestedRefIndex], ctx, positionMs));
+    preloadedTracks.push_back(track);
   }
 
   return true;
 }
 
+void TrackQueue::cacheResolved(std::shared_ptr<QueuedTrack> track) {
+  std::scoped_lock lock(tracksMutex);
+
+  auto resolved = track->getResolved();
+  resolved.expiresAt =
+      ctx->timeProvider->getSyncedTimestamp() + RESOLVED_EXPIRY_MS;
+
+  // Most recent first, replacing any previous entry for that track
+  resolvedTracks.erase(std::remove_if(resolvedTracks.begin(),
+                                      resolvedTracks.end(),
+                                      [&resolved](const ResolvedTrack& item) {
+                                        return item.gid == resolved.gid;
+                                      }),
+                       resolvedTracks.end());
+  resolvedTracks.push_front(std::move(resolved));
+
+  if (resolvedTracks.size() > MAX_TRACKS_RESOLVED) {
+    resolvedTracks.pop_back();
+  }
+}
+
 bool TrackQueue::skipTrack(SkipDirection dir, bool expectNotify) {
   bool skipped = true;
   std::scoped_lock lock(tracksMutex);
@@ -597,6 +658,7 @@ bool TrackQueue::updateTracks(uint32_t requestedPosition, bool initial) {
 
   // Copy requested track list
   currentTracks = playbackState->remoteTracks;
+  playbackState->markTrackListChanged();
   currentTracksIndex = playbackState->innerFrame.state.playing_track_index;
 
   if (initial) {
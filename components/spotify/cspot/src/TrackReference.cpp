@@ -37,7 +37,7 @@ bool TrackReference::operator==(const TrackReference& other) const {
 bool TrackReference::pbEncodeTrackList(pb_ostream_t* stream,
                                        const pb_field_t* field,
                                        void* const* arg) {
-  auto trackQueue = *static_cast<std::vector<TrackReference>*>(*arg);
+  auto& trackQueue = *static_cast<std::vector<TrackReference>*>(*arg);
   static TrackRef msg = TrackRef_init_zero;
 
   // Prepare nanopb callbacks
@@ -46,7 +46,7 @@ bool TrackReference::pbEncodeTrackList(pb_ostream_t* stream,
   msg.gid.funcs.encode = &bell::nanopb::encodeVector;
   msg.queued.funcs.encode = &bell::nanopb::encodeBoolean;
 
-  for (auto trackRef : trackQueue) {
+  for (auto& trackRef : trackQueue) {
     if (!pb_encode_tag_for_field(stream, field)) {
       return false;
     }
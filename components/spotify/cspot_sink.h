@@ -18,7 +18,7 @@ extern "C"
 // STOP means remove playlist, FLUSH means flush audio buffer, DISC means bye-bye
 typedef enum { 	CSPOT_START, CSPOT_DISC, CSPOT_FLUSH, CSPOT_STOP, CSPOT_PLAY, CSPOT_PAUSE, CSPOT_SEEK, 
                 CSPOT_NEXT, CSPOT_PREV, CSPOT_TOGGLE, 
-                CSPOT_TRACK_INFO, CSPOT_TRACK_MARK,
+                CSPOT_TRACK_INFO, CSPOT_TRACK_MARK, CSPOT_END_MARK,
 				CSPOT_VOLUME, CSPOT_VOLUME_UP, CSPOT_VOLUME_DOWN, 
                 CSPOT_BUSY, CSPOT_QUERY_STARTED, CSPOT_QUERY_REMAINING, 
 } cspot_event_t;
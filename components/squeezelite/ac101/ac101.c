@@ -54,74 +54,82 @@ static void headset(bool active);
 static bool volume(unsigned left, unsigned right);
 static void power(adac_power_e mode);
 
-const struct adac_s dac_ac101 = { "AC101", init, adac_deinit, power, speaker, headset, volume };
+const struct adac_s dac_ac101 = { "AC101", init, adac_deinit, power, speaker, headset, volume, false };
 
 static void ac101_start(ac_module_t mode);
 static void ac101_stop(void);
 static void ac101_set_earph_volume(uint8_t volume);
 static void ac101_set_spk_volume(uint8_t volume);
 	
-/****************************************************************************************
- * init
- */
-static bool init(char *config, int i2c_port, i2s_config_t *i2s_config, bool *mck) {	 
-	adac_init(config, i2c_port);
-	if (adac_read_word(AC101_ADDR, CHIP_AUDIO_RS) == 0xffff) {
-		ESP_LOGW(TAG, "No AC101 detected");
-		i2c_driver_delete(i2c_port);
-		return false;		
-	}
-	
-	ESP_LOGI(TAG, "AC101 detected");
-	
-	adac_write_word(AC101_ADDR, CHIP_AUDIO_RS, 0x123);
-	vTaskDelay(100 / portTICK_PERIOD_MS); 
-	
+static const struct adac_reg_s ac101_init_sequence[] = {
 	// enable the PLL from BCLK source
-	adac_write_word(AC101_ADDR, PLL_CTRL1,	BIN(0000,0001,0100,1111));			// F=1,M=1,PLL,INT=31 (medium)				
-	adac_write_word(AC101_ADDR, PLL_CTRL2,	BIN(1000,0010,0000,0000));			// PLL,N_i=64,N_f=0*0.2
+	{ PLL_CTRL1, BIN(0000,0001,0100,1111) },			// F=1,M=1,PLL,INT=31 (medium)				
+	{ PLL_CTRL2, BIN(1000,0010,0000,0000) },			// PLL,N_i=64,N_f=0*0.2
 
 	// clocking system
-	adac_write_word(AC101_ADDR, SYSCLK_CTRL,  BIN(1010,1010,0000,1000));		// PLLCLK, BCLK1, IS1CLK, PLL, SYSCLK 
-	adac_write_word(AC101_ADDR, MOD_CLK_ENA,  BIN(1000,0000,0000,1100));		// IS21, ADC, DAC
-	adac_write_word(AC101_ADDR, MOD_RST_CTRL, BIN(1000,0000,0000,1100));		// IS21, ADC, DAC
-	adac_write_word(AC101_ADDR, I2S_SR_CTRL,  BIN(0111,0000,0000,0000));		// 44.1kHz
+	{ SYSCLK_CTRL, BIN(1010,1010,0000,1000) },		// PLLCLK, BCLK1, IS1CLK, PLL, SYSCLK 
+	{ MOD_CLK_ENA, BIN(1000,0000,0000,1100) },		// IS21, ADC, DAC
+	{ MOD_RST_CTRL, BIN(1000,0000,0000,1100) },		// IS21, ADC, DAC
+	{ I2S_SR_CTRL, BIN(0111,0000,0000,0000) },		// 44.1kHz
 	 
 	// analogue config
 #if BYTES_PER_FRAME == 8
 	// although it's 24 bits only, leave i2c_config.bits_per_sample at 32, DAC will only use what's needed
-	adac_write_word(AC101_ADDR, I2S1LCK_CTRL,    BIN(1000,1000,1011,0000));	// Slave, BCLK=I2S/8,LRCK=64,24bits,I2Smode,Stereo
+	{ I2S1LCK_CTRL, BIN(1000,1000,1011,0000) },	// Slave, BCLK=I2S/8,LRCK=64,24bits,I2Smode,Stereo
 #else
-	adac_write_word(AC101_ADDR, I2S1LCK_CTRL, 	 BIN(1000,1000,0101,0000));	// Slave, BCLK=I2S/8,LRCK=32,16bits,I2Smode,Stereo
+	{ I2S1LCK_CTRL, BIN(1000,1000,0101,0000) },	// Slave, BCLK=I2S/8,LRCK=32,16bits,I2Smode,Stereo
 #endif
-	adac_write_word(AC101_ADDR, I2S1_SDOUT_CTRL, BIN(1100,0000,0000,0000));	// I2S1ADC (R&L) 	
-	adac_write_word(AC101_ADDR, I2S1_SDIN_CTRL,  BIN(1100,0000,0000,0000));	// IS21DAC (R&L)
-	adac_write_word(AC101_ADDR, I2S1_MXR_SRC, 	 BIN(0010,0010,0000,0000));	// ADCL, ADCR
-	adac_write_word(AC101_ADDR, ADC_SRCBST_CTRL, BIN(0100,0100,0100,0000));	// disable all boost (default)
+	{ I2S1_SDOUT_CTRL, BIN(1100,0000,0000,0000) },	// I2S1ADC (R&L) 	
+	{ I2S1_SDIN_CTRL, BIN(1100,0000,0000,0000) },	// IS21DAC (R&L)
+	{ I2S1_MXR_SRC, BIN(0010,0010,0000,0000) },	// ADCL, ADCR
+	{ ADC_SRCBST_CTRL, BIN(0100,0100,0100,0000) },	// disable all boost (default)
 #if ENABLE_ADC
-	adac_write_word(AC101_ADDR, ADC_SRC, 		 BIN(0000,0100,0000,1000));	// source=linein(R/L)
-	adac_write_word(AC101_ADDR, ADC_DIG_CTRL,    BIN(1000,0000,0000,0000));	// enable digital ADC
-	adac_write_word(AC101_ADDR, ADC_ANA_CTRL,    BIN(1011, 1011,0000,0000));	// enable analogue R/L, 0dB
+	{ ADC_SRC, BIN(0000,0100,0000,1000) },	// source=linein(R/L)
+	{ ADC_DIG_CTRL, BIN(1000,0000,0000,0000) },	// enable digital ADC
+	{ ADC_ANA_CTRL, BIN(1011, 1011,0000,0000) },	// enable analogue R/L, 0dB
 #else
-	adac_write_word(AC101_ADDR, ADC_SRC, 		 BIN(0000,0000,0000,0000));	// source=none
-	adac_write_word(AC101_ADDR, ADC_DIG_CTRL,    BIN(0000,0000,0000,0000));	// disable digital ADC
-	adac_write_word(AC101_ADDR, ADC_ANA_CTRL,    BIN(0011, 0011,0000,0000));	// disable analogue R/L, 0dB
+	{ ADC_SRC, BIN(0000,0000,0000,0000) },	// source=none
+	{ ADC_DIG_CTRL, BIN(0000,0000,0000,0000) },	// disable digital ADC
+	{ ADC_ANA_CTRL, BIN(0011, 0011,0000,0000) },	// disable analogue R/L, 0dB
 #endif	
 
 	//Path Configuration
-	adac_write_word(AC101_ADDR, DAC_MXR_SRC, 	  BIN(1000,1000,0000,0000));	// DAC from I2S
-	adac_write_word(AC101_ADDR, DAC_DIG_CTRL, 	  BIN(1000,0000,0000,0000));	// enable DAC
-	adac_write_word(AC101_ADDR, OMIXER_DACA_CTRL, BIN(1111,0000,0000,0000));	// enable DAC/Analogue (see note on offset removal and PA)
-	adac_write_word(AC101_ADDR, OMIXER_DACA_CTRL, BIN(1111,1111,0000,0000));	// this toggle is needed for headphone PA offset
+	{ DAC_MXR_SRC, BIN(1000,1000,0000,0000) },	// DAC from I2S
+	{ DAC_DIG_CTRL, BIN(1000,0000,0000,0000) },	// enable DAC
+	{ OMIXER_DACA_CTRL, BIN(1111,0000,0000,0000) },	// enable DAC/Analogue (see note on offset removal and PA)
+	{ OMIXER_DACA_CTRL, BIN(1111,1111,0000,0000) },	// this toggle is needed for headphone PA offset
 #if ENABLE_ADC	
-	adac_write_word(AC101_ADDR, OMIXER_SR, 		BIN(0000,0001,0000,0010));	// source=DAC(R/L) (are DACR and DACL really inverted in bitmap?)
+	{ OMIXER_SR, BIN(0000,0001,0000,0010) },	// source=DAC(R/L) (are DACR and DACL really inverted in bitmap?)
 #else
-	adac_write_word(AC101_ADDR, OMIXER_SR, 		BIN(0000,0101,0000,1010));	// source=DAC(R/L) and LINEIN(R/L)
+	{ OMIXER_SR, BIN(0000,0101,0000,1010) },	// source=DAC(R/L) and LINEIN(R/L)
 #endif	
 	
 	// enable earphone & speaker
-	adac_write_word(AC101_ADDR, SPKOUT_CTRL, 0x0220);
-	adac_write_word(AC101_ADDR, HPOUT_CTRL, 0xf801);
+	{ SPKOUT_CTRL, 0x0220 },
+	{ HPOUT_CTRL, 0xf801 },
+};
+
+/****************************************************************************************
+ * init
+ */
+static bool init(char *config, int i2c_port, i2s_config_t *i2s_config, bool *mck) {	 
+	adac_init(config, i2c_port);
+	if (adac_read_word(AC101_ADDR, CHIP_AUDIO_RS) == 0xffff) {
+		ESP_LOGW(TAG, "No AC101 detected");
+		i2c_driver_delete(i2c_port);
+		return false;		
+	}
+	
+	ESP_LOGI(TAG, "AC101 detected");
+	
+	adac_write_word(AC101_ADDR, CHIP_AUDIO_RS, 0x123);
+	vTaskDelay(100 / portTICK_PERIOD_MS); 
+	
+	// whole sequence goes in one I2C transaction
+	if (adac_write_table(AC101_ADDR, ac101_init_sequence, sizeof(ac101_init_sequence) / sizeof(*ac101_init_sequence), true) != ESP_OK) {
+		ESP_LOGE(TAG, "could not initialize AC101");
+		return false;
+	}
 	
 	// set gain for speaker and earphone
 	ac101_set_spk_volume(100);
@@ -14,6 +14,15 @@
 #include "driver/i2c.h"
 
 typedef enum { ADAC_ON = 0, ADAC_STANDBY, ADAC_OFF } adac_power_e;
+typedef enum { ADAC_CMD_POWER = 0, ADAC_CMD_SPEAKER, ADAC_CMD_HEADSET, ADAC_CMD_VOLUME, ADAC_CMD_MAX } adac_cmd_e;
+
+// called from control task once command is applied (done) or replaced by a newer one (!done)
+typedef void (*adac_done_t)(adac_cmd_e cmd, bool done);
+
+struct adac_reg_s {
+	uint8_t reg;
+	uint16_t value;
+};
 
 struct adac_s {
 	char *model;
@@ -23,6 +32,7 @@ struct adac_s {
 	void (*speaker)(bool active);
 	void (*headset)(bool active);
 	bool (*volume)(unsigned left, unsigned right);
+	bool hw_volume;		// DAC applies volume, otherwise volume() is never called
 };
 
 extern const struct adac_s dac_tas57xx;
@@ -38,3 +48,9 @@ esp_err_t 	adac_write_byte(int i2c_addr, uint8_t reg, uint8_t val);
 esp_err_t 	adac_write_word(int i2c_addr, uint8_t reg, uint16_t val);
 uint8_t 	adac_read_byte(int i2c_addr, uint8_t reg);
 uint16_t 	adac_read_word(int i2c_addr, uint8_t reg);
+esp_err_t	adac_write_table(int i2c_addr, const struct adac_reg_s *table, size_t count, bool word);
+
+void		adac_control_init(const struct adac_s *dac);
+void		adac_control_close(void);
+void		adac_post(adac_cmd_e cmd, unsigned arg1, unsigned arg2, adac_done_t done);
+bool		adac_flush(uint32_t timeout_ms);
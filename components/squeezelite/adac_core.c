@@ -12,10 +12,13 @@
 #include <string.h> 
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
 #include <driver/i2s.h>
 #include "driver/i2c.h"
 #include "esp_log.h"
+#include "esp_task.h"
 #include "adac.h"
+#include "topology.h"
 
 #define PARSE_PARAM(S,P,C,V) do {									\
 	char *__p;														\
@@ -187,4 +190,185 @@ esp_err_t adac_write(int i2c_addr, uint8_t reg, uint8_t *data, size_t count) {
 	}
 	
 	return ret;
-}	
\ No newline at end of file
+}	
+/****************************************************************************************
+ * Write a register table as one I2C transaction (repeated start between registers)
+ */
+esp_err_t adac_write_table(int i2c_addr, const struct adac_reg_s *table, size_t count, bool word) {
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+
+	for (size_t i = 0; i < count; i++) {
+		uint8_t data[] = { (i2c_addr << 1) | I2C_MASTER_WRITE, table[i].reg, 
+						   word ? table[i].value >> 8 : table[i].value, table[i].value & 0xff };
+		i2c_master_start(cmd);
+		i2c_master_write(cmd, data, word ? 4 : 3, I2C_MASTER_NACK);
+	}
+
+	i2c_master_stop(cmd);
+	esp_err_t ret = i2c_master_cmd_begin(i2c_port, cmd, (100 + count * 10) / portTICK_RATE_MS);
+	i2c_cmd_link_delete(cmd);
+
+	if (ret != ESP_OK) {
+		ESP_LOGW(TAG, "I2C table write failed (%d registers)", (int) count);
+	}
+
+	return ret;
+}
+
+/****************************************************************************************
+ * Control channel: DAC commands are applied by a dedicated task so that callers (output
+ * thread, slimproto, jack handler) never wait for I2C unless they ask to with adac_flush. 
+ * Only the latest request of each command is kept, so a burst of volume changes results 
+ * in a single write. Task runs at output's priority so that a flush is not delayed.
+ */
+static struct {
+	TaskHandle_t task;
+	const struct adac_s *dac;
+	bool running, flush;
+	SemaphoreHandle_t flushed;
+	portMUX_TYPE mux;
+	struct {
+		bool set;
+		unsigned arg1, arg2;
+		adac_done_t done;
+	} pending[ADAC_CMD_MAX];
+} control = { .mux = portMUX_INITIALIZER_UNLOCKED };
+
+static void adac_apply(const struct adac_s *dac, adac_cmd_e cmd, unsigned arg1, unsigned arg2) {
+	switch (cmd) {
+	case ADAC_CMD_POWER:
+		dac->power(arg1);
+		break;
+	case ADAC_CMD_SPEAKER:
+		dac->speaker(arg1);
+		break;
+	case ADAC_CMD_HEADSET:
+		dac->headset(arg1);
+		break;
+	case ADAC_CMD_VOLUME:
+		dac->volume(arg1, arg2);
+		break;
+	default:
+		break;
+	}
+}
+
+static void adac_control_thread(void *arg) {
+	while (control.running) {
+		bool idle = true, flushed = false;
+
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		// power on goes before outputs and volume but standby/off goes last, once amp is muted
+		portENTER_CRITICAL(&control.mux);
+		bool on = control.pending[ADAC_CMD_POWER].set && control.pending[ADAC_CMD_POWER].arg1 == ADAC_ON;
+		portEXIT_CRITICAL(&control.mux);
+
+		for (int i = 0; i < ADAC_CMD_MAX && control.running; i++) {
+			int cmd = on ? i : (i + 1) % ADAC_CMD_MAX;
+
+			portENTER_CRITICAL(&control.mux);
+			bool set = control.pending[cmd].set;
+			unsigned arg1 = control.pending[cmd].arg1, arg2 = control.pending[cmd].arg2;
+			adac_done_t done = control.pending[cmd].done;
+			control.pending[cmd].set = false;
+			portEXIT_CRITICAL(&control.mux);
+
+			if (!set) continue;
+
+			adac_apply(control.dac, cmd, arg1, arg2);
+			if (done) done(cmd, true);
+		}
+
+		// a flush completes only when nothing has been posted meanwhile (we'll be notified again)
+		portENTER_CRITICAL(&control.mux);
+		for (int cmd = 0; cmd < ADAC_CMD_MAX; cmd++) if (control.pending[cmd].set) idle = false;
+		if (idle && control.flush) {
+			control.flush = false;
+			flushed = true;
+		}
+		portEXIT_CRITICAL(&control.mux);
+
+		if (flushed) xSemaphoreGive(control.flushed);
+	}
+
+	control.task = NULL;
+	vTaskDelete(NULL);
+}
+
+/****************************************************************************************
+ * 
+ */
+void adac_control_init(const struct adac_s *dac) {
+	if (control.task) return;
+
+	control.dac = dac;
+	control.running = true;
+	control.flush = false;
+	memset(control.pending, 0, sizeof(control.pending));
+	if (!control.flushed) control.flushed = xSemaphoreCreateBinary();
+
+	if (!control.flushed || 
+		xTaskCreatePinnedToCore(adac_control_thread, "dac_ctrl", 3 * 1024, NULL, topology_priority("dac_ctrl", CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT + 10), 
+								&control.task, topology_core("dac_ctrl", tskNO_AFFINITY)) != pdPASS) {
+		ESP_LOGE(TAG, "can't create DAC control task, commands will be synchronous");
+		control.running = false;
+		control.task = NULL;
+	}
+}
+
+/****************************************************************************************
+ * 
+ */
+void adac_control_close(void) {
+	if (!control.task) return;
+
+	control.running = false;
+	xTaskNotifyGive(control.task);
+	while (control.task) vTaskDelay(10 / portTICK_PERIOD_MS);
+}
+
+/****************************************************************************************
+ * 
+ */
+void adac_post(adac_cmd_e cmd, unsigned arg1, unsigned arg2, adac_done_t done) {
+	adac_done_t replaced = NULL;
+
+	if (cmd >= ADAC_CMD_MAX) return;
+
+	// no control task, just do it now
+	if (!control.task) {
+		const struct adac_s *dac = control.dac;
+		if (dac) adac_apply(dac, cmd, arg1, arg2);
+		if (done) done(cmd, dac != NULL);
+		return;
+	}
+
+	portENTER_CRITICAL(&control.mux);
+	if (control.pending[cmd].set) replaced = control.pending[cmd].done;
+	control.pending[cmd].set = true;
+	control.pending[cmd].arg1 = arg1;
+	control.pending[cmd].arg2 = arg2;
+	control.pending[cmd].done = done;
+	portEXIT_CRITICAL(&control.mux);
+
+	if (replaced) replaced(cmd, false);
+	xTaskNotifyGive(control.task);
+}
+
+/****************************************************************************************
+ * Wait till all commands posted so far have been applied (only one caller at a time)
+ */
+bool adac_flush(uint32_t timeout_ms) {
+	if (!control.task) return true;
+
+	// a previous flush might have timed out and been completed later
+	xSemaphoreTake(control.flushed, 0);
+
+	portENTER_CRITICAL(&control.mux);
+	control.flush = true;
+	portEXIT_CRITICAL(&control.mux);
+
+	xTaskNotifyGive(control.task);
+	return xSemaphoreTake(control.flushed, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
@@ -36,12 +36,8 @@ static bool volume(unsigned left, unsigned right);
 static void power(adac_power_e mode);
 static esp_err_t cs4265_update_bit(uint8_t reg_no,uint8_t mask,uint8_t val );
 static esp_err_t set_clock();
-const struct adac_s dac_cs4265 = { "CS4265", init, adac_deinit, power, speaker, headset, volume };
+const struct adac_s dac_cs4265 = { "CS4265", init, adac_deinit, power, speaker, headset, volume, false };
 
-struct cs4265_cmd_s {
-	uint8_t reg;
-	uint8_t value;
-};
 struct cs4265_private {
 	uint8_t format;
 	uint32_t sysclk;
@@ -307,7 +303,7 @@ static const struct cs4265_clk_para clk_map_table[] = {
 	{36864000, 192000, 2, 3},
 	{49152000, 192000, 2, 4},
 };
-static const struct cs4265_cmd_s cs4265_init_sequence[] = {
+static const struct adac_reg_s cs4265_init_sequence[] = {
 	{CS4265_PWRCTL, CS4265_PWRCTL_PDN_ADC | CS4265_PWRCTL_FREEZE | CS4265_PWRCTL_PDN_DAC | CS4265_PWRCTL_PDN_MIC},
  	{CS4265_DAC_CTL, CS4265_DAC_CTL_DIF0 | CS4265_DAC_CTL_MUTE}, 
  	{CS4265_SIG_SEL, CS4265_SIG_SEL_SDIN1},/// SDIN1
@@ -324,7 +320,6 @@ static const struct cs4265_cmd_s cs4265_init_sequence[] = {
  	{CS4265_INT_MASK, 0x00 },//
  	{CS4265_STATUS_MODE_MSB, 0x00 },//
  	{CS4265_STATUS_MODE_LSB, 0x00 },//
-	{0xff,0xff}
 };
 
 
@@ -397,18 +392,7 @@ static bool init(char *config, int i2c_port, i2s_config_t *i2s_config) {
     ESP_LOGD(TAG, "Configuring MCLK on GPIO0");
 	PIN_FUNC_SELECT(PERIPHS_IO_MUX_GPIO0_U, FUNC_GPIO0_CLK_OUT1);
    	REG_WRITE(PIN_CTRL, 0xFFFFFFF0);
-	i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-	for (int i = 0; cs4265_init_sequence[i].reg != 0xff; i++) {
-		i2c_master_start(i2c_cmd);
-		i2c_master_write_byte(i2c_cmd, (cs4265_addr << 1) | I2C_MASTER_WRITE, I2C_MASTER_NACK);
-		i2c_master_write_byte(i2c_cmd, cs4265_init_sequence[i].reg, I2C_MASTER_NACK);
-		i2c_master_write_byte(i2c_cmd, cs4265_init_sequence[i].value, I2C_MASTER_NACK);
-		ESP_LOGD(TAG, "i2c write %x at %u", cs4265_init_sequence[i].reg, cs4265_init_sequence[i].value);
-	}
-
-	i2c_master_stop(i2c_cmd);	
-	esp_err_t res = i2c_master_cmd_begin(i2c_port, i2c_cmd, 500 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(i2c_cmd);
+	esp_err_t res = adac_write_table(cs4265_addr, cs4265_init_sequence, ARRAY_SIZE(cs4265_init_sequence), false);
 
 	if (res != ESP_OK) {
 		ESP_LOGE(TAG, "could not intialize cs4265 %d", res);
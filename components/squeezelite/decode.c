@@ -54,6 +54,9 @@ static bool running = true;
 #endif
 
 static void *decode_thread() {
+#if PROCESS
+	decode_state codec_state = DECODE_RUNNING;
+#endif
 	
 	while (running) {
 		size_t bytes, space, min_space;
@@ -83,15 +86,23 @@ static void *decode_thread() {
 
 			if (space > min_space && (bytes > codec->min_read_bytes || toend)) {
 				
-				decode.state = codec->decode();
+				IF_DIRECT(
+					decode.state = codec->decode();
+				);
 
 				IF_PROCESS(
+					// frames held when outputbuf was full go first and codec's state is held until they are out
+					if (!process.in_frames) codec_state = codec->decode();
+
 					if (process.in_frames) {
 						process_samples();
 					}
 
-					if (decode.state == DECODE_COMPLETE) {
-						process_drain();
+					if (!process.in_frames) {
+						decode.state = codec_state;
+						if (decode.state == DECODE_COMPLETE) {
+							process_drain();
+						}
 					}
 				);
 
@@ -16,7 +16,22 @@
 #endif
 #include "platform_config.h"
 #include "squeezelite.h"
+#include "multiroom.h"
 
+#define SYNC_WIN_SLOW	32
+#define SYNC_WIN_CHECK	8
+#define SYNC_WIN_FAST	2
+
+typedef struct {
+	bool enabled;
+	int sum, count, win, errors[SYNC_WIN_SLOW];
+	s32_t len;
+	u32_t start_time, playtime;
+} sink_sync_t;
+
+static bool enable_multiroom;
+static EXT_RAM_ATTR sink_sync_t mr_sync;
+static u32_t mr_epoch;
 
 #if CONFIG_BT_SINK
 #include "bt_app_sink.h"
@@ -33,18 +48,9 @@ static bool enable_cspot;
 static bool enable_airplay;
 
 #define RAOP_OUTPUT_SIZE (((RAOP_SAMPLE_RATE * BYTES_PER_FRAME * 2 * 120) / 100) & ~BYTES_PER_FRAME)
-#define SYNC_WIN_SLOW	32
-#define SYNC_WIN_CHECK	8
-#define SYNC_WIN_FAST	2
 
 static raop_event_t	raop_state;
-
-static EXT_RAM_ATTR struct {
-	bool enabled;
-	int sum, count, win, errors[SYNC_WIN_SLOW];
-	s32_t len;
-	u32_t start_time, playtime;
-} raop_sync;
+static EXT_RAM_ATTR sink_sync_t raop_sync;
 #endif
 
 static enum { SINK_RUNNING, SINK_ABORT, SINK_DISCARD } sink_state;
@@ -54,7 +60,7 @@ static enum { SINK_RUNNING, SINK_ABORT, SINK_DISCARD } sink_state;
 #define LOCK_D   mutex_lock(decode.mutex);
 #define UNLOCK_D mutex_unlock(decode.mutex);
 
-enum { DECODE_BT = 1, DECODE_RAOP, DECODE_CSPOT };
+enum { DECODE_BT = 1, DECODE_RAOP, DECODE_CSPOT, DECODE_MULTIROOM };
 
 extern struct outputstate output;
 extern struct decodestate decode;
@@ -62,6 +68,68 @@ extern struct buffer *outputbuf;
 // this is the only system-wide loglevel variable
 extern log_level loglevel;
 
+/****************************************************************************************
+ * Common sync reset
+ */
+static void _sink_sync_reset(sink_sync_t *sync) {
+	sync->win = 1;
+	sync->sum = sync->count = 0;
+	memset(sync->errors, 0, sizeof(sync->errors));
+}
+
+/****************************************************************************************
+ * Common sync: compare when the most recent block will play with when it should and
+ * skip/pause frames accordingly (called with outputbuf locked)
+ */
+static void _sink_sync(sink_sync_t *sync, u32_t rate) {
+	if (!sync->enabled || output.state != OUTPUT_RUNNING || output.frames_played_dmp < output.device_frames) return;
+
+	u32_t ms, now = gettime_ms();
+	u32_t level = _buf_used(outputbuf);
+	int error;
+
+	// in how many ms will the most recent block play
+	ms = (((s32_t)(level - sync->len) / BYTES_PER_FRAME + output.device_frames + output.frames_in_process) * 10) / (rate / 100) - (s32_t) (now - output.updated);
+
+	// when outputbuf is empty, it means we have a network black-out or something
+	error = level ? (sync->playtime - now) - ms : 0;
+
+	if (loglevel == lDEBUG || !level) {
+		LOG_INFO("head local:%d, remote:%d (delta:%d)", ms, sync->playtime - now, error);
+		LOG_INFO("obuf:%u, sync_len:%u, devframes:%u, inproc:%u", _buf_used(outputbuf), sync->len, output.device_frames, output.frames_in_process);
+	}
+
+	// calculate sum, error and update sliding window
+	sync->errors[sync->count++ % sync->win] = error;
+	sync->sum += error;
+	error = sync->sum / min(sync->count, sync->win);
+
+	// wait till we have enough data or there is a strong deviation
+	if ((sync->count >= sync->win && abs(error) > 10) || (sync->count >= SYNC_WIN_CHECK && abs(error) > 100)) {
+		if (error < 0) {
+			output.skip_frames = -(error * (s32_t) rate) / 1000;
+			output.state = OUTPUT_SKIP_FRAMES;
+			LOG_INFO("skipping %u frames (count:%d)", output.skip_frames, sync->count);
+		} else {
+			output.pause_frames = (error * rate) / 1000;
+			output.state = OUTPUT_PAUSE_FRAMES;
+			LOG_INFO("pausing for %u frames (count: %d)", output.pause_frames, sync->count);
+		}
+
+		sync->sum = sync->count = 0;
+		memset(sync->errors, 0, sizeof(sync->errors));
+	}
+
+	// move to normal mode if possible
+	if (sync->win == 1) {
+		sync->win = SYNC_WIN_FAST;
+		LOG_INFO("backend played %u, desired %u, (delta:%d)", ms, sync->playtime - now, error);
+	} else if (sync->win == SYNC_WIN_FAST && sync->count >= SYNC_WIN_FAST && abs(error) < 10) {
+		sync->win = SYNC_WIN_SLOW;
+		LOG_INFO("switching to slow sync mode %u", sync->win);
+	}
+}
+
 /****************************************************************************************
  * Common sink data handler
  */
@@ -80,6 +148,9 @@ static uint32_t sink_data_handler(const uint8_t *data, uint32_t len, int retries
 	LOCK_O;
 	if (sink_state == SINK_ABORT) sink_state = SINK_RUNNING;
 
+	// what is already queued, for multiroom leader
+	size_t level = _buf_used(outputbuf);
+
 	// there will always be room at some point
 	while (len && wait && sink_state == SINK_RUNNING) {
 		bytes = min(_buf_space(outputbuf), _buf_cont_write(outputbuf)) / (BYTES_PER_FRAME / 4);
@@ -114,12 +185,42 @@ static uint32_t sink_data_handler(const uint8_t *data, uint32_t len, int retries
         _buf_inc_writep(outputbuf, outputbuf->size - (BYTES_PER_FRAME - (len % BYTES_PER_FRAME)));
 		LOG_WARN("Waited too long, dropping frames %d", len);
 	}
-    
+
+	// leader forwards what has been accepted, AirPlay has its own timeline. The accepted span
+	// is still in caller's buffer, so outputbuf is released while datagrams are sent
+	if (written && output.current_sample_rate && multiroom_leader()) {
+		u32_t rate = output.current_sample_rate, epoch = mr_epoch, playtime = 0;
+		u32_t earliest = gettime_ms() + ((u64_t) (level / BYTES_PER_FRAME + output.device_frames + output.frames_in_process) * 1000) / rate;
+#if CONFIG_AIRPLAY_SINK
+		if (output.external == DECODE_RAOP) playtime = raop_sync.playtime;
+#endif
+		UNLOCK_O;
+		playtime = multiroom_publish(data - written, written, rate, earliest, playtime);
+		LOCK_O;
+
+		// a flush while publishing has restarted the timeline
+		if (epoch == mr_epoch) {
+			mr_sync.playtime = playtime;
+			mr_sync.len = written;
+		}
+	}
+
     UNLOCK_O;
     
     return written;
 }
 
+/****************************************************************************************
+ * Multiroom leader: sources changes start a new session for followers
+ */
+static void _multiroom_flush(bool stop) {
+	if (!multiroom_leader()) return;
+	if (stop) multiroom_stop();
+	else multiroom_flush();
+	_sink_sync_reset(&mr_sync);
+	mr_epoch++;
+}
+
 /****************************************************************************************
  * BT sink data handler
  */
@@ -146,12 +247,14 @@ static bool bt_sink_cmd_handler(bt_sink_cmd_t cmd, va_list args)
 	switch(cmd) {
 	case BT_SINK_AUDIO_STARTED:
 		_buf_flush(outputbuf);
+		_output_flush_marks();
 		_buf_limit(outputbuf, 0);
 		output.next_sample_rate = output.current_sample_rate = va_arg(args, u32_t);
 		output.external = DECODE_BT;
 		output.state = OUTPUT_STOPPED;
 		output.frames_played = 0;
 		if (decode.state != DECODE_STOPPED) decode.state = DECODE_ERROR;
+		_multiroom_flush(false);
 		LOG_INFO("BT sink started");
 		break;
 	case BT_SINK_AUDIO_STOPPED:	
@@ -159,6 +262,7 @@ static bool bt_sink_cmd_handler(bt_sink_cmd_t cmd, va_list args)
 			if (output.state > OUTPUT_STOPPED) output.state = OUTPUT_STOPPED;
 			output.external = 0;
 			output.stop_time = gettime_ms();
+			_multiroom_flush(true);
 			LOG_INFO("BT sink stopped");
 		}	
 		break;
@@ -168,19 +272,26 @@ static bool bt_sink_cmd_handler(bt_sink_cmd_t cmd, va_list args)
 		break;
 	case BT_SINK_STOP:		
 		_buf_flush(outputbuf);
+		_output_flush_marks();
 		output.state = OUTPUT_STOPPED;
 		output.stop_time = gettime_ms();
 		sink_state = SINK_ABORT;
+		_multiroom_flush(false);
 		LOG_INFO("BT stop");
 		break;
 	case BT_SINK_PAUSE:		
 		output.stop_time = gettime_ms();
+		_multiroom_flush(false);
 		LOG_INFO("BT pause, just silence");
 		break;
-	case BT_SINK_RATE:
-		output.next_sample_rate = output.current_sample_rate = va_arg(args, u32_t);
-		LOG_INFO("Setting BT sample rate %u", output.next_sample_rate);
+	case BT_SINK_RATE: {
+		u32_t rate = va_arg(args, u32_t);
+		output.next_sample_rate = rate;
+		// buffered frames are still at the previous rate, switch when output reaches new ones
+		if (!_buf_used(outputbuf) || !_output_mark(OUTPUT_MARK_FORMAT, rate, NULL)) output.current_sample_rate = rate;
+		LOG_INFO("Setting BT sample rate %u", rate);
 		break;
+	}
 	case BT_SINK_VOLUME: {
 		u32_t volume = va_arg(args, u32_t);
 		volume = 65536 * powf(volume / 128.0f, 3);
@@ -227,56 +338,9 @@ static bool raop_sink_cmd_handler(raop_event_t event, va_list args)
 	
 	// this is async, so player might have been deleted
 	switch (event) {
-		case RAOP_TIMING: {
-			if (!raop_sync.enabled || output.state != OUTPUT_RUNNING || output.frames_played_dmp < output.device_frames) break;
-
-			u32_t ms, now = gettime_ms();
-			u32_t level = _buf_used(outputbuf);
-			int error;
-				
-			// in how many ms will the most recent block play 
-			ms = (((s32_t)(level - raop_sync.len) / BYTES_PER_FRAME + output.device_frames + output.frames_in_process) * 10) / (RAOP_SAMPLE_RATE / 100) - (s32_t) (now - output.updated);
-				
-			// when outputbuf is empty, it means we have a network black-out or something
-			error = level ? (raop_sync.playtime - now) - ms : 0;
-				
-			if (loglevel == lDEBUG || !level) {
-				LOG_INFO("head local:%d, remote:%d (delta:%d)", ms, raop_sync.playtime - now, error);
-				LOG_INFO("obuf:%u, sync_len:%u, devframes:%u, inproc:%u", _buf_used(outputbuf), raop_sync.len, output.device_frames, output.frames_in_process);
-			}	
-			
-			// calculate sum, error and update sliding window
-			raop_sync.errors[raop_sync.count++ % raop_sync.win] = error;
-			raop_sync.sum += error;
-			error = raop_sync.sum / min(raop_sync.count, raop_sync.win);
-
-			// wait till we have enough data or there is a strong deviation
-			if ((raop_sync.count >= raop_sync.win && abs(error) > 10) || (raop_sync.count >= SYNC_WIN_CHECK && abs(error) > 100)) {
-				if (error < 0) {
-					output.skip_frames = -(error * RAOP_SAMPLE_RATE) / 1000;
-					output.state = OUTPUT_SKIP_FRAMES;					
-					LOG_INFO("skipping %u frames (count:%d)", output.skip_frames, raop_sync.count);
-				} else {
-					output.pause_frames = (error * RAOP_SAMPLE_RATE) / 1000;
-					output.state = OUTPUT_PAUSE_FRAMES;
-					LOG_INFO("pausing for %u frames (count: %d)", output.pause_frames, raop_sync.count);
-				}
-				
-				raop_sync.sum = raop_sync.count = 0;
-				memset(raop_sync.errors, 0, sizeof(raop_sync.errors));
-			}	
-			
-			// move to normal mode if possible			
-			if (raop_sync.win == 1) {
-				raop_sync.win = SYNC_WIN_FAST;
-				LOG_INFO("backend played %u, desired %u, (delta:%d)", ms, raop_sync.playtime - now, error);
-			} else if (raop_sync.win == SYNC_WIN_FAST && raop_sync.count >= SYNC_WIN_FAST && abs(error) < 10) {
-				raop_sync.win = SYNC_WIN_SLOW;
-				LOG_INFO("switching to slow sync mode %u", raop_sync.win);
-			}	
-
+		case RAOP_TIMING:
+			_sink_sync(&raop_sync, RAOP_SAMPLE_RATE);
 			break;
-		}
 		case RAOP_SETUP: {
 			uint8_t **buffer = va_arg(args, uint8_t**);
 			size_t *size = va_arg(args, size_t*);
@@ -296,11 +360,10 @@ static bool raop_sink_cmd_handler(raop_event_t event, va_list args)
 		case RAOP_STREAM:
 			LOG_INFO("Stream", NULL);
 			raop_state = event;
-			raop_sync.win = 1;
-			raop_sync.sum = raop_sync.count = 0;
-			memset(raop_sync.errors, 0, sizeof(raop_sync.errors));
+			_sink_sync_reset(&raop_sync);
 			raop_sync.enabled = !strcasestr(output.device, "BT");
 			output.next_sample_rate = output.current_sample_rate = RAOP_SAMPLE_RATE;
+			_multiroom_flush(false);
 			break;
         case RAOP_STALLED:
 		case RAOP_STOP:
@@ -314,6 +377,7 @@ static bool raop_sink_cmd_handler(raop_event_t event, va_list args)
 			sink_state = SINK_ABORT;
 			output.frames_played = 0;
 			output.stop_time = gettime_ms();
+			_multiroom_flush(event != RAOP_FLUSH);
 			break;
 		case RAOP_PLAY: {
 			LOG_INFO("Play", NULL);
@@ -352,6 +416,29 @@ static uint32_t cspot_sink_data_handler(const uint8_t *data, uint32_t len) {
     return sink_data_handler(data, len, 0);
 }    
 
+/****************************************************************************************
+ * cspot output timeline handler (called by output thread with outputbuf locked)
+ */
+static struct {
+	bool started, ended;
+	u32_t when;
+} cspot_timeline;
+
+static void cspot_mark_handler(output_mark_e type, u32_t data, u32_t when) {
+	if (type == OUTPUT_MARK_TRACK) {
+		cspot_timeline.started = true;
+		cspot_timeline.when = when;
+	} else if (type == OUTPUT_MARK_EOS) {
+		cspot_timeline.ended = true;
+	}	
+}
+
+static void _cspot_flush(void) {
+	_buf_flush(outputbuf);
+	_output_flush_marks();
+	memset(&cspot_timeline, 0, sizeof(cspot_timeline));
+}
+
 /****************************************************************************************
  * cspot sink command handler
  */
@@ -377,17 +464,19 @@ static bool cspot_cmd_handler(cspot_event_t cmd, va_list args)
         output.threshold = 25;
 		output.state = OUTPUT_STOPPED;
         sink_state = SINK_ABORT;
-		_buf_flush(outputbuf);
+		_cspot_flush();
         _buf_limit(outputbuf, 0);
 		if (decode.state != DECODE_STOPPED) decode.state = DECODE_ERROR;
+		_multiroom_flush(false);
 		LOG_INFO("CSpot start track");
 		break;
 	case CSPOT_DISC:
-		_buf_flush(outputbuf);
+		_cspot_flush();
 		sink_state = SINK_ABORT;
 		output.external = 0;
 		output.state = OUTPUT_STOPPED;
 		output.stop_time = gettime_ms();
+		_multiroom_flush(true);
 		LOG_INFO("CSpot disconnected");
 		break;
 	case CSPOT_PLAY:
@@ -396,34 +485,44 @@ static bool cspot_cmd_handler(cspot_event_t cmd, va_list args)
 		LOG_INFO("CSpot play");
 		break;
 	case CSPOT_SEEK:
-		_buf_flush(outputbuf);		
+		_cspot_flush();
 		sink_state = SINK_ABORT;
+		_multiroom_flush(false);
 		LOG_INFO("CSpot seek by %d", va_arg(args, uint32_t));
 		break;
 	case CSPOT_FLUSH:
-		_buf_flush(outputbuf);
+		_cspot_flush();
 		sink_state = SINK_DISCARD;
 		output.state = OUTPUT_STOPPED;
+		_multiroom_flush(false);
 		LOG_INFO("CSpot flush");	
 		break;		
 	case CSPOT_PAUSE:		
 		output.state = OUTPUT_STOPPED;
 		output.stop_time = gettime_ms();
+		_multiroom_flush(false);
 		LOG_INFO("CSpot pause");
 		break;
     case CSPOT_TRACK_MARK:
-        output.track_start = outputbuf->writep;
+        _output_mark(OUTPUT_MARK_TRACK, 0, cspot_mark_handler);
+        break;
+    case CSPOT_END_MARK:
+        _output_mark(OUTPUT_MARK_EOS, 0, cspot_mark_handler);
         break;
     case CSPOT_QUERY_REMAINING: {
         uint32_t *remaining = va_arg(args, uint32_t*);
-        *remaining = (_buf_used(outputbuf) * 1000) / (output.current_sample_rate * BYTES_PER_FRAME);
+        // include what is queued in device, not just outputbuf 
+        *remaining = cspot_timeline.ended ? 0 : ((u64_t) _output_pending_frames() * 1000) / output.current_sample_rate;
         break;      
     }
     case CSPOT_QUERY_STARTED: {
         uint32_t *started = va_arg(args, uint32_t*);
-        *started = output.track_started;
+        uint32_t *elapsed = va_arg(args, uint32_t*);
+        *started = cspot_timeline.started;
+        // how long ago track's first frame has left the DAC
+        *elapsed = cspot_timeline.started ? gettime_ms() - cspot_timeline.when : 0;
         // this is a read_and_clear event
-        output.track_started = false;
+        cspot_timeline.started = false;
         break;      
     }
 	case CSPOT_VOLUME: {
@@ -444,6 +543,87 @@ static bool cspot_cmd_handler(cspot_event_t cmd, va_list args)
 }
 #endif
 
+/****************************************************************************************
+ * multiroom follower data handler
+ */
+static void multiroom_data_handler(const uint8_t *data, uint32_t len, u32_t playtime) {
+	mr_sync.playtime = playtime;
+	mr_sync.len = len;
+
+	sink_data_handler(data, len, 10);
+}
+
+/****************************************************************************************
+ * multiroom command handler
+ */
+static bool multiroom_cmd_handler(multiroom_event_t event, va_list args)
+{
+	// a leader only keeps its own output on the timeline it publishes
+	if (multiroom_leader()) {
+		LOCK_O;
+		if (event == MULTIROOM_TIMING && (output.external == DECODE_BT || output.external == DECODE_CSPOT)) {
+			_sink_sync(&mr_sync, output.current_sample_rate);
+		}
+		UNLOCK_O;
+		return true;
+	}
+
+	// don't LOCK_O as there is always a chance that LMS takes control later anyway
+	if (output.external != DECODE_MULTIROOM && (event != MULTIROOM_START || output.state > OUTPUT_STOPPED)) {
+		if (event == MULTIROOM_START) LOG_WARN("Cannot use multiroom while LMS/BT/AirPlay/CSpot are controlling player %d", output.external);
+		return false;
+	}
+
+	LOCK_D;
+	LOCK_O;
+
+	switch (event) {
+	case MULTIROOM_START:
+		output.next_sample_rate = output.current_sample_rate = va_arg(args, u32_t);
+		output.external = DECODE_MULTIROOM;
+		output.frames_played = 0;
+		output.state = OUTPUT_STOPPED;
+		sink_state = SINK_ABORT;
+		_buf_flush(outputbuf);
+		_buf_limit(outputbuf, 0);
+		_sink_sync_reset(&mr_sync);
+		if (decode.state != DECODE_STOPPED) decode.state = DECODE_ERROR;
+		LOG_INFO("Multiroom start at %u", output.current_sample_rate);
+		break;
+	case MULTIROOM_PLAY:
+		output.state = OUTPUT_START_AT;
+		output.start_at = mr_sync.start_time = va_arg(args, u32_t);
+		LOG_INFO("Multiroom starting at %u (in %d ms)", output.start_at, output.start_at - gettime_ms());
+		break;
+	case MULTIROOM_FLUSH:
+		_buf_flush(outputbuf);
+		sink_state = SINK_ABORT;
+		output.state = OUTPUT_STOPPED;
+		output.frames_played = 0;
+		_sink_sync_reset(&mr_sync);
+		LOG_INFO("Multiroom flush");
+		break;
+	case MULTIROOM_STOP:
+		_buf_flush(outputbuf);
+		sink_state = SINK_ABORT;
+		output.external = 0;
+		if (output.state > OUTPUT_STOPPED) output.state = OUTPUT_STOPPED;
+		output.stop_time = gettime_ms();
+		LOG_INFO("Multiroom stop");
+		break;
+	case MULTIROOM_TIMING:
+		_sink_sync(&mr_sync, output.current_sample_rate);
+		break;
+	default:
+		break;
+	}
+
+	UNLOCK_O;
+	UNLOCK_D;
+
+	return true;
+}
+
 /****************************************************************************************
  * We provide the generic codec register option
  */
@@ -481,6 +661,12 @@ void register_external(void) {
 		}	
 	}	
 #endif	
+
+	if ((p = config_alloc_get(NVS_TYPE_STR, "multiroom")) != NULL) {
+		mr_sync.enabled = !strcasestr(output.device, "BT");
+		enable_multiroom = multiroom_init(p, multiroom_cmd_handler, multiroom_data_handler);
+		free(p);
+	}
 }
 
 void deregister_external(void) {
@@ -503,6 +689,11 @@ void deregister_external(void) {
 		cspot_sink_deinit();
 	}
 #endif
+
+	if (enable_multiroom) {
+		LOG_INFO("Stopping multiroom");
+		multiroom_deinit();
+	}
 }
 
 void decode_restore(int external) {
@@ -522,5 +713,8 @@ void decode_restore(int external) {
 		cspot_disconnect();
 		break;
 #endif			
+	case DECODE_MULTIROOM:
+		multiroom_disconnect();
+		break;
 	}
 }
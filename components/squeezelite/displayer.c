@@ -17,6 +17,7 @@
 #include "gds_draw.h"
 #include "gds_image.h"
 #include "led_vu.h"
+#include "topology.h"
 
 #pragma pack(push, 1)
 
@@ -205,6 +206,11 @@ static EXT_RAM_ATTR struct {
 		int width;
 		bool active;
 	} back;		
+	// what each VU currently has in framebuffer (level < 0 means unknown)
+	struct vu_s {
+		int level, x, y, width;
+		bool rotate;
+	} vu[2];
 } visu;
 
 static uint8_t* led_data;
@@ -221,7 +227,6 @@ static EXT_RAM_ATTR struct {
 	struct bar_s bars[MAX_BARS] ;
 } led_visu;
 
-static EXT_RAM_ATTR uint8_t vu_bitmap[VU_WIDTH * VU_HEIGHT];
 extern const uint8_t vu_base[] asm("_binary_vu_s_data_start");
 extern const struct {
 	uint8_t offset;
@@ -260,6 +265,7 @@ static void visu_handler(u8_t *data, int len);
 static void ledv_handler(u8_t *data, int len);
 static void ledd_handler(u8_t *data, int len);
 static void displayer_task(void* arg);
+static void vu_invalidate(void);
 
 /* scrolling undocumented information
 	grfs	
@@ -333,18 +339,18 @@ bool sb_displayer_init(void) {
 		displayer.width = GDS_GetWidth(display);
 		displayer.height = min(GDS_GetHeight(display), SB_HEIGHT);
 	
-		// allocate gray-color mapping if needed;
+		// gray to native color mapping, so that VU does not convert every pixel
+		grayMap = malloc(256*sizeof(*grayMap));
 		if (GDS_GetMode(display) > GDS_GRAYSCALE) {
-			grayMap = malloc(256*sizeof(*grayMap));
 			for (int i = 0; i < 256; i++) grayMap[i] = GDS_GrayMap(display, i);
+		} else {
+			for (int i = 0; i < 256; i++) grayMap[i] = i >> (8 - GDS_GetDepth(display));
 		}
 	
 		// create visu configuration
 		visu.bar_gap = 1;
 		visu.back.frame = calloc(1, (displayer.width * displayer.height) / 8);
-		
-		// prepare the VU raw data in PSRAM
-		memcpy(vu_bitmap, vu_base, sizeof(vu_bitmap));
+		vu_invalidate();
 		
 		// size scroller (width + current screen)
 		scroller.scroll.max = (displayer.width * displayer.height / 8) * (15 + 1);
@@ -370,7 +376,9 @@ bool sb_displayer_init(void) {
 		
 	// create displayer management task
 	displayer.mutex = xSemaphoreCreateMutex();
-	displayer.task = xTaskCreateStatic( (TaskFunction_t) displayer_task, "sb_displayer", SCROLL_STACK_SIZE, NULL, ESP_TASK_PRIO_MIN + 1, xStack, &xTaskBuffer);
+	displayer.task = xTaskCreateStaticPinnedToCore( (TaskFunction_t) displayer_task, "sb_displayer", SCROLL_STACK_SIZE, NULL, 
+													topology_priority("sb_displayer", ESP_TASK_PRIO_MIN + 1), xStack, &xTaskBuffer,
+													topology_core("sb_displayer", tskNO_AFFINITY));
 	
 	// chain handlers
 	slimp_handler_chain = slimp_handler;
@@ -399,6 +407,7 @@ static bool display_bus_handler(void *from, enum display_bus_cmd_e cmd) {
 		break;
 	case DISPLAY_BUS_GIVE:
 		displayer.owned = true;
+		vu_invalidate();
 		break;
 	}
 	
@@ -462,6 +471,7 @@ static void server(in_addr_t ip, u16_t hport, u16_t cport) {
 	sprintf(msg, "%s:%hu", inet_ntoa(ip), hport);
 	if (display && displayer.owned) GDS_TextPos(display, GDS_FONT_LINE_1, GDS_TEXT_CENTERED, GDS_TEXT_CLEAR | GDS_TEXT_UPDATE, msg);
 	displayer.dirty = true;
+	vu_invalidate();
 	
 	xSemaphoreGive(displayer.mutex);
 		
@@ -570,6 +580,7 @@ static void show_display_buffer(char *ddram) {
 
 	GDS_TextLine(display, 1, GDS_TEXT_LEFT, GDS_TEXT_CLEAR, line1);	
 	GDS_TextLine(display, 2, GDS_TEXT_LEFT, GDS_TEXT_CLEAR | GDS_TEXT_UPDATE, line2);	
+	vu_invalidate();
 }
 
 /****************************************************************************************
@@ -619,16 +630,20 @@ static void vfdc_handler( u8_t *_data, int bytes_read) {
 	show_display_buffer(ddram);
 }
 
+/****************************************************************************************
+ * Forget what VU have drawn, something else wrote in their area
+ */
+static void vu_invalidate(void) {
+	visu.vu[0].level = visu.vu[1].level = -1;
+}
+
 /****************************************************************************************
  * Display VU-Meter (lots of hard-coding)
  */
-void draw_VU(struct GDS_Device * display, int level, int x, int y, int width, bool rotate) {
+static void draw_VU(struct GDS_Device * display, struct vu_s *vu, int level, int x, int y, int width, bool rotate) {
 	// VU data is by columns and vertical flip to allow block offset 
-	uint8_t *data = vu_bitmap;
-	int offset = level > 0 ? vu_arrow[level].offset * VU_HEIGHT : 0;
-
-	// place the arrow in base VU
-	memcpy(data + offset, vu_arrow[level].data, sizeof(vu_arrow[level].data));
+	int offset = level > 0 ? vu_arrow[level].offset : 0;
+	int from = 0, to = VU_WIDTH, skip = 0, last = -1;
 	
 	// adjust to current display window
 	if (width > VU_WIDTH) {
@@ -636,47 +651,44 @@ void draw_VU(struct GDS_Device * display, int level, int x, int y, int width, bo
 		else x += (width - VU_WIDTH) / 2;		
 		width = VU_WIDTH;
 	} else {
-		data += (VU_WIDTH - width) / 2 * VU_HEIGHT;	
+		skip = (VU_WIDTH - width) / 2;
 	}	
-
-	if (GDS_GetMode(display) <= GDS_GRAYSCALE) {
-		// this is 8 bits grayscale
-		int scale = 8 - GDS_GetDepth(display);
 	
+	// when framebuffer still has our previous frame, only redo columns of old and new arrow
+	if (vu->level >= 0 && vu->x == x && vu->y == y && vu->width == width && vu->rotate == rotate) {
+		if (vu->level == level) return;
+		last = vu->level > 0 ? vu_arrow[vu->level].offset : 0;
+		from = min(offset, last);
+		to = max(offset, last) + ARROW_WIDTH;
+	} 
+	
+	*vu = (struct vu_s) { level, x, y, width, rotate };
+	from = max(from, skip);
+	to = min(to, skip + width);
+	
+	for (int i = from; i < to; i++) {
+		const uint8_t *data;
+		int r = i - skip;
+		
+		// skip unchanged columns between old and new arrow
+		if (last >= 0 && (i < offset || i >= offset + ARROW_WIDTH) && (i < last || i >= last + ARROW_WIDTH)) continue;
+		
+		// place the arrow in base VU
+		if (i >= offset && i < offset + ARROW_WIDTH) data = vu_arrow[level].data + (i - offset) * VU_HEIGHT;
+		else data = vu_base + i * VU_HEIGHT;
+
 		// use "fast" version as we are not beyond screen boundaries
 		if (rotate) {
-			for (int r = 0; r < width; r++) {
-				for (int c = VU_HEIGHT; --c >= 0;) {
-					GDS_DrawPixelFast(display, c + x, r + y, *data++ >> scale);
-				}	
+			for (int c = VU_HEIGHT; --c >= 0;) {
+				GDS_DrawPixelFast(display, c + x, r + y, grayMap[*data++]);
 			}	
 		} else {
-			for (int r = 0; r < width; r++) {
-				for (int c = 0; c < VU_HEIGHT; c++) {
-					GDS_DrawPixelFast(display, r + x, c + y, *data++ >> scale);
-				}	
-			}			
-		}	
-	} else {
-		// use "fast" version as we are not beyond screen boundaries
-		if (rotate) {
-			for (int r = 0; r < width; r++) {
-				for (int c = VU_HEIGHT; --c >= 0;) {
-					GDS_DrawPixelFast(display, c + x, r + y, grayMap[*data++]);
-				}	
+			for (int c = 0; c < VU_HEIGHT; c++) {
+				GDS_DrawPixelFast(display, r + x, c + y, grayMap[*data++]);
 			}	
-		} else {
-			for (int r = 0; r < width; r++) {
-				for (int c = 0; c < VU_HEIGHT; c++) {
-					GDS_DrawPixelFast(display, r + x, c + y, grayMap[*data++]);
-				}	
-			}			
 		}	
 	}	
 	
-	// restore base VU
-	memcpy(vu_bitmap + offset, vu_base + offset, sizeof(vu_arrow[level].data));
-	
 	// need to manually set dirty flag as DrawPixel does not do it
 	GDS_SetDirty(display);
 }
@@ -726,6 +738,7 @@ static void grfe_handler( u8_t *data, int len) {
 		
 		GDS_DrawBitmapCBR(display, data + sizeof(struct grfe_packet), width, displayer.height, GDS_COLOR_WHITE);
 		GDS_Update(display);
+		vu_invalidate();
 	}	
 	
 	xSemaphoreGive(displayer.mutex);
@@ -843,6 +856,7 @@ static void grfg_handler(u8_t *data, int len) {
 	if (displayer.owned) {
 		GDS_DrawBitmapCBR(display, scroller.frame, scroller.back.width, displayer.height, GDS_COLOR_WHITE);
 		GDS_Update(display);
+		vu_invalidate();
 	}	
 		
 	// now we can active scrolling, but only if we are not on a small screen
@@ -877,7 +891,10 @@ static void grfa_handler(u8_t *data, int len) {
 			// this is just to specify artwork coordinates
 			artwork.x = htons(pkt->x);
 			artwork.y = htons(pkt->y);		
-		} else if (artwork.size) GDS_ClearWindow(display, artwork.x, artwork.y, -1, -1, GDS_COLOR_BLACK);
+		} else if (artwork.size) {
+			GDS_ClearWindow(display, artwork.x, artwork.y, -1, -1, GDS_COLOR_BLACK);
+			vu_invalidate();
+		}	
 		
 		artwork.full = artwork.enable && artwork.x == 0 && artwork.y == 0;
 		LOG_DEBUG("gfra en:%u x:%hu, y:%hu", artwork.enable, artwork.x, artwork.y);
@@ -891,6 +908,7 @@ static void grfa_handler(u8_t *data, int len) {
 		// same trick to clean current/previous window
 		if (artwork.size) {
 			GDS_ClearWindow(display, artwork.x, artwork.y, -1, -1, GDS_COLOR_BLACK);
+			vu_invalidate();
 			artwork.size = 0;
 		}
 		
@@ -909,6 +927,7 @@ static void grfa_handler(u8_t *data, int len) {
 		GDS_ClearWindow(display, artwork.x, artwork.y, -1, -1, GDS_COLOR_BLACK);
 		xSemaphoreTake(displayer.mutex, portMAX_DELAY);			
 		GDS_DrawJPEG(display, artwork.data, artwork.x, artwork.y, artwork.y < displayer.height ? (GDS_IMAGE_RIGHT | GDS_IMAGE_TOP) : GDS_IMAGE_CENTER);
+		vu_invalidate();
 		xSemaphoreGive(displayer.mutex);		
 		free(artwork.data);
 		artwork.data = NULL;
@@ -972,11 +991,15 @@ void visu_draw(void) {
 	// don't refresh screen if all max are 0 (we were are somewhat idle)
 	int clear = 0;
 	for (int i = visu.n; --i >= 0;) clear = max(clear, visu.bars[i].max);
-	if (clear) GDS_ClearExt(display, false, false, visu.col, visu.row, visu.col + visu.width - 1, visu.row + visu.height - 1);
+	if (clear) {
+		GDS_ClearExt(display, false, false, visu.col, visu.row, visu.col + visu.width - 1, visu.row + visu.height - 1);
+		vu_invalidate();
+	}	
 	
 	// draw background if we are in screensaver mode
 	if (!(visu.mode & VISU_ESP32) && visu.back.active) {
 		GDS_DrawBitmapCBR(display, visu.back.frame, visu.back.width, displayer.height, GDS_COLOR_WHITE);
+		vu_invalidate();
 	}	
 
 	if ((visu.mode & ~VISU_ESP32) != VISU_VUMETER || !visu.style) {
@@ -1012,15 +1035,15 @@ void visu_draw(void) {
 		}
 	} else if (displayer.width / 2 >=  3 * VU_WIDTH / 4) {
 		if (visu.rotate) {
-			draw_VU(display, visu.bars[0].current, 0, visu.row, visu.height / 2, visu.rotate);
-			draw_VU(display, visu.bars[1].current, 0, visu.row + visu.height / 2, visu.height / 2, visu.rotate);
+			draw_VU(display, visu.vu + 0, visu.bars[0].current, 0, visu.row, visu.height / 2, visu.rotate);
+			draw_VU(display, visu.vu + 1, visu.bars[1].current, 0, visu.row + visu.height / 2, visu.height / 2, visu.rotate);
 		} else {
-			draw_VU(display, visu.bars[0].current, 0, visu.row, visu.width / 2, visu.rotate);
-			draw_VU(display, visu.bars[1].current, visu.width / 2, visu.row, visu.width / 2, visu.rotate);
+			draw_VU(display, visu.vu + 0, visu.bars[0].current, 0, visu.row, visu.width / 2, visu.rotate);
+			draw_VU(display, visu.vu + 1, visu.bars[1].current, visu.width / 2, visu.row, visu.width / 2, visu.rotate);
 		}
 	} else {
 		int level = (visu.bars[0].current + visu.bars[1].current) / 2;
-		draw_VU(display, level, 0, visu.row, visu.rotate ? visu.height : visu.width, visu.rotate);		
+		draw_VU(display, visu.vu + 0, level, 0, visu.row, visu.rotate ? visu.height : visu.width, visu.rotate);		
 	}	
 }	
 
@@ -1168,6 +1191,7 @@ static void visu_handler( u8_t *data, int len) {
 	
 	xSemaphoreTake(displayer.mutex, portMAX_DELAY);
 	visu.mode = pkt->which;
+	vu_invalidate();
 	
 	// little trick to clean the taller screens when switching visu 
 	if (visu.row >= displayer.height) GDS_ClearExt(display, false, true, visu.col, visu.row, visu.col + visu.width - 1, visu.row + visu.height - 1);
@@ -1363,7 +1387,10 @@ static void displayer_task(void *args) {
 				memcpy(scroller.frame, scroller.back.frame, scroller.back.width * displayer.height / 8);
 				for (int i = 0; i < scroller.width * displayer.height / 8; i++) scroller.frame[i] |= scroller.scroll.frame[scroller.scrolled * displayer.height / 8 + i];
 				scroller.scrolled += scroller.by;
-				if (displayer.owned) GDS_DrawBitmapCBR(display, scroller.frame, scroller.width, displayer.height, GDS_COLOR_WHITE);	
+				if (displayer.owned) {
+					GDS_DrawBitmapCBR(display, scroller.frame, scroller.width, displayer.height, GDS_COLOR_WHITE);	
+					vu_invalidate();
+				}	
 				
 				// short sleep & don't need background update
 				scroller.wake = scroller.speed;
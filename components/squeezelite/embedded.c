@@ -21,6 +21,7 @@
 #include "messaging.h"
 #include "gpio_exp.h"
 #include "accessors.h"
+#include "topology.h"
 
 #ifndef CONFIG_POWER_GPIO_LEVEL
 #define CONFIG_POWER_GPIO_LEVEL 1
@@ -76,6 +77,8 @@ int	pthread_create_name(pthread_t *thread, _CONST pthread_attr_t  *attr,
 	esp_pthread_cfg_t cfg = esp_pthread_get_default_config(); 
 	cfg.thread_name = name; 
 	cfg.inherit_cfg = true; 
+	cfg.pin_to_core = topology_core(name, cfg.pin_to_core);
+	cfg.prio = topology_priority(name, cfg.prio);
 	esp_pthread_set_cfg(&cfg); 
 	return pthread_create(thread, attr, start_routine, arg);
 }
@@ -130,6 +133,38 @@ u16_t get_battery(void) {
 	return (u16_t) (battery_value_svc() * 128) & 0x0fff;
 }	 
 
+bool get_last_server(in_addr_t *ip, u16_t *hport, u16_t *cport) {
+	char *last = config_alloc_get(NVS_TYPE_STR, "lms_last");
+	unsigned a, b, c, d, h, p;
+	bool found = false;
+
+	if (!last) return false;
+
+	if (sscanf(last, "%u.%u.%u.%u:%u:%u", &a, &b, &c, &d, &h, &p) == 6) {
+		*ip = htonl((a << 24) | (b << 16) | (c << 8) | d);
+		*hport = h;
+		*cport = p;
+		found = *ip != 0;
+	}
+
+	free(last);
+	return found;
+}
+
+void set_last_server(in_addr_t ip, u16_t hport, u16_t cport) {
+	char *last = config_alloc_get(NVS_TYPE_STR, "lms_last");
+	char value[32];
+	u32_t addr = ntohl(ip);
+
+	snprintf(value, sizeof(value), "%u.%u.%u.%u:%hu:%hu", (addr >> 24) & 0xff, (addr >> 16) & 0xff,
+			 (addr >> 8) & 0xff, addr & 0xff, hport, cport);
+
+	// avoid wearing flash when we reconnect to the same server
+	if (!last || strcmp(last, value)) config_set_value(NVS_TYPE_STR, "lms_last", value);
+
+	free(last);
+}
+
 void set_name(char *name) {
 	char *cmd = config_alloc_get(NVS_TYPE_STR, "autoexec1");
 	char *p, *q;
@@ -30,10 +30,16 @@ typedef unsigned long long u64_t;
 #define _CONST
 #endif
 
+#if USE_SSL
+// a resumed HTTPS stream does its TLS handshake in stream thread
+#define STREAM_THREAD_STACK_SIZE 12 * 1024
+#else
 #define STREAM_THREAD_STACK_SIZE  4 * 1024
+#endif
 #define DECODE_THREAD_STACK_SIZE 14 * 1024
 #define OUTPUT_THREAD_STACK_SIZE  4 * 1024
 #define IR_THREAD_STACK_SIZE      4 * 1024
+#define MULTIROOM_THREAD_STACK_SIZE 4 * 1024
 
 // number of times the 5s search for a server will happen before slimproto exits (0 = no limit)
 #define MAX_SERVER_RETRIES	5
@@ -72,6 +78,8 @@ void 		register_external(void);
 void 		deregister_external(void);
 void 		decode_restore(int external);
 void        powering(bool on);
+bool		get_last_server(in_addr_t *ip, u16_t *hport, u16_t *cport);
+void		set_last_server(in_addr_t ip, u16_t hport, u16_t cport);
 // used when other client wants to use slimproto socket to send messages
 extern mutex_type slimp_mutex;
 #define LOCK_P   mutex_lock(slimp_mutex)
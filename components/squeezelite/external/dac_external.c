@@ -29,7 +29,7 @@ static bool init(char *config, int i2c_port_num, i2s_config_t *i2s_config, bool
 
 static bool i2c_json_execute(char *set);
 
-const struct adac_s dac_external = { "i2s", init, adac_deinit, power, speaker, headset, volume };
+const struct adac_s dac_external = { "i2s", init, adac_deinit, power, speaker, headset, volume, false };
 static cJSON *i2c_json;
 static int i2c_addr;
 
@@ -115,8 +115,8 @@ static void usage(const char *argv0) {
 		   "  \t\t\t phase_response = 0-100 (0 = minimum / 50 = linear / 100 = maximum)\n"
 #endif
 #if RESAMPLE16
-		   "  -R -u [params]\tResample, params = (b|l|m)[:i],\n" 
-		   "   \t\t\t b = basic linear interpolation, l = 13 taps, m = 21 taps, i = interpolate filter coefficients\n"
+		   "  -R -u [params]\tResample, params = (b|l|m|h),\n" 
+		   "   \t\t\t b = basic linear interpolation, l = 8 taps, m = 16 taps, h = 32 taps polyphase\n"
 #endif
 #if DSD
 #if ALSA
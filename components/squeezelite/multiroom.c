@@ -0,0 +1,528 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#include "squeezelite.h"
+#include "platform_config.h"
+#include "multiroom.h"
+#if EMBEDDED
+#include "esp_timer.h"
+#endif
+
+/*
+ A leader re-publishes what external sinks (BT, AirPlay, Spotify) write in outputbuf as
+ 16 bits stereo PCM over UDP multicast. Each datagram carries the index of its first
+ frame in the session and the time (leader's µs clock) when that frame hits the DAC.
+ Followers estimate the leader's clock NTP-style using unicast request/response on
+ port + 1 (keeping the offset of the fastest of the last exchanges), convert timestamps
+ to their own clock and then use the same output skip/pause correction as AirPlay.
+ Lost datagrams are replaced by silence so that frames keep their position.
+ All fields are big-endian, PCM is sent as-is (little-endian)
+*/
+
+#define MR_GROUP		"239.255.87.75"
+#define MR_PORT			8775
+#define MR_LATENCY		500		// ms from publication to play, when source does not set it
+#define MR_MARGIN		100		// ms, minimum advance of a block over its playtime
+#define MR_FRAMES		360		// frames per datagram so that it fits a 1500 bytes MTU
+#define MR_HEADER		28
+#define MR_TIMING_LEN	32
+#define MR_TIMEOUT		2000	// ms without audio before follower stops
+#define MR_GAP			1000	// ms of missing frames that are filled with silence
+#define MR_SAMPLES		8		// clock offset sliding window
+#define MR_MAGIC		0x534c4d52
+
+enum { MR_AUDIO = 1, MR_FLUSH, MR_STOP, MR_TIMING_REQ, MR_TIMING_RSP };
+
+static EXT_RAM_ATTR struct {
+	bool running, leader;
+	int sock, control;
+	pthread_t thread;
+	mutex_type mutex;
+	struct sockaddr_in group, peer;
+	multiroom_cmd_vcb_t cmd_cb;
+	multiroom_data_cb_t data_cb;
+	u32_t latency, rate, last;
+	u16_t session;
+	u64_t frame;
+	struct {
+		bool anchored;
+		u64_t time, frame;
+	} anchor;
+	struct {
+		bool started, playing, ignore, disconnect;
+		u16_t session, ignored;
+		u64_t frame;
+	} rx;
+	struct {
+		bool synced;
+		int count;
+		s64_t offset, offsets[MR_SAMPLES], rtts[MR_SAMPLES];
+		u64_t t1;
+		u32_t next;
+	} clock;
+	u8_t packet[MR_HEADER + MR_FRAMES * 4];
+} mr;
+
+static u8_t silence[MR_FRAMES * 4];
+
+extern log_level loglevel;
+
+/****************************************************************************************
+ * Wire and clock helpers
+ */
+static void put32(u8_t *p, u32_t v) {
+	p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+static void put64(u8_t *p, u64_t v) {
+	put32(p, v >> 32); put32(p + 4, v);
+}
+
+static u32_t get32(const u8_t *p) {
+	return ((u32_t) p[0] << 24) | ((u32_t) p[1] << 16) | ((u32_t) p[2] << 8) | p[3];
+}
+
+static u64_t get64(const u8_t *p) {
+	return ((u64_t) get32(p) << 32) | get32(p + 4);
+}
+
+static void put_header(u8_t *p, u8_t type, u16_t session) {
+	put32(p, MR_MAGIC);
+	p[4] = type; p[5] = 0;
+	p[6] = session >> 8; p[7] = session;
+}
+
+static u64_t gettime_us(void) {
+#if EMBEDDED
+	return esp_timer_get_time();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+static bool cmd(multiroom_event_t event, ...) {
+	va_list args;
+	va_start(args, event);
+	bool res = mr.cmd_cb(event, args);
+	va_end(args);
+	return res;
+}
+
+/****************************************************************************************
+ * Leader: send datagrams, assigning a timeline when source did not provide one
+ */
+bool multiroom_leader(void) {
+	return mr.running && mr.leader;
+}
+
+uint32_t multiroom_publish(const uint8_t *data, uint32_t len, uint32_t rate, uint32_t earliest, uint32_t playtime) {
+	if (!multiroom_leader() || !rate) return playtime ? playtime : earliest;
+
+	u64_t now = gettime_us(), when, frame;
+	u32_t frames = len / 4;
+	u16_t session;
+
+	mutex_lock(mr.mutex);
+
+	if (rate != mr.rate) {
+		mr.session++;
+		mr.rate = rate;
+		mr.frame = 0;
+		mr.anchor.anchored = false;
+	}
+
+	if (playtime) {
+		when = now + (s64_t) (s32_t) (playtime - (u32_t) (now / 1000)) * 1000;
+	} else {
+		when = mr.anchor.time + (mr.frame - mr.anchor.frame) * 1000000 / rate;
+
+		// (re)start timeline when source has underrun or after a flush
+		if (!mr.anchor.anchored || when < now + MR_MARGIN * 1000) {
+			u64_t start = now + (s64_t) (s32_t) (earliest - (u32_t) (now / 1000)) * 1000;
+			mr.anchor.time = when = start > now + mr.latency * 1000 ? start : now + mr.latency * 1000;
+			mr.anchor.frame = mr.frame;
+			mr.anchor.anchored = true;
+			LOG_INFO("[%p]: session %hu timeline at frame " FMT_u64 ", due in %d ms", &mr, mr.session, mr.frame, (int) ((when - now) / 1000));
+		}
+	}
+
+	// reserve frames on the timeline, then send without holding the lock
+	session = mr.session;
+	frame = mr.frame;
+	mr.frame += frames;
+	mr.last = now / 1000;
+
+	mutex_unlock(mr.mutex);
+
+	// only the active sink publishes, so packet is not shared while sending
+	for (u32_t i = 0; i < frames && session == mr.session; i += MR_FRAMES) {
+		u32_t n = min(frames - i, MR_FRAMES);
+
+		put_header(mr.packet, MR_AUDIO, session);
+		put32(mr.packet + 8, rate);
+		put64(mr.packet + 12, frame + i);
+		put64(mr.packet + 20, when + (u64_t) i * 1000000 / rate);
+		memcpy(mr.packet + MR_HEADER, data + i * 4, n * 4);
+
+		if (sendto(mr.control, mr.packet, MR_HEADER + n * 4, 0, (struct sockaddr*) &mr.group, sizeof(mr.group)) < 0) {
+			LOG_SDEBUG("[%p]: can't send frame " FMT_u64 " (%d)", &mr, frame + i, last_error());
+		}
+	}
+
+	return when / 1000;
+}
+
+static void leader_control(u8_t type) {
+	u8_t packet[8];
+
+	if (!multiroom_leader()) return;
+
+	mutex_lock(mr.mutex);
+
+	// next audio will be a new session, starting at frame 0
+	mr.session++;
+	mr.frame = 0;
+	mr.anchor.anchored = false;
+	if (type == MR_STOP) mr.rate = 0;
+
+	// these are not acknowledged, so send twice (followers also detect new session and timeout)
+	put_header(packet, type, mr.session);
+
+	mutex_unlock(mr.mutex);
+
+	for (int i = 0; i < 2; i++) sendto(mr.control, packet, sizeof(packet), 0, (struct sockaddr*) &mr.group, sizeof(mr.group));
+}
+
+void multiroom_flush(void) {
+	leader_control(MR_FLUSH);
+}
+
+void multiroom_stop(void) {
+	leader_control(MR_STOP);
+}
+
+static void *leader_thread(void *arg) {
+	u8_t buf[MR_TIMING_LEN];
+	u32_t timing = gettime_ms();
+
+	while (mr.running) {
+		struct timeval timeout = { 0, 100 * 1000 };
+		fd_set rfds;
+
+		FD_ZERO(&rfds);
+		FD_SET(mr.control, &rfds);
+
+		if (select(mr.control + 1, &rfds, NULL, NULL, &timeout) > 0) {
+			struct sockaddr_in addr;
+			socklen_t addrlen = sizeof(addr);
+			int n = recvfrom(mr.control, (void*) buf, sizeof(buf), 0, (struct sockaddr*) &addr, &addrlen);
+			u64_t t2 = gettime_us();
+
+			// answer with our receive and send time, t1 is echoed back
+			if (n == MR_TIMING_LEN && get32(buf) == MR_MAGIC && buf[4] == MR_TIMING_REQ) {
+				buf[4] = MR_TIMING_RSP;
+				put64(buf + 16, t2);
+				put64(buf + 24, gettime_us());
+				sendto(mr.control, buf, MR_TIMING_LEN, 0, (struct sockaddr*) &addr, addrlen);
+			}
+		}
+
+		// let leader verify its own output against the timeline while it publishes
+		u32_t now = gettime_ms();
+		if (now - timing >= 1000) {
+			timing = now;
+			if (now - mr.last < 1000) cmd(MULTIROOM_TIMING);
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************************
+ * Follower: leader clock estimation
+ */
+static void follower_clock(const u8_t *buf, int n) {
+	u64_t t4 = gettime_us(), t1, t2, t3;
+
+	if (n != MR_TIMING_LEN || get32(buf) != MR_MAGIC || buf[4] != MR_TIMING_RSP) return;
+
+	// only accept the answer to the latest request
+	t1 = get64(buf + 8);
+	if (t1 != mr.clock.t1) return;
+
+	t2 = get64(buf + 16);
+	t3 = get64(buf + 24);
+
+	int i = mr.clock.count++ % MR_SAMPLES;
+	mr.clock.rtts[i] = (s64_t) (t4 - t1) - (s64_t) (t3 - t2);
+	mr.clock.offsets[i] = ((s64_t) (t2 - t1) + (s64_t) (t3 - t4)) / 2;
+
+	// exchange with shortest round-trip is the least affected by queuing
+	int best = 0;
+	for (i = 1; i < min(mr.clock.count, MR_SAMPLES); i++) if (mr.clock.rtts[i] < mr.clock.rtts[best]) best = i;
+	mr.clock.offset = mr.clock.offsets[best];
+
+	if (!mr.clock.synced) LOG_INFO("[%p]: leader clock offset %d us (rtt %d us)", &mr, (int) mr.clock.offset, (int) mr.clock.rtts[best]);
+	mr.clock.synced = true;
+
+	LOG_DEBUG("[%p]: clock offset %d us (best rtt %d us)", &mr, (int) mr.clock.offset, (int) mr.clock.rtts[best]);
+}
+
+/****************************************************************************************
+ * Follower: audio and session handling
+ */
+static void follower_audio(const u8_t *buf, int n, u32_t now) {
+	u16_t session = (buf[6] << 8) | buf[7];
+	u32_t rate = get32(buf + 8), len = (n - MR_HEADER) & ~3;
+	u64_t frame = get64(buf + 12);
+	u32_t playtime = (get64(buf + 20) - mr.clock.offset) / 1000;
+
+	if (!rate || (mr.rx.ignore && session == mr.rx.ignored)) return;
+
+	// new session (or rate), take over output
+	if (!mr.rx.started || session != mr.rx.session) {
+		if (!cmd(MULTIROOM_START, rate)) {
+			mr.rx.ignore = true;
+			mr.rx.ignored = session;
+			return;
+		}
+		mr.rx.started = true;
+		mr.rx.playing = false;
+		mr.rx.ignore = false;
+		mr.rx.session = session;
+	}
+
+	// too much lost, restart session
+	if (mr.rx.playing && frame > mr.rx.frame + (u64_t) rate * MR_GAP / 1000) {
+		LOG_WARN("[%p]: lost " FMT_u64 " frames, restarting", &mr, frame - mr.rx.frame);
+		cmd(MULTIROOM_FLUSH);
+		mr.rx.playing = false;
+	}
+
+	// start playing from a block that is not already due
+	if (!mr.rx.playing) {
+		if ((s32_t) (playtime - now) < MR_MARGIN) return;
+		cmd(MULTIROOM_PLAY, playtime);
+		mr.rx.playing = true;
+		mr.rx.frame = frame;
+	}
+
+	// duplicated or too late
+	if (frame < mr.rx.frame) return;
+
+	// lost frames are replaced by silence so that following ones stay in place
+	if (frame > mr.rx.frame) LOG_DEBUG("[%p]: filling %u frames", &mr, (u32_t) (frame - mr.rx.frame));
+	while (mr.rx.frame < frame) {
+		u32_t count = min(frame - mr.rx.frame, MR_FRAMES);
+		mr.data_cb(silence, count * 4, playtime - (u32_t) ((frame - mr.rx.frame) * 1000 / rate));
+		mr.rx.frame += count;
+	}
+
+	mr.data_cb(buf + MR_HEADER, len, playtime);
+	mr.rx.frame = frame + len / 4;
+}
+
+static void follower_packet(const u8_t *buf, int n, struct sockaddr_in *addr) {
+	u32_t now = gettime_ms();
+
+	if (n < 8 || get32(buf) != MR_MAGIC) return;
+
+	// datagrams are sent from leader's control port, so that's where to ask for time
+	if (addr->sin_addr.s_addr != mr.peer.sin_addr.s_addr || addr->sin_port != mr.peer.sin_port) {
+		LOG_INFO("[%p]: leader is %s:%hu", &mr, inet_ntoa(addr->sin_addr), ntohs(addr->sin_port));
+		mr.peer = *addr;
+		mr.clock.synced = false;
+		mr.clock.count = 0;
+		mr.clock.next = now;
+	}
+
+	switch (buf[4]) {
+	case MR_AUDIO:
+		mr.last = now;
+		// can't place audio on our timeline until we know leader's clock
+		if (n > MR_HEADER && mr.clock.synced) follower_audio(buf, n, now);
+		break;
+	case MR_FLUSH:
+		if (mr.rx.started && mr.rx.playing) {
+			cmd(MULTIROOM_FLUSH);
+			mr.rx.playing = false;
+		}
+		break;
+	case MR_STOP:
+		if (mr.rx.started) {
+			cmd(MULTIROOM_STOP);
+			mr.rx.started = mr.rx.playing = false;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void *follower_thread(void *arg) {
+	u32_t timing = gettime_ms();
+
+	while (mr.running) {
+		struct timeval timeout = { 0, 50 * 1000 };
+		struct sockaddr_in addr;
+		socklen_t addrlen = sizeof(addr);
+		fd_set rfds;
+		u32_t now;
+
+		FD_ZERO(&rfds);
+		FD_SET(mr.sock, &rfds);
+		FD_SET(mr.control, &rfds);
+
+		if (select((mr.sock > mr.control ? mr.sock : mr.control) + 1, &rfds, NULL, NULL, &timeout) > 0) {
+			if (FD_ISSET(mr.control, &rfds)) {
+				int n = recvfrom(mr.control, (void*) mr.packet, sizeof(mr.packet), 0, (struct sockaddr*) &addr, &addrlen);
+				follower_clock(mr.packet, n);
+			}
+			if (FD_ISSET(mr.sock, &rfds)) {
+				addrlen = sizeof(addr);
+				int n = recvfrom(mr.sock, (void*) mr.packet, sizeof(mr.packet), 0, (struct sockaddr*) &addr, &addrlen);
+				follower_packet(mr.packet, n, &addr);
+			}
+		}
+
+		now = gettime_ms();
+
+		// player has been taken by LMS
+		if (mr.rx.disconnect) {
+			mr.rx.disconnect = false;
+			mr.rx.ignore = mr.rx.started;
+			mr.rx.ignored = mr.rx.session;
+			mr.rx.started = mr.rx.playing = false;
+		}
+
+		// leader is gone
+		if (mr.rx.started && now - mr.last > MR_TIMEOUT) {
+			LOG_INFO("[%p]: no audio from leader for %u ms", &mr, now - mr.last);
+			cmd(MULTIROOM_STOP);
+			mr.rx.started = mr.rx.playing = false;
+		}
+
+		// ask leader's time, quickly at first then every second
+		if (mr.peer.sin_port && (s32_t) (now - mr.clock.next) >= 0) {
+			u8_t req[MR_TIMING_LEN] = { 0 };
+			put_header(req, MR_TIMING_REQ, 0);
+			put64(req + 8, mr.clock.t1 = gettime_us());
+			sendto(mr.control, req, MR_TIMING_LEN, 0, (struct sockaddr*) &mr.peer, sizeof(mr.peer));
+			mr.clock.next = now + (mr.clock.count < MR_SAMPLES ? 100 : 1000);
+		}
+
+		if (mr.rx.playing && now - timing >= 1000) {
+			timing = now;
+			cmd(MULTIROOM_TIMING);
+		}
+	}
+
+	return NULL;
+}
+
+void multiroom_disconnect(void) {
+	if (mr.running && !mr.leader) mr.rx.disconnect = true;
+}
+
+/****************************************************************************************
+ * Init / deinit
+ */
+bool multiroom_init(const char *config, multiroom_cmd_vcb_t cmd_cb, multiroom_data_cb_t data_cb) {
+	char role[16] = "", group[32] = MR_GROUP;
+	int port = MR_PORT, latency = MR_LATENCY;
+	struct sockaddr_in addr = { 0 };
+
+	if (!config || !*config) return false;
+
+	PARSE_PARAM_STR(config, "role", '=', role, 15);
+	PARSE_PARAM_STR(config, "group", '=', group, 31);
+	PARSE_PARAM(config, "port", '=', port);
+	PARSE_PARAM(config, "latency", '=', latency);
+
+	if (strcasecmp(role, "leader") && strcasecmp(role, "follower")) {
+		LOG_ERROR("unknown multiroom role %s", role);
+		return false;
+	}
+
+	memset(&mr, 0, sizeof(mr));
+	mr.leader = !strcasecmp(role, "leader");
+	mr.latency = latency;
+	mr.cmd_cb = cmd_cb;
+	mr.data_cb = data_cb;
+	mr.sock = -1;
+
+	mr.group.sin_family = AF_INET;
+	mr.group.sin_addr.s_addr = inet_addr(group);
+	mr.group.sin_port = htons(port);
+
+	// leader sends and answers time requests on port + 1, followers use any port for that
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = mr.leader ? htons(port + 1) : 0;
+
+	mr.control = socket(AF_INET, SOCK_DGRAM, 0);
+	if (mr.control < 0 || bind(mr.control, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+		LOG_ERROR("can't bind multiroom control port (%d)", last_error());
+		if (mr.control >= 0) closesocket(mr.control);
+		return false;
+	}
+
+	if (mr.leader) {
+		u8_t ttl = 1, loop = 1;
+		setsockopt(mr.control, IPPROTO_IP, IP_MULTICAST_TTL, (void*) &ttl, sizeof(ttl));
+		// followers may run on the same host
+		setsockopt(mr.control, IPPROTO_IP, IP_MULTICAST_LOOP, (void*) &loop, sizeof(loop));
+	} else {
+		struct ip_mreq mreq = { 0 };
+		int on = 1;
+
+		mr.sock = socket(AF_INET, SOCK_DGRAM, 0);
+		setsockopt(mr.sock, SOL_SOCKET, SO_REUSEADDR, (void*) &on, sizeof(on));
+
+		addr.sin_port = htons(port);
+		mreq.imr_multiaddr = mr.group.sin_addr;
+		mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+		if (bind(mr.sock, (struct sockaddr*) &addr, sizeof(addr)) < 0 ||
+			setsockopt(mr.sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (void*) &mreq, sizeof(mreq)) < 0) {
+			LOG_ERROR("can't join multiroom group %s:%d (%d)", group, port, last_error());
+			closesocket(mr.sock);
+			closesocket(mr.control);
+			return false;
+		}
+	}
+
+	mutex_create(mr.mutex);
+	mr.running = true;
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, PTHREAD_STACK_MIN + MULTIROOM_THREAD_STACK_SIZE);
+	pthread_create_name(&mr.thread, &attr, mr.leader ? leader_thread : follower_thread, NULL, "multiroom");
+	pthread_attr_destroy(&attr);
+
+	LOG_INFO("multiroom %s on %s:%d (latency %d ms)", mr.leader ? "leader" : "follower", group, port, latency);
+
+	return true;
+}
+
+void multiroom_deinit(void) {
+	if (!mr.running) return;
+
+	multiroom_stop();
+	mr.running = false;
+	pthread_join(mr.thread, NULL);
+
+	if (mr.sock >= 0) closesocket(mr.sock);
+	closesocket(mr.control);
+	mutex_destroy(mr.mutex);
+}
@@ -0,0 +1,48 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#ifndef MULTIROOM_H
+#define MULTIROOM_H
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+typedef enum { MULTIROOM_START, MULTIROOM_PLAY, MULTIROOM_FLUSH, MULTIROOM_STOP, MULTIROOM_TIMING } multiroom_event_t;
+
+typedef bool (*multiroom_cmd_vcb_t)(multiroom_event_t event, va_list args);
+typedef void (*multiroom_data_cb_t)(const uint8_t *data, uint32_t len, uint32_t playtime);
+
+/**
+ * @brief	start leader or follower according to config "role=leader|follower,group=<ip>,port=<n>,latency=<ms>"
+ *			- a follower calls cmd_cb with START(rate), PLAY(start_at), FLUSH, STOP and TIMING and
+ *			  data_cb with 16 bits stereo PCM and the local time (ms) it shall be played at
+ *			- a leader only calls cmd_cb with TIMING while it publishes, so that its own output
+ *			  can be kept on the timeline it has given to followers
+ */
+bool multiroom_init(const char *config, multiroom_cmd_vcb_t cmd_cb, multiroom_data_cb_t data_cb);
+void multiroom_deinit(void);
+
+/**
+ * @brief	leader side: send 16 bits stereo PCM to followers. When playtime is not 0, it is the
+ *			local time (ms) when the block must be played, otherwise the leader builds its own
+ *			timeline, never earlier than 'earliest'. Returns local time the block is due
+ */
+bool multiroom_leader(void);
+uint32_t multiroom_publish(const uint8_t *data, uint32_t len, uint32_t rate, uint32_t earliest, uint32_t playtime);
+void multiroom_flush(void);
+void multiroom_stop(void);
+
+/**
+ * @brief	follower side: ignore current session (a new one will be played)
+ */
+void multiroom_disconnect(void);
+
+#endif /* MULTIROOM_H */
@@ -0,0 +1,316 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#include "squeezelite.h"
+#include "oggdemux.h"
+
+/*
+ Pages are parsed where they sit in the buffer: only the header and lacing values are
+ copied and consumed, then packets are handed out from the buffer. A packet that spans
+ pages, wraps around the buffer or is not fully received yet is assembled progressively
+ so that the buffer is always drained (the decoder thread would spin otherwise).
+ Zero-copy packets stay in the buffer until released, which is safe without holding
+ the buffer's mutex as the writer only uses free space and a flush can only happen
+ once the decoder is stopped. CRC is only verified when looking for sync, as a capture
+ pattern at the expected place is proof enough otherwise
+*/
+
+#define OGG_MAX_PACKET	(128 * 1024)
+
+// MSB-first CRC-32 (poly 0x04c11db7) nibble table
+static const u32_t crc_table[16] = {
+	0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005,
+	0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61, 0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd,
+};
+
+extern log_level loglevel;
+
+/****************************************************************************************
+ * Helpers (buffer locked)
+ */
+static u32_t crc_update(u32_t crc, const u8_t *p, size_t len) {
+	while (len--) {
+		crc = (crc << 4) ^ crc_table[(crc >> 28) ^ (*p >> 4)];
+		crc = (crc << 4) ^ crc_table[(crc >> 28) ^ (*p++ & 0x0f)];
+	}
+	return crc;
+}
+
+static u32_t le32(const u8_t *p) {
+	return p[0] | (u32_t) p[1] << 8 | (u32_t) p[2] << 16 | (u32_t) p[3] << 24;
+}
+
+static u8_t *_buf_at(struct buffer *buf, size_t offset) {
+	u8_t *p = buf->readp + offset;
+	return p >= buf->wrap ? p - buf->size : p;
+}
+
+static void _buf_peek(struct buffer *buf, size_t offset, u8_t *dst, size_t len) {
+	u8_t *p = _buf_at(buf, offset);
+	size_t n = min(len, (size_t) (buf->wrap - p));
+	memcpy(dst, p, n);
+	memcpy(dst + n, buf->buf, len - n);
+}
+
+static u32_t _buf_crc(struct buffer *buf, size_t offset, size_t len, u32_t crc) {
+	u8_t *p = _buf_at(buf, offset);
+	size_t n = min(len, (size_t) (buf->wrap - p));
+	crc = crc_update(crc, p, n);
+	return crc_update(crc, buf->buf, len - n);
+}
+
+static void _resync(struct ogg_demux *d, struct buffer *buf) {
+	// skip at least one byte then go to next possible capture pattern
+	_buf_inc_readp(buf, 1);
+	d->lost++;
+
+	size_t n = _buf_cont_read(buf);
+	u8_t *p = memchr(buf->readp, 'O', n);
+	if (p) n = p - buf->readp;
+
+	_buf_inc_readp(buf, n);
+	d->lost += n;
+	d->synced = false;
+}
+
+/****************************************************************************************
+ * Get next page header, skipping pages from other logical streams
+ */
+static int _read_page(struct ogg_demux *d, struct buffer *buf) {
+	u8_t *header = d->page.header;
+
+	while (1) {
+		size_t used = _buf_used(buf), body = 0, size;
+		int segments;
+
+		if (used < OGG_HEADER_SIZE) return 0;
+
+		_buf_peek(buf, 0, header, OGG_HEADER_SIZE);
+		if (memcmp(header, "OggS", 4) || header[4]) {
+			_resync(d, buf);
+			continue;
+		}
+
+		segments = header[26];
+		size = OGG_HEADER_SIZE + segments;
+		if (used < size) return 0;
+
+		_buf_peek(buf, OGG_HEADER_SIZE, header + OGG_HEADER_SIZE, segments);
+		for (int i = 0; i < segments; i++) body += header[OGG_HEADER_SIZE + i];
+
+		// when we are searching, the pattern could just be in some packet's data
+		if (!d->synced) {
+			u8_t crc[4] = { 0 };
+			if (used < size + body) return 0;
+
+			u32_t value = crc_update(0, header, 22);
+			value = crc_update(value, crc, 4);
+			value = crc_update(value, header + 26, size - 26);
+			value = _buf_crc(buf, size, body, value);
+
+			if (value != le32(header + 22)) {
+				_resync(d, buf);
+				continue;
+			}
+
+			if (d->lost) LOG_WARN("[%p]: sync found after %u bytes", d, d->lost);
+			d->synced = true;
+			d->lost = 0;
+		}
+
+		u32_t serial = le32(header + 14);
+		u8_t flags = header[5];
+
+		// new logical stream, either first or chained, but only of the type we want
+		if (flags & 0x02) {
+			if (used < size + d->magic_len) return 0;
+
+			u8_t magic[16];
+			_buf_peek(buf, size, magic, d->magic_len);
+
+			if (segments && header[OGG_HEADER_SIZE] >= d->magic_len && !memcmp(magic, d->magic, d->magic_len)) {
+				LOG_INFO("[%p]: new logical stream %x (was %x)", d, serial, d->serial);
+				d->serial = serial;
+				d->active = d->bos = true;
+				d->fill = 0;
+				d->discard = d->partial = false;
+			}
+		}
+
+		_buf_inc_readp(buf, size);
+
+		// ignore pages of other logical streams (caller skips body)
+		if (!d->active || serial != d->serial) {
+			d->skip = body;
+			d->page.segments = d->page.segment = 0;
+			return 1;
+		}
+
+		if (flags & 0x01) {
+			// continuation of a packet we don't have (sync, seek or start)
+			if (!d->partial) d->discard = d->partial = true;
+		} else if (d->partial) {
+			// previous packet never ended
+			LOG_WARN("[%p]: incomplete packet dropped (%u bytes)", d, (unsigned) d->fill);
+			d->fill = 0;
+			d->discard = d->partial = false;
+		}
+
+		// granule position belongs to the last packet that ends in that page
+		for (d->page.last = segments; d->page.last && header[OGG_HEADER_SIZE + d->page.last - 1] == 255; d->page.last--);
+
+		d->page.segments = segments;
+		d->page.segment = 0;
+		d->page.granule = (s64_t) ((u64_t) le32(header + 10) << 32 | le32(header + 6));
+		d->page.eos = flags & 0x04;
+		d->offset = 0;
+
+		return 1;
+	}
+}
+
+/****************************************************************************************
+ * Get next packet
+ */
+int _ogg_demux_packet(struct ogg_demux *d, struct buffer *buf, struct ogg_demux_packet *packet, bool skip) {
+	// in case caller did not release previous packet
+	_ogg_demux_release(d, buf);
+
+	while (1) {
+		size_t len = 0, n;
+		bool complete = false, inplace = false;
+		int i;
+
+		// page we don't want
+		if (d->skip) {
+			n = min(d->skip, _buf_cont_read(buf));
+			if (!n) return 0;
+			_buf_inc_readp(buf, n);
+			d->skip -= n;
+			continue;
+		}
+
+		if (d->page.segment == d->page.segments) {
+			if (!_read_page(d, buf)) return 0;
+			continue;
+		}
+
+		// span of current packet in this page (what has been already taken is excluded)
+		for (i = d->page.segment; i < d->page.segments;) {
+			u8_t lacing = d->page.header[OGG_HEADER_SIZE + i++];
+			len += lacing;
+			if (lacing < 255) {
+				complete = true;
+				break;
+			}
+		}
+
+		len -= d->offset;
+
+		// first packet of a logical stream is never skipped
+		if ((skip && !d->bos) || d->discard) {
+			// discard without storing, as data comes
+			n = min(len, _buf_cont_read(buf));
+			_buf_inc_readp(buf, n);
+			d->offset += n;
+			if (n < len) {
+				if (!n) return 0;
+				continue;
+			}
+		} else if (!d->partial && !d->offset && complete && _buf_used(buf) >= len && buf->readp + len <= buf->wrap) {
+			// zero-copy when it's all here and contiguous
+			inplace = true;
+			d->pending = len;
+			packet->data = buf->readp;
+			packet->bytes = len;
+		} else {
+			// spans pages or wraps, so it must be assembled
+			if (d->fill + len > d->size) {
+				u8_t *p = NULL;
+				if (d->fill + len <= OGG_MAX_PACKET) p = realloc(d->buffer, d->fill + len);
+				if (!p) {
+					LOG_WARN("[%p]: can't assemble packet of %u bytes", d, (unsigned) (d->fill + len));
+					d->fill = 0;
+					d->discard = true;
+					continue;
+				}
+				d->buffer = p;
+				d->size = d->fill + len;
+			}
+
+			n = min(len, _buf_cont_read(buf));
+			memcpy(d->buffer + d->fill, buf->readp, n);
+			_buf_inc_readp(buf, n);
+			d->fill += n;
+			d->offset += n;
+			if (n < len) {
+				if (!n) return 0;
+				continue;
+			}
+		}
+
+		// done with this piece of packet
+		d->page.segment = i;
+		d->offset = 0;
+		d->partial = !complete;
+
+		if (!complete) continue;
+
+		if (d->discard) {
+			d->discard = false;
+			continue;
+		}
+
+		if (skip && !d->bos) {
+			packet->data = NULL;
+			packet->bytes = 0;
+		} else if (!inplace) {
+			packet->data = d->buffer;
+			packet->bytes = d->fill;
+			d->fill = 0;
+		}
+
+		packet->bos = d->bos;
+		packet->eos = d->page.eos && i == d->page.last;
+		packet->granule = i == d->page.last ? d->page.granule : -1;
+		d->bos = false;
+
+		return 1;
+	}
+}
+
+/****************************************************************************************
+ * Release packet's data
+ */
+void _ogg_demux_release(struct ogg_demux *d, struct buffer *buf) {
+	if (!d->pending) return;
+	_buf_inc_readp(buf, d->pending);
+	d->pending = 0;
+}
+
+/****************************************************************************************
+ * Init / close
+ */
+void ogg_demux_init(struct ogg_demux *d, const char *magic, size_t magic_len) {
+	u8_t *buffer = d->buffer;
+	size_t size = d->size;
+
+	// keep assembly buffer across streams
+	memset(d, 0, sizeof(struct ogg_demux));
+	d->buffer = buffer;
+	d->size = size;
+	d->magic = magic;
+	d->magic_len = min(magic_len, 16);
+}
+
+void ogg_demux_close(struct ogg_demux *d) {
+	free(d->buffer);
+	memset(d, 0, sizeof(struct ogg_demux));
+}
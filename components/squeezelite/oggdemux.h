@@ -0,0 +1,54 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#ifndef OGGDEMUX_H
+#define OGGDEMUX_H
+
+#define OGG_HEADER_SIZE	27
+
+struct ogg_demux {
+	struct {
+		u8_t header[OGG_HEADER_SIZE + 255];
+		int segments, segment, last;
+		s64_t granule;
+		bool eos;
+	} page;
+	const char *magic;
+	size_t magic_len;
+	u32_t serial;
+	bool active, synced, bos, partial, discard;
+	// page bytes to discard, bytes of current piece already taken, bytes to release
+	size_t skip, offset, pending;
+	u8_t *buffer;
+	size_t fill, size;
+	u32_t lost;
+};
+
+struct ogg_demux_packet {
+	u8_t *data;
+	size_t bytes;
+	bool bos, eos;
+	s64_t granule;
+};
+
+/* 	Ogg demuxer reading pages in-place from a struct buffer. Packets that sit in one page
+	and don't wrap point directly into the buffer and must be released once used, others
+	are assembled in an internal buffer. Only the logical stream whose first packet starts
+	with 'magic' is followed and a new one (chained) has packet's bos set. When 'skip' is
+	set, the next packet is discarded while it is read and returned with no data, unless
+	it is the first of a logical stream.
+	_ogg_demux_packet returns 1 when a packet is available, 0 when it needs more data
+	(which means end of data if stream has ended) and must be called with buffer locked */
+void 	ogg_demux_init(struct ogg_demux *d, const char *magic, size_t magic_len);
+void 	ogg_demux_close(struct ogg_demux *d);
+int 	_ogg_demux_packet(struct ogg_demux *d, struct buffer *buf, struct ogg_demux_packet *packet, bool skip);
+void 	_ogg_demux_release(struct ogg_demux *d, struct buffer *buf);
+
+#endif
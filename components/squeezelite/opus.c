@@ -37,18 +37,16 @@
 #define ALIGN(n) 	(n << 16)		
 #endif
 
-#include <ogg/ogg.h>
 #include <opus.h>
+#include "oggdemux.h"
 
 // opus maximum output frames is 120ms @ 48kHz
 #define MAX_OPUS_FRAMES 5760
 
 struct opus {
-	enum { OGG_ID_HEADER, OGG_COMMENT_HEADER } status;
-	ogg_stream_state state;
-	ogg_packet packet;
-	ogg_sync_state sync;
-	ogg_page page;
+	enum { OGG_ID_HEADER, OGG_COMMENT_HEADER, OGG_AUDIO_DATA } status;
+	struct ogg_demux demux;
+	struct ogg_demux_packet packet;
 	OpusDecoder* decoder;
 	int rate, gain, pre_skip;
 	size_t overframes;
@@ -57,24 +55,6 @@ struct opus {
 };
 
 #if !LINKALL
-static struct {
-	void *handle;
-	int (*ogg_stream_init)(ogg_stream_state* os, int serialno);
-	int (*ogg_stream_clear)(ogg_stream_state* os);
-	int (*ogg_stream_reset)(ogg_stream_state* os);
-	int (*ogg_stream_eos)(ogg_stream_state* os);
-	int (*ogg_stream_reset_serialno)(ogg_stream_state* os, int serialno);
-	int (*ogg_sync_clear)(ogg_sync_state* oy);
-	void (*ogg_packet_clear)(ogg_packet* op);
-	char* (*ogg_sync_buffer)(ogg_sync_state* oy, long size);
-	int (*ogg_sync_wrote)(ogg_sync_state* oy, long bytes);
-	long (*ogg_sync_pageseek)(ogg_sync_state* oy, ogg_page* og);
-	int (*ogg_sync_pageout)(ogg_sync_state* oy, ogg_page* og);
-	int (*ogg_stream_pagein)(ogg_stream_state* os, ogg_page* og);
-	int (*ogg_stream_packetout)(ogg_stream_state* os, ogg_packet* op);
-	int (*ogg_page_packets)(const ogg_page* og);
-} go;
-
 static struct {
 	void* handle;
 	OpusDecoder* (*opus_decoder_create)(opus_int32 Fs, int channels, int* error);
@@ -111,10 +91,8 @@ extern struct processstate process;
 #endif
 
 #if LINKALL
-#define OG(h, fn, ...) (ogg_ ## fn)(__VA_ARGS__)
 #define OP(h, fn, ...) (opus_ ## fn)(__VA_ARGS__)
 #else
-#define OG(h, fn, ...) (h)->ogg_ ## fn(__VA_ARGS__)
 #define OP(h, fn, ...) (h)->opus_ ## fn(__VA_ARGS__)
 #endif
 
@@ -131,109 +109,69 @@ static opus_uint32 parse_uint32(const unsigned char* _data) {
 		(opus_uint32)_data[2] << 16 | (opus_uint32)_data[3] << 24;
 }
 
-static int get_audio_packet(void) {
-	int status, packet = -1;
+static bool opus_id_header(void) {
+	int status;
+	u8_t *data = u->packet.data;
 
-	LOCK_S;
-	size_t bytes = min(_buf_used(streambuf), _buf_cont_read(streambuf));
-
-	while (!(status = OG(&go, stream_packetout, &u->state, &u->packet)) && bytes) {
+	// make sure this is a valid packet
+	if (u->packet.bytes < 19 || memcmp(data, "OpusHead", 8)) {
+		LOG_ERROR("wrong header packet (size:%u)", u->packet.bytes);
+		return false;
+	}
 
-		// if sync_pageout (or sync_pageseek) is not called here, sync buffers build up
-		while (!(status = OG(&go, sync_pageout, &u->sync, &u->page)) && bytes) {
-			size_t consumed = min(bytes, 4096);
-			char* buffer = OG(&go, sync_buffer, &u->sync, consumed);
-			memcpy(buffer, streambuf->readp, consumed);
-			OG(&go, sync_wrote, &u->sync, consumed);
+	u->status = OGG_COMMENT_HEADER;
+	u->channels = data[9];
+	u->pre_skip = parse_uint16(data + 10);
+	u->rate = parse_uint32(data + 12);
+	u->gain = parse_int16(data + 16);
 
-			_buf_inc_readp(streambuf, consumed);
-			bytes -= consumed;
-		}
+	// a chained stream needs a fresh decoder as well
+	if (u->decoder) OP(&gu, decoder_destroy, u->decoder);
+	u->decoder = OP(&gu, decoder_create, 48000, u->channels, &status);
 
-		// if we have a new page, put it in and reset serialno at BoS
-		if (status) {
-			OG(&go, stream_pagein, &u->state, &u->page);
-			if (OG(&go, page_bos, &u->page)) OG(&go, stream_reset_serialno, &u->state, OG(&go, page_serialno, &u->page));
-		}
+	if (!u->decoder || status != OPUS_OK) {
+		LOG_ERROR("can't create decoder %d (channels:%u)", status, u->channels);
+		return false;
 	}
 
-	/* discard header packets. With no packet, we return a negative value 
-	 * when there is really nothing more to proceed */
-	if (status > 0 && memcmp(u->packet.packet, "OpusHead", 8) && memcmp(u->packet.packet, "OpusTags", 8)) packet = status;
-	else if (stream.state > DISCONNECT || _buf_used(streambuf)) packet = 0;
-
-	UNLOCK_S;
-	return packet;
+	LOG_INFO("codec up and running");
+	return true;
 }
 
-static int read_opus_header(void) {
-	int done = 0;
-	bool fetch = true;
+static int get_opus_packet(bool audio) {
+	int packet = 0;
 
 	LOCK_S;
-	size_t bytes = min(_buf_used(streambuf), _buf_cont_read(streambuf));
-
-	while (bytes && !done) {
-		int status;
-
-		// get aligned to a page and ready to bring it in
-		do {
-			size_t consumed = min(bytes, 4096);
-
-			char* buffer = OG(&go, sync_buffer, &u->sync, consumed);
-			memcpy(buffer, streambuf->readp, consumed);
-			OG(&go, sync_wrote, &u->sync, consumed);
-
-			_buf_inc_readp(streambuf, consumed);
-			bytes -= consumed;
-
-			status = fetch ? OG(&go, sync_pageout, &u->sync, &u->page) :
-							 OG(&go, sync_pageseek, &u->sync, &u->page);
-		} while (bytes && status <= 0);
-
-		// nothing has been found and we have no more bytes, come back later
-		if (status <= 0) break;
-
-		// always set stream serialno if we have a new one (no multiplexed streams)
-		if (OG(&go, page_bos, &u->page)) OG(&go, stream_reset_serialno, &u->state, OG(&go, page_serialno, &u->page));
-
-		// bring new page in if we want it (otherwise we're just skipping)
-		if (fetch) OG(&go, stream_pagein, &u->state, &u->page);
-
-		// no need for a switch...case
-		if (u->status == OGG_ID_HEADER) {
-			// we need the id packet, get more pages if we don't
-			if (OG(&go, stream_packetout, &u->state, &u->packet) <= 0) continue;
-			
-			// make sure this is a valid packet
-			if (u->packet.bytes < 19 || memcmp(u->packet.packet, "OpusHead", 8)) {
-				LOG_ERROR("wrong header packet (size:%u)", u->packet.bytes);
-				done = -100;
-			} else {
-				u->status = OGG_COMMENT_HEADER;
-				u->channels = u->packet.packet[9];
-				u->pre_skip = parse_uint16(u->packet.packet + 10);
-				u->rate = parse_uint32(u->packet.packet + 12);
-				u->gain = parse_int16(u->packet.packet + 16);
-				u->decoder = OP(&gu, decoder_create, 48000, u->channels, &status);
-				fetch = false;
-				if (!u->decoder || status != OPUS_OK) {
-					LOG_ERROR("can't create decoder %d (channels:%u)", status, u->channels);
-				}
-				else {
-					LOG_INFO("codec up and running");
-				}
-			}
-		} else if (u->status == OGG_COMMENT_HEADER) {
-			// don't consume VorbisComment which could be a huge packet, just skip it
-			if (!OG(&go, page_packets, &u->page)) continue;
-            LOG_INFO("comment skipped successfully");
-			done = 1;
+	bool ended = stream.state <= DISCONNECT;
+
+	/* headers are processed here, even when we are looking for audio as streams can be
+	 * chained. VorbisComment could be a huge packet so it is skipped, not stored */
+	while (!packet && (audio || u->status != OGG_AUDIO_DATA) &&
+		   _ogg_demux_packet(&u->demux, streambuf, &u->packet, u->status == OGG_COMMENT_HEADER)) {
+
+		if (u->packet.bos) u->status = OGG_ID_HEADER;
+
+		switch (u->status) {
+		case OGG_ID_HEADER:
+			if (!opus_id_header()) packet = -100;
+			break;
+		case OGG_COMMENT_HEADER:
+			LOG_INFO("comment skipped successfully");
+			u->status = OGG_AUDIO_DATA;
+			break;
+		default:
+			packet = 1;
+			break;
 		}
 	}
 
+	/* when looking for headers, just say if we have them. Otherwise with no packet, we
+	 * return a negative value when there is really nothing more to proceed */
+	if (!audio && u->status == OGG_AUDIO_DATA) packet = 1;
+	else if (!packet && ended) packet = -1;
+
 	UNLOCK_S;
-	return done;
+	return packet;
 }
 
 static decode_state opus_decompress(void) {
@@ -241,7 +179,7 @@ static decode_state opus_decompress(void) {
 	u8_t *write_buf;
 
 	if (decode.new_stream) {      
-        int status = read_opus_header();
+        int status = get_opus_packet(false);
 
 		if (status == 0) {
             return DECODE_RUNNING;
@@ -285,10 +223,10 @@ static decode_state opus_decompress(void) {
 		memcpy(write_buf, u->overbuf, u->overframes * BYTES_PER_FRAME);
 		n = u->overframes;
 		u->overframes = 0;
-	} else if ((packet = get_audio_packet()) > 0) {
+	} else if ((packet = get_opus_packet(true)) > 0) {
 		if (frames < MAX_OPUS_FRAMES) {
 			// don't have enough contiguous space, use the overflow buffer
-			n = OP(&gu, decode, u->decoder, u->packet.packet, u->packet.bytes, (opus_int16*) u->overbuf, MAX_OPUS_FRAMES, 0);
+			n = OP(&gu, decode, u->decoder, u->packet.data, u->packet.bytes, (opus_int16*) u->overbuf, MAX_OPUS_FRAMES, 0);
 			if (n > 0) {
 				u->overframes = n - min(n, frames);
 				n = min(n, frames);
@@ -298,8 +236,13 @@ static decode_state opus_decompress(void) {
 		} else {
 			/* we just do one packet at a time, although we could loop on packets but that means locking the 
 			 * outputbuf and streambuf for maybe a long time while we process it all, so don't do that */
-			n = OP(&gu, decode, u->decoder, u->packet.packet, u->packet.bytes, (opus_int16*) write_buf, frames, 0);
+			n = OP(&gu, decode, u->decoder, u->packet.data, u->packet.bytes, (opus_int16*) write_buf, frames, 0);
 		}
+
+		// packet might still be in streambuf
+		LOCK_S;
+		_ogg_demux_release(&u->demux, streambuf);
+		UNLOCK_S;
 	} else if (!packet) {
 		UNLOCK_O_direct;
 		return DECODE_RUNNING;
@@ -374,9 +317,7 @@ static void opus_open(u8_t size, u8_t rate, u8_t chan, u8_t endianness) {
     u->status = OGG_ID_HEADER;
 	u->overframes = 0;
 
-    OG(&go, stream_clear, &u->state);	
-    OG(&go, sync_clear, &u->sync);
-    OG(&go, stream_init, &u->state, -1);    
+	ogg_demux_init(&u->demux, "OpusHead", 8);
 }
 
 static void opus_close(void) {  
@@ -385,9 +326,8 @@ static void opus_close(void) {
     
 	free(u->overbuf);
     u->overbuf = NULL;
-    
-    OG(&go, stream_clear, &u->state);
-    OG(&go, sync_clear, &u->sync);
+
+	ogg_demux_close(&u->demux);
 }
 
 static bool load_opus(void) {
@@ -400,27 +340,6 @@ static bool load_opus(void) {
 		return false;
 	}
 
-    void *g_handle = dlopen(LIBOGG, RTLD_NOW);    
-    if (!g_handle) {
-        dlclose(u_handle);
-		LOG_INFO("ogg dlerror: %s", dlerror());
-		return false;
-	}
-	
-	g_handle->ogg_stream_clear = dlsym(g_handle->handle, "ogg_stream_clear");
-	g_handle->ogg_stream_reset = dlsym(g_handle->handle, "ogg_stream_reset");
-	g_handle->ogg_stream_eos = dlsym(g_handle->handle, "ogg_stream_eos");
-	g_handle->ogg_stream_reset_serialno = dlsym(g_handle->handle, "ogg_stream_reset_serialno");
-	g_handle->ogg_sync_clear = dlsym(g_handle->handle, "ogg_sync_clear");
-	g_handle->ogg_packet_clear = dlsym(g_handle->handle, "ogg_packet_clear");
-	g_handle->ogg_sync_buffer = dlsym(g_handle->handle, "ogg_sync_buffer");
-	g_handle->ogg_sync_wrote = dlsym(g_handle->handle, "ogg_sync_wrote");
-	g_handle->ogg_sync_pageseek = dlsym(g_handle->handle, "ogg_sync_pageseek");
-	g_handle->ogg_sync_pageout = dlsym(g_handle->handle, "ogg_sync_pageout");
-	g_handle->ogg_stream_pagein = dlsym(g_handle->handle, "ogg_stream_pagein");
-	g_handle->ogg_stream_packetout = dlsym(g_handle->handle, "ogg_stream_packetout");
-	g_handle->ogg_page_packets = dlsym(g_handle->handle, "ogg_page_packets");
-    
 	u_handle->opus_decoder_create = dlsym(u_handle->handle, "opus_decoder_create");
 	u_handle->opus_decoder_destroy = dlsym(u_handle->handle, "opus_decoder_destroy");
 	u_handle->opus_decode = dlsym(u_handle->handle, "opus_decode");
@@ -41,8 +41,95 @@ bool user_rates = false;
 #define LOCK   mutex_lock(outputbuf->mutex)
 #define UNLOCK mutex_unlock(outputbuf->mutex)
 
+#define OUTPUT_MARKS	8
+
+/* 
+ Output timeline: markers are set at outputbuf's writep and are positioned in 
+ frames taken from outputbuf. Once output reaches them, they are re-positioned 
+ in frames sent to the device (including silence) and their callback runs when 
+ the DAC has played that frame, using device_frames estimated by the backend. 
+ A format marker sets the sample rate as soon as output reaches it, so that the
+ backend switches exactly at the first frame of the new format.
+ From <head> to <reached> markers wait for the DAC, then up to <tail> they are
+ still in outputbuf. Counters are free-running and compared by difference
+*/
+static struct {
+	struct output_mark_s {
+		output_mark_e type;
+		u32_t data;
+		u32_t frame;
+		output_mark_cb_t cb;
+	} list[OUTPUT_MARKS];
+	unsigned head, reached, tail;
+	u32_t taken, sent, sent_dmp;
+} marks;
+
 // functions starting _* are called with mutex locked
 
+bool _output_mark(output_mark_e type, u32_t data, output_mark_cb_t cb) {
+	if (marks.tail - marks.head >= OUTPUT_MARKS) {
+		LOG_WARN("output timeline full, can't set marker %u", type);
+		return false;
+	}
+
+	struct output_mark_s *mark = marks.list + marks.tail++ % OUTPUT_MARKS;
+	mark->type = type;
+	mark->data = data;
+	mark->cb = cb;
+	mark->frame = marks.taken + _buf_used(outputbuf) / BYTES_PER_FRAME;
+
+	LOG_DEBUG("marker %u (%u) set %u frames ahead", type, data, mark->frame - marks.taken);
+	return true;
+}
+
+void _output_flush_marks(void) {
+	// frames of a format change being flushed, it is effective now
+	for (; marks.reached != marks.tail; marks.reached++) {
+		struct output_mark_s *mark = marks.list + marks.reached % OUTPUT_MARKS;
+		if (mark->type == OUTPUT_MARK_FORMAT) output.current_sample_rate = mark->data;
+	}
+	marks.head = marks.tail;
+}
+
+frames_t _output_pending_frames(void) {
+	// frames in outputbuf and in device, minus what device played since backend's last update
+	s32_t device = marks.sent - marks.sent_dmp + output.device_frames - 
+	               (s32_t) ((gettime_ms() - output.updated) * output.current_sample_rate / 1000);
+	return _buf_used(outputbuf) / BYTES_PER_FRAME + (device > 0 ? device : 0);
+}
+
+static void _marks_played(void) {
+	// device_frames and updated have just been set by backend
+	u32_t dac = marks.sent - output.device_frames;
+	marks.sent_dmp = marks.sent;
+
+	while (marks.head != marks.reached) {
+		struct output_mark_s *mark = marks.list + marks.head % OUTPUT_MARKS;
+		s32_t late = dac - mark->frame;
+		if (late < 0) break;
+		marks.head++;
+		if (mark->cb) mark->cb(mark->type, mark->data, output.updated - (u32_t) ((u64_t) late * 1000 / output.current_sample_rate));
+	}
+}
+
+static frames_t _marks_reached(frames_t cont_frames, bool silence) {
+	// move markers that output has reached to device's timeline, then stop at the next one
+	while (marks.reached != marks.tail) {
+		struct output_mark_s *mark = marks.list + marks.reached % OUTPUT_MARKS;
+		s32_t ahead = mark->frame - marks.taken;
+		if (ahead > 0) return min(cont_frames, (frames_t) ahead);
+		// only end of stream is reached by silence, others wait for their first frame
+		if (silence && mark->type != OUTPUT_MARK_EOS) break;
+		if (mark->type == OUTPUT_MARK_FORMAT) {
+			LOG_INFO("format change reached, sample rate %u", mark->data);
+			output.current_sample_rate = mark->data;
+		}
+		mark->frame = marks.sent;
+		marks.reached++;
+	}
+	return cont_frames;
+}
+
 frames_t _output_frames(frames_t avail) {
 
 	frames_t frames, size;
@@ -59,6 +146,8 @@ frames_t _output_frames(frames_t avail) {
 	frames = _buf_used(outputbuf) / BYTES_PER_FRAME;
 	silence = false;
 
+	_marks_played();
+
 	// start when threshold met
 	if (output.state == OUTPUT_BUFFER && frames > output.threshold * output.next_sample_rate / 10 && frames > output.start_frames) {
 		output.state = OUTPUT_RUNNING;
@@ -73,6 +162,7 @@ frames_t _output_frames(frames_t avail) {
 			LOG_INFO("skip %u of %u frames", skip, output.skip_frames);
 			frames -= skip;
 			output.frames_played += skip;
+			marks.taken += skip;
 			while (skip > 0) {
 				frames_t cont_frames = min(skip, _buf_cont_read(outputbuf) / BYTES_PER_FRAME);
 				skip -= cont_frames;
@@ -201,6 +291,7 @@ frames_t _output_frames(frames_t avail) {
 						LOG_INFO("crossfade complete");
 						if (_buf_used(outputbuf) >= dur_f * BYTES_PER_FRAME) {
 							_buf_inc_readp(outputbuf, dur_f * BYTES_PER_FRAME);
+							marks.taken += dur_f;
 							LOG_INFO("skipped crossfaded start");
 						} else {
 							LOG_WARN("unable to skip crossfaded start");
@@ -253,6 +344,8 @@ frames_t _output_frames(frames_t avail) {
 			}
 		}
 		
+		if (marks.reached != marks.tail) cont_frames = _marks_reached(cont_frames, silence);
+
 		out_frames = !silence ? min(size, cont_frames) : size;
 		
 		IF_DSD(
@@ -271,12 +364,14 @@ frames_t _output_frames(frames_t avail) {
 		}
 
 		size -= out_frames;
+		marks.sent += out_frames;
 
 		_vis_export(outputbuf, &output, out_frames, silence);
 
 		if (!silence) {
 			_buf_inc_readp(outputbuf, out_frames * BYTES_PER_FRAME);
 			output.frames_played += out_frames;
+			marks.taken += out_frames;
 		}
 	}
 			
@@ -455,6 +550,7 @@ void output_flush(void) {
 		output.delay_active = false;
 	}
 	output.frames_played = 0;
+	_output_flush_marks();
 	UNLOCK;
 }
 
@@ -465,6 +561,11 @@ bool output_flush_streaming(void) {
 	if (output.track_start) {
 		outputbuf->writep = output.track_start;
 		output.track_start = NULL;
+		// forget markers that were beyond the new writep
+		while (marks.tail != marks.reached && 
+			   (s32_t) (marks.list[(marks.tail - 1) % OUTPUT_MARKS].frame - marks.taken) > (s32_t) (_buf_used(outputbuf) / BYTES_PER_FRAME)) {
+			marks.tail--;
+		}
 	}
 	UNLOCK;
 	return flushed;
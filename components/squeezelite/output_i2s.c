@@ -48,6 +48,7 @@ sure that using rate_delay would fix that
 #include "accessors.h"
 #include "equalizer.h"
 #include "globdefs.h"
+#include "topology.h"
 
 #define LOCK   mutex_lock(outputbuf->mutex)
 #define UNLOCK mutex_unlock(outputbuf->mutex)
@@ -150,10 +151,10 @@ static bool handler(u8_t *data, int len){
 			config_set_value(NVS_TYPE_STR, "jack_mutes_amp", jack_mutes_amp ? "y" : "n");		
 			
 			if (jack_mutes_amp && jack_inserted_svc()) {
-				adac->speaker(false);
+				adac_post(ADAC_CMD_SPEAKER, false, 0, NULL);
 				if (amp_control.gpio != -1) gpio_set_level_x(amp_control.gpio, !amp_control.active);
 			} else {
-				adac->speaker(true);
+				adac_post(ADAC_CMD_SPEAKER, true, 0, NULL);
 				if (amp_control.gpio != -1) gpio_set_level_x(amp_control.gpio, amp_control.active);
 			}	
 		}
@@ -176,12 +177,12 @@ static void jack_handler(bool inserted) {
 	// jack detection bounces a bit but that seems fine
 	if (jack_mutes_amp) {
 		LOG_INFO("switching amplifier %s", inserted ? "OFF" : "ON");
-		adac->speaker(!inserted);
+		adac_post(ADAC_CMD_SPEAKER, !inserted, 0, NULL);
 		if (amp_control.gpio != -1) gpio_set_level_x(amp_control.gpio, inserted ? !amp_control.active : amp_control.active);
 	}
 	
 	// activate headset
-	adac->headset(inserted);
+	adac_post(ADAC_CMD_HEADSET, inserted, 0, NULL);
 	
 	// and chain if any
 	if (jack_handler_chain) (jack_handler_chain)(inserted);
@@ -402,6 +403,9 @@ void output_init_i2s(log_level level, char *device, unsigned output_buf_size, ch
     equalizer_set_samplerate(output.current_sample_rate);
 	
 	adac->power(ADAC_STANDBY);
+	
+	// from now on, DAC commands are queued and never block caller
+	adac_control_init(adac);
 
 	jack_handler_chain = jack_handler_svc;
 	jack_handler_svc = jack_handler;
@@ -439,7 +443,8 @@ void output_init_i2s(log_level level, char *device, unsigned output_buf_size, ch
 		static DRAM_ATTR StaticTask_t xTaskBuffer __attribute__ ((aligned (4)));
 		static EXT_RAM_ATTR StackType_t xStack[OUTPUT_THREAD_STACK_SIZE] __attribute__ ((aligned (4)));
 		output_i2s_task = xTaskCreateStaticPinnedToCore( (TaskFunction_t) output_thread_i2s, "output_i2s", OUTPUT_THREAD_STACK_SIZE, 
-											  NULL, CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT + 10, xStack, &xTaskBuffer, 0 );
+											  NULL, topology_priority("output_i2s", CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT + 10), 
+											  xStack, &xTaskBuffer, topology_core("output_i2s", 0) );
 	}
 }
 
@@ -458,6 +463,7 @@ void output_close_i2s(void) {
 	
 	equalizer_close();
 	
+	adac_control_close();
 	adac->deinit();
 }
 
@@ -466,7 +472,11 @@ void output_close_i2s(void) {
  */
 bool output_volume_i2s(unsigned left, unsigned right) {
 	if (mute_control.gpio >= 0) gpio_set_level(mute_control.gpio, (left | right) ? !mute_control.active : mute_control.active);
-	return adac->volume(left, right);
+	
+	// DAC volume is queued and only the last value is written
+	if (adac->hw_volume) adac_post(ADAC_CMD_VOLUME, left, right, NULL);
+	
+	return adac->hw_volume;
 } 
 
 /****************************************************************************************
@@ -522,12 +532,12 @@ static void output_thread_i2s(void *arg) {
 				LOG_INFO("switching off amp GPIO %d", amp_control.gpio);
 			} else if (output.state == OUTPUT_STOPPED) {
                 i2s_idle_since = pdTICKS_TO_MS(xTaskGetTickCount());
-				adac->speaker(false);
+				adac_post(ADAC_CMD_SPEAKER, false, 0, NULL);
 				led_blink(LED_GREEN, 200, 1000);
 			} else if (output.state == OUTPUT_RUNNING) {
 				if (!jack_mutes_amp || !jack_inserted_svc()) {
 					if (amp_control.gpio != -1) gpio_set_level_x(amp_control.gpio, amp_control.active);
-					adac->speaker(true);
+					adac_post(ADAC_CMD_SPEAKER, true, 0, NULL);
 				}	
 				led_on(LED_GREEN);
 			}	
@@ -539,7 +549,7 @@ static void output_thread_i2s(void *arg) {
 			if (isI2SStarted) {
 				isI2SStarted = false;
 				i2s_stop(CONFIG_I2S_NUM);
-				adac->power(ADAC_STANDBY);
+				adac_post(ADAC_CMD_POWER, ADAC_STANDBY, 0, NULL);
 			}
 			usleep(100000);
 			continue;
@@ -585,7 +595,9 @@ static void output_thread_i2s(void *arg) {
 			LOG_INFO("Restarting I2S.");
 			i2s_zero_dma_buffer(CONFIG_I2S_NUM);
 			i2s_start(CONFIG_I2S_NUM);
-			adac->power(ADAC_ON);	
+			adac_post(ADAC_CMD_POWER, ADAC_ON, 0, NULL);	
+			// DAC must be powered and unmuted before the first samples are sent
+			if (!adac_flush(250)) LOG_WARN("DAC not ready in time");
             if (spdif.enabled) spdif_convert(NULL, 0, NULL);
 		} 
 
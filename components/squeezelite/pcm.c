@@ -74,6 +74,148 @@ static bool  limit;
 static u32_t audio_left;
 static u32_t bytes_per_frame;
 
+/*
+ * Sample format conversion kernels, one per (size, endianness, channels), selected 
+ * once per stream. Once iptr is 32 bits aligned (always for 8/16/32 bits, within 3 
+ * samples for 24 bits), input is read one word at a time, 4 samples every <size> 
+ * words. Head/tail and misaligned streams use the per-sample conversion below.
+ */
+typedef void (*pcm_kernel_t)(u8_t *iptr, OPTR_T *optr, frames_t frames);
+
+// read aligned word as little or big endian
+#if SL_LITTLE_ENDIAN
+#define WLE(p, i) 	((p)[i])
+#define WBE(p, i) 	__builtin_bswap32((p)[i])
+#else
+#define WLE(p, i) 	__builtin_bswap32((p)[i])
+#define WBE(p, i) 	((p)[i])
+#endif
+
+#define SWAP16(w)	((((w) >> 8) & 0x00ff00ff) | (((w) << 8) & 0xff00ff00))
+
+#if BYTES_PER_FRAME == 4
+#define S8(p)		((OPTR_T) (*(p) << 8))
+#define S16BE(p)	((OPTR_T) (*(p) << 8 | *((p)+1)))
+#define S16LE(p)	((OPTR_T) (*(p) | *((p)+1) << 8))
+#define S24BE(p)	S16BE(p)
+#define S24LE(p)	S16LE((p)+1)
+#define S32BE(p)	S16BE(p)
+#define S32LE(p)	S16LE((p)+2)
+
+#define W8(w, s)	{ u32_t w0 = WLE(w, 0); 								\
+					  s[0] = w0 << 8; s[1] = w0 & 0xff00; 					\
+					  s[2] = (w0 >> 8) & 0xff00; s[3] = (w0 >> 16) & 0xff00; }
+#define W16LE(w, s)	{ u32_t w0 = WLE(w, 0), w1 = WLE(w, 1);					\
+					  s[0] = w0; s[1] = w0 >> 16; s[2] = w1; s[3] = w1 >> 16; }
+#define W16BE(w, s)	{ u32_t w0 = SWAP16(WLE(w, 0)), w1 = SWAP16(WLE(w, 1));	\
+					  s[0] = w0; s[1] = w0 >> 16; s[2] = w1; s[3] = w1 >> 16; }
+#define W24LE(w, s)	{ u32_t w0 = WLE(w, 0), w1 = WLE(w, 1), w2 = WLE(w, 2);	\
+					  s[0] = w0 >> 8; s[1] = w1; 							\
+					  s[2] = w1 >> 24 | w2 << 8; s[3] = w2 >> 16; }
+#define W24BE(w, s)	{ u32_t w0 = WBE(w, 0), w1 = WBE(w, 1), w2 = WBE(w, 2);	\
+					  s[0] = w0 >> 16; s[1] = w0 << 8 | w1 >> 24; 			\
+					  s[2] = w1; s[3] = w2 >> 8; }
+#define W32LE(w, s)	{ s[0] = WLE(w, 0) >> 16; s[1] = WLE(w, 1) >> 16;		\
+					  s[2] = WLE(w, 2) >> 16; s[3] = WLE(w, 3) >> 16; }
+#define W32BE(w, s)	{ s[0] = WBE(w, 0) >> 16; s[1] = WBE(w, 1) >> 16;		\
+					  s[2] = WBE(w, 2) >> 16; s[3] = WBE(w, 3) >> 16; }
+#else
+#define S8(p)		((OPTR_T) *(p) << 24)
+#define S16BE(p)	((OPTR_T) *(p) << 24 | (OPTR_T) *((p)+1) << 16)
+#define S16LE(p)	((OPTR_T) *(p) << 16 | (OPTR_T) *((p)+1) << 24)
+#define S24BE(p)	((OPTR_T) *(p) << 24 | (OPTR_T) *((p)+1) << 16 | (OPTR_T) *((p)+2) << 8)
+#define S24LE(p)	((OPTR_T) *(p) << 8 | (OPTR_T) *((p)+1) << 16 | (OPTR_T) *((p)+2) << 24)
+#define S32BE(p)	((OPTR_T) *(p) << 24 | (OPTR_T) *((p)+1) << 16 | (OPTR_T) *((p)+2) << 8 | *((p)+3))
+#define S32LE(p)	((OPTR_T) *(p) | (OPTR_T) *((p)+1) << 8 | (OPTR_T) *((p)+2) << 16 | (OPTR_T) *((p)+3) << 24)
+
+#define W8(w, s)	{ u32_t w0 = WLE(w, 0); 								\
+					  s[0] = w0 << 24; s[1] = (w0 << 16) & 0xff000000;		\
+					  s[2] = (w0 << 8) & 0xff000000; s[3] = w0 & 0xff000000; }
+#define W16LE(w, s)	{ u32_t w0 = WLE(w, 0), w1 = WLE(w, 1);					\
+					  s[0] = w0 << 16; s[1] = w0 & 0xffff0000;				\
+					  s[2] = w1 << 16; s[3] = w1 & 0xffff0000; }
+#define W16BE(w, s)	{ u32_t w0 = SWAP16(WLE(w, 0)), w1 = SWAP16(WLE(w, 1));	\
+					  s[0] = w0 << 16; s[1] = w0 & 0xffff0000;				\
+					  s[2] = w1 << 16; s[3] = w1 & 0xffff0000; }
+#define W24LE(w, s)	{ u32_t w0 = WLE(w, 0), w1 = WLE(w, 1), w2 = WLE(w, 2);	\
+					  s[0] = w0 << 8; s[1] = ((w0 >> 16) & 0xff00) | w1 << 16;	\
+					  s[2] = ((w1 >> 8) & 0xffff00) | w2 << 24; 			\
+					  s[3] = w2 & 0xffffff00; }
+#define W24BE(w, s)	{ u32_t w0 = WBE(w, 0), w1 = WBE(w, 1), w2 = WBE(w, 2);	\
+					  s[0] = w0 & 0xffffff00; s[1] = w0 << 24 | ((w1 >> 8) & 0xffff00); \
+					  s[2] = w1 << 16 | ((w2 >> 16) & 0xff00); s[3] = w2 << 8; }
+#define W32LE(w, s)	{ s[0] = WLE(w, 0); s[1] = WLE(w, 1); s[2] = WLE(w, 2); s[3] = WLE(w, 3); }
+#define W32BE(w, s)	{ s[0] = WBE(w, 0); s[1] = WBE(w, 1); s[2] = WBE(w, 2); s[3] = WBE(w, 3); }
+#endif
+
+#define STORE_2(o, v)	{ *(o)++ = (v); }
+#define STORE_1(o, v)	{ OPTR_T _v = (v); *(o) = _v; *((o)+1) = _v; (o) += 2; }
+
+#define PCM_KERNEL(NAME, SIZE, CHANNELS, SAMPLE, WORDS)							\
+static void NAME(u8_t *iptr, OPTR_T *optr, frames_t frames) {					\
+	size_t count = frames * CHANNELS;											\
+	int head = 4;																\
+	while (count && ((uintptr_t) iptr & 0x03) && head--) {						\
+		STORE_##CHANNELS(optr, SAMPLE(iptr));									\
+		iptr += SIZE;															\
+		count--;																\
+	}																			\
+	if (!((uintptr_t) iptr & 0x03)) {											\
+		u32_t *wptr = (u32_t *) iptr;											\
+		OPTR_T s[4];															\
+		for (; count >= 4; count -= 4, wptr += SIZE) {							\
+			WORDS(wptr, s);														\
+			STORE_##CHANNELS(optr, s[0]); STORE_##CHANNELS(optr, s[1]);			\
+			STORE_##CHANNELS(optr, s[2]); STORE_##CHANNELS(optr, s[3]);			\
+		}																		\
+		iptr = (u8_t *) wptr;													\
+	}																			\
+	while (count--) {															\
+		STORE_##CHANNELS(optr, SAMPLE(iptr));									\
+		iptr += SIZE;															\
+	}																			\
+}
+
+PCM_KERNEL(pcm_8_2, 1, 2, S8, W8)
+PCM_KERNEL(pcm_8_1, 1, 1, S8, W8)
+PCM_KERNEL(pcm_16le_2, 2, 2, S16LE, W16LE)
+PCM_KERNEL(pcm_16le_1, 2, 1, S16LE, W16LE)
+PCM_KERNEL(pcm_16be_2, 2, 2, S16BE, W16BE)
+PCM_KERNEL(pcm_16be_1, 2, 1, S16BE, W16BE)
+PCM_KERNEL(pcm_24le_2, 3, 2, S24LE, W24LE)
+PCM_KERNEL(pcm_24le_1, 3, 1, S24LE, W24LE)
+PCM_KERNEL(pcm_24be_2, 3, 2, S24BE, W24BE)
+PCM_KERNEL(pcm_24be_1, 3, 1, S24BE, W24BE)
+PCM_KERNEL(pcm_32le_2, 4, 2, S32LE, W32LE)
+PCM_KERNEL(pcm_32le_1, 4, 1, S32LE, W32LE)
+PCM_KERNEL(pcm_32be_2, 4, 2, S32BE, W32BE)
+PCM_KERNEL(pcm_32be_1, 4, 1, S32BE, W32BE)
+
+// memcpy is still a win when input is already in output format (typical 16/16 case)
+static void pcm_copy(u8_t *iptr, OPTR_T *optr, frames_t frames) {
+	memcpy(optr, iptr, frames * BYTES_PER_FRAME);
+}
+
+// indexed by [sample_size - 1][bigendian][channels - 1]
+static pcm_kernel_t pcm_kernels[4][2][2] = {
+	{ { pcm_8_1, pcm_8_2 }, { pcm_8_1, pcm_8_2 } },
+	{ { pcm_16le_1, pcm_16le_2 }, { pcm_16be_1, pcm_16be_2 } },
+	{ { pcm_24le_1, pcm_24le_2 }, { pcm_24be_1, pcm_24be_2 } },
+	{ { pcm_32le_1, pcm_32le_2 }, { pcm_32be_1, pcm_32be_2 } },
+};
+
+static pcm_kernel_t kernel;
+
+static void pcm_select_kernel(void) {
+	if (sample_size < 1 || sample_size > 4 || channels < 1 || channels > 2) {
+		kernel = NULL;
+	} else if (channels == 2 && sample_size * 2 == BYTES_PER_FRAME && bigendian != SL_LITTLE_ENDIAN) {
+		kernel = pcm_copy;
+	} else {
+		kernel = pcm_kernels[sample_size - 1][bigendian][channels - 1];
+	}
+}
+
 typedef enum { UNKNOWN = 0, WAVE, AIFF } header_format;
 
 static void _check_header(void) {
@@ -182,7 +324,7 @@ static void _check_header(void) {
 
 static decode_state pcm_decode(void) {
 	unsigned bytes, in, out;
-	frames_t frames, count;
+	frames_t frames, count, chunk;
 	OPTR_T *optr;
 	u8_t  *iptr;
 	u8_t tmp[3*8];
@@ -198,7 +340,7 @@ static decode_state pcm_decode(void) {
 	bytes = min(_buf_used(streambuf), _buf_cont_read(streambuf));
 
 	IF_DIRECT(
-		out = min(_buf_space(outputbuf), _buf_cont_write(outputbuf)) / BYTES_PER_FRAME;
+		out = _buf_space(outputbuf) / BYTES_PER_FRAME;
 	);
 	IF_PROCESS(
 		out = process.max_in_frames;
@@ -241,26 +383,14 @@ static decode_state pcm_decode(void) {
 			out = process.max_in_frames;
 		);
 		bytes_per_frame = channels * sample_size;
+		pcm_select_kernel();
 	}
 
-	IF_DIRECT(
-		optr = (OPTR_T *)outputbuf->writep;
-	);
 	IF_PROCESS(
 		optr = (OPTR_T *)process.inbuf;
 	);
-	iptr = (u8_t *)streambuf->readp;
 
-	in = bytes / bytes_per_frame;
-
-	//  handle frame wrapping round end of streambuf
-	//  - only need if resizing of streambuf does not avoid this, could occur in localfile case
-	if (in == 0 && bytes > 0 && _buf_used(streambuf) >= bytes_per_frame) {
-		memcpy(tmp, iptr, bytes);
-		memcpy(tmp + bytes, streambuf->buf, bytes_per_frame - bytes);
-		iptr = tmp;
-		in = 1;
-	}
+	in = _buf_used(streambuf) / bytes_per_frame;
 
 	frames = min(in, out);
 	frames = min(frames, MAX_DECODE_FRAMES);
@@ -270,163 +400,53 @@ static decode_state pcm_decode(void) {
 		frames = audio_left / bytes_per_frame;
 	}
 	
-	count = frames * channels;
-
-	if (channels == 2) {
-		if (sample_size == 1) {
-			while (count--) {
-				*optr++ = *iptr++ << (24-SHIFT);
-			}
-		} else if (sample_size == 2) {
-			if (bigendian) {
-#if BYTES_PER_FRAME == 4 && !SL_LITTLE_ENDIAN			
-				// while loop below works as is, but memcpy is a win for that 16/16 typical case
-				memcpy(optr, iptr, count * BYTES_PER_FRAME / 2);
-#else				
-				while (count--) {
-					*optr++ = *(iptr) << (24-SHIFT) | *(iptr+1) << (16-SHIFT);
-					iptr += 2;
-				}
-#endif				
-			} else {
-#if BYTES_PER_FRAME == 4 && SL_LITTLE_ENDIAN			
-				// while loop below works as is, but memcpy is a win for that 16/16 typical case
-				memcpy(optr, iptr, count * BYTES_PER_FRAME / 2);
-#else
-				while (count--) {
-					*optr++ = *(iptr) << (16-SHIFT) | *(iptr+1) << (24-SHIFT);
-					iptr += 2;
-				}
-#endif	
-			}
-		} else if (sample_size == 3) {
-			if (bigendian) {
-				while (count--) {
-#if BYTES_PER_FRAME == 4				
-					*optr++ = *(iptr) << 8 | *(iptr+1);
-#else					
-					*optr++ = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8;
-#endif	
-					iptr += 3;
-				}
-			} else {
-				while (count--) {
-#if BYTES_PER_FRAME == 4									
-					*optr++ = *(iptr+1) | *(iptr+2) << 8;
-#else
-					*optr++ = *(iptr) << 8 | *(iptr+1) << 16 | *(iptr+2) << 24;
-#endif	
-					iptr += 3;
-				}
-			}
-		} else if (sample_size == 4) {
-			if (bigendian) {
-				while (count--) {
-#if BYTES_PER_FRAME == 4														
-					*optr++ = *(iptr) << 8 | *(iptr+1);
-#else
-					*optr++ = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8 | *(iptr+3);
-#endif	
-					iptr += 4;
-				}
-			} else {
-				while (count--) {
-#if BYTES_PER_FRAME == 4																			
-					*optr++ = *(iptr+2) | *(iptr+3) << 8;
-#else
-					*optr++ = *(iptr) | *(iptr+1) << 8 | *(iptr+2) << 16 | *(iptr+3) << 24;
-#endif	
-					iptr += 4;
-				}
-			}
+	// convert by contiguous chunks, wrapping round the end of streambuf and outputbuf
+	for (count = frames; count; count -= chunk) {
+		unsigned cont = _buf_cont_read(streambuf);
+
+		iptr = (u8_t *)streambuf->readp;
+		chunk = min(count, cont / bytes_per_frame);
+
+		//  handle frame wrapping round end of streambuf
+		//  - only need if resizing of streambuf does not avoid this, could occur in localfile case
+		if (!chunk) {
+			memcpy(tmp, iptr, cont);
+			memcpy(tmp + cont, streambuf->buf, bytes_per_frame - cont);
+			iptr = tmp;
+			chunk = 1;
 		}
-	} else if (channels == 1) {
-		if (sample_size == 1) {
-			while (count--) {
-				*optr = *iptr++ << (24-SHIFT);
-				*(optr+1) = *optr;
-				optr += 2;
-			}
-		} else if (sample_size == 2) {
-			if (bigendian) {
-				while (count--) {
-					*optr = *(iptr) << (24-SHIFT) | *(iptr+1) << (16-SHIFT);
-					*(optr+1) = *optr;
-					iptr += 2;
-					optr += 2;
-				}
-			} else {
-				while (count--) {
-					*optr = *(iptr) << (16-SHIFT) | *(iptr+1) << (24-SHIFT);
-					*(optr+1) = *optr;
-					iptr += 2;
-					optr += 2;
-				}
-			}
-		} else if (sample_size == 3) {
-			if (bigendian) {
-				while (count--) {
-#if BYTES_PER_FRAME == 4				
-					*optr++ = *(iptr) << 8 | *(iptr+1);
-#else					
-					*optr = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8;
-#endif				
-					*(optr+1) = *optr;
-					iptr += 3;
-					optr += 2;
-				}
-			} else {
-				while (count--) {
-#if BYTES_PER_FRAME == 4														
-					*optr++ = *(iptr+1) | *(iptr+2) << 8;
-#else					
-					*optr = *(iptr) << 8 | *(iptr+1) << 16 | *(iptr+2) << 24;
-#endif				
-					*(optr+1) = *optr;
-					iptr += 3;
-					optr += 2;
-				}
-			}
-		} else if (sample_size == 4) {
-			if (bigendian) {
-				while (count--) {
-#if BYTES_PER_FRAME == 4														
-					*optr++ = *(iptr) << 8 | *(iptr+1);
-#else					
-					*optr++ = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8 | *(iptr+3);
-#endif				
-					*(optr+1) = *optr;
-					iptr += 4;
-					optr += 2;
-				}
-			} else {
-				while (count--) {
-#if BYTES_PER_FRAME == 4																			
-					*optr++ = *(iptr+2) | *(iptr+3) << 8;
-#else					
-					*optr++ = *(iptr) | *(iptr+1) << 8 | *(iptr+2) << 16 | *(iptr+3) << 24;
-#endif				
-					*(optr+1) = *optr;
-					iptr += 4;
-					optr += 2;
-				}
-			}
+
+		IF_DIRECT(
+			optr = (OPTR_T *)outputbuf->writep;
+			chunk = min(chunk, _buf_cont_write(outputbuf) / BYTES_PER_FRAME);
+		);
+
+		if (!chunk) {
+			frames -= count;
+			break;
 		}
-	} else {
+
+		if (kernel) kernel(iptr, optr, chunk);
+
+		_buf_inc_readp(streambuf, chunk * bytes_per_frame);
+		IF_DIRECT(
+			_buf_inc_writep(outputbuf, chunk * BYTES_PER_FRAME);
+		);
+		IF_PROCESS(
+			optr += chunk * 2;
+		);
+	}
+
+	if (!kernel) {
 		LOG_ERROR("unsupported channels");
 	}
-	
-	LOG_SDEBUG("decoded %u frames", frames);
 
-	_buf_inc_readp(streambuf, frames * bytes_per_frame);
+	LOG_SDEBUG("decoded %u frames", frames);
 
 	if (limit) {
 		audio_left -= frames * bytes_per_frame;
 	}
 
-	IF_DIRECT(
-		_buf_inc_writep(outputbuf, frames * BYTES_PER_FRAME);
-	);
 	IF_PROCESS(
 		process.in_frames = frames;
 	);
@@ -445,6 +465,7 @@ static void pcm_open(u8_t size, u8_t rate, u8_t chan, u8_t endianness) {
 	limit       = false;
 
 	LOG_INFO("pcm size: %u rate: %u chan: %u bigendian: %u", sample_size, sample_rate, channels, bigendian);
+	pcm_select_kernel();
 	buf_adjust(streambuf, sample_size * channels);
 }
 
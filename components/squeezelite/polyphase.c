@@ -0,0 +1,204 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "polyphase.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_attr.h"
+#else
+#define IRAM_ATTR
+#endif
+
+#define BLOCK_FRAMES	256
+#define MAX_PHASES		4096
+#define MAX_BANK		(32 * 1024)
+
+struct polyphase_s {
+	unsigned L, M;				// out/in = L/M
+	unsigned taps;				// taps per phase
+	unsigned step, frac;		// M / L and M % L
+	unsigned pos, phase;		// newest frame used by next output and its phase
+	unsigned fill;				// frames in x
+	int16_t *bank;				// [L][taps], coefficients reversed in time
+	int16_t *x;					// history + block, interleaved
+};
+
+static const struct {
+	unsigned taps;
+	float beta, rolloff;
+} tiers[] = {
+	{ 2, 0, 1 },			// BASIC
+	{ 8, 5.6, 0.84 },		// LOW
+	{ 16, 7.9, 0.90 },		// MED
+	{ 32, 9.0, 0.94 },		// HIGH
+};
+
+static unsigned gcd(unsigned a, unsigned b) {
+	while (b) {
+		unsigned t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// zeroth order modified Bessel function, for Kaiser window
+static float bessel_i0(float x) {
+	float sum = 1, term = 1;
+	for (int k = 1; k < 32 && term > sum * 1e-8f; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+static void build_bank(struct polyphase_s *p, polyphase_quality_e quality) {
+	unsigned N = p->taps * p->L;
+	float *h = malloc(N * sizeof(float));
+
+	if (quality == POLYPHASE_BASIC) {
+		// hat function centered on L is linear interpolation
+		for (unsigned n = 0; n < N; n++) h[n] = n < p->L ? (float) n / p->L : 2 - (float) n / p->L;
+	} else {
+		// Kaiser-windowed sinc, cutoff at the lowest nyquist, gain L
+		float fc = tiers[quality].rolloff * 0.5f / (p->L > p->M ? p->L : p->M);
+		float i0b = bessel_i0(tiers[quality].beta);
+		for (unsigned n = 0; n < N; n++) {
+			float t = n - (N - 1) / 2.0f, r = 2.0f * n / (N - 1) - 1;
+			float sinc = t ? sinf(2 * M_PI * fc * t) / (M_PI * t) : 2 * fc;
+			h[n] = sinc * p->L * bessel_i0(tiers[quality].beta * sqrtf(fmaxf(0, 1 - r * r))) / i0b;
+		}
+	}
+
+	// each phase is normalized to unity DC gain then stored reversed as Q15
+	for (unsigned phase = 0; phase < p->L; phase++) {
+		int16_t *c = p->bank + phase * p->taps;
+		float sum = 0;
+		for (unsigned j = 0; j < p->taps; j++) sum += h[phase + j * p->L];
+		for (unsigned j = 0; j < p->taps; j++) {
+			long v = lroundf(h[phase + j * p->L] / sum * 32768);
+			c[p->taps - 1 - j] = v > 32767 ? 32767 : v < -32768 ? -32768 : v;
+		}
+	}
+
+	free(h);
+}
+
+struct polyphase_s* polyphase_create(unsigned in_rate, unsigned out_rate, polyphase_quality_e quality) {
+	struct polyphase_s *p;
+	unsigned g = gcd(in_rate, out_rate);
+
+	if (!g || out_rate / g > MAX_PHASES || quality > POLYPHASE_HIGH) return NULL;
+
+	p = calloc(1, sizeof(struct polyphase_s));
+	if (!p) return NULL;
+
+	p->L = out_rate / g;
+	p->M = in_rate / g;
+	p->step = p->M / p->L;
+	p->frac = p->M % p->L;
+
+	// scale taps when decimating and step down quality until bank fits
+	while (1) {
+		p->taps = tiers[quality].taps;
+		if (quality != POLYPHASE_BASIC && p->M > p->L) p->taps = (p->taps * p->M + p->L - 1) / p->L;
+		if (quality == POLYPHASE_BASIC || p->L * p->taps * sizeof(int16_t) <= MAX_BANK) break;
+		quality--;
+	}
+
+	p->bank = malloc(p->L * p->taps * sizeof(int16_t));
+	p->x = malloc((p->taps - 1 + BLOCK_FRAMES) * 2 * sizeof(int16_t));
+
+	if (!p->bank || !p->x) {
+		polyphase_delete(p);
+		return NULL;
+	}
+
+	build_bank(p, quality);
+	polyphase_flush(p);
+
+	return p;
+}
+
+void polyphase_delete(struct polyphase_s *p) {
+	if (!p) return;
+	free(p->bank);
+	free(p->x);
+	free(p);
+}
+
+void polyphase_flush(struct polyphase_s *p) {
+	memset(p->x, 0, (p->taps - 1) * 2 * sizeof(int16_t));
+	p->fill = p->pos = p->taps - 1;
+	p->phase = 0;
+}
+
+static inline int16_t sat16(int32_t v) {
+	v = (v + (1 << 14)) >> 15;
+	return v > 32767 ? 32767 : v < -32768 ? -32768 : v;
+}
+
+// produce all outputs available in x, this is the hot loop
+static IRAM_ATTR int run(struct polyphase_s *p, int16_t *out) {
+	int16_t *y = out;
+	unsigned taps = p->taps, pos = p->pos, phase = p->phase;
+
+	while (pos < p->fill) {
+		const int16_t *c = p->bank + phase * taps;
+		const int16_t *x = p->x + (pos + 1 - taps) * 2;
+		int32_t left = 0, right = 0;
+
+		for (unsigned k = 0; k < taps; k++, x += 2) {
+			left += x[0] * c[k];
+			right += x[1] * c[k];
+		}
+
+		*y++ = sat16(left);
+		*y++ = sat16(right);
+
+		pos += p->step;
+		phase += p->frac;
+		if (phase >= p->L) {
+			phase -= p->L;
+			pos++;
+		}
+	}
+
+	p->pos = pos;
+	p->phase = phase;
+
+	return (y - out) / 2;
+}
+
+int IRAM_ATTR polyphase_process(struct polyphase_s *p, const int16_t *in, int frames, int16_t *out) {
+	int done = 0;
+
+	while (frames > 0) {
+		unsigned n = frames < BLOCK_FRAMES ? frames : BLOCK_FRAMES, discard;
+
+		memcpy(p->x + p->fill * 2, in, n * 2 * sizeof(int16_t));
+		p->fill += n;
+		in += n * 2;
+		frames -= n;
+
+		done += run(p, out + done * 2);
+
+		// keep taps - 1 frames of history
+		discard = p->fill - (p->taps - 1);
+		memmove(p->x, p->x + discard * 2, (p->taps - 1) * 2 * sizeof(int16_t));
+		p->fill -= discard;
+		p->pos -= discard;
+	}
+
+	return done;
+}
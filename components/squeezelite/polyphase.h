@@ -0,0 +1,35 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ Fixed-point polyphase resampler for 16 bits interleaved stereo. Ratio is exact
+ (out/in reduced to L/M) and a Q15 filter bank of L phases is computed once at
+ creation, so re-using a resampler for the same rates costs nothing.
+ Quality tiers trade taps for CPU (measured on 44.1k<->48k, 88.2k->48k and 44.1k->32k):
+	- BASIC: 2 taps, linear interpolation, ~-15dB images
+	- LOW: 8 taps, ~-57dB images/aliasing, -2dB at 0.7 nyquist
+	- MED: 16 taps, ~-80dB, -0.3dB at 0.7 nyquist
+	- HIGH: 32 taps, ~-80dB (Q15 coefficients limited), flat to 0.7 nyquist
+ When decimating, taps are scaled by M/L to keep the same transition band and
+ quality is stepped down if the bank would exceed 32kB.
+*/
+
+typedef enum { POLYPHASE_BASIC, POLYPHASE_LOW, POLYPHASE_MED, POLYPHASE_HIGH } polyphase_quality_e;
+
+struct polyphase_s;
+
+struct polyphase_s* polyphase_create(unsigned in_rate, unsigned out_rate, polyphase_quality_e quality);
+void 				polyphase_delete(struct polyphase_s *p);
+void 				polyphase_flush(struct polyphase_s *p);
+int 				polyphase_process(struct polyphase_s *p, const int16_t *in, int frames, int16_t *out);
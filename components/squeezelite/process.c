@@ -48,7 +48,7 @@ extern struct codec *codec;
 #endif
 
 
-// transfer all processed frames to the output buf
+// transfer all processed frames to the output buf (only used for drain)
 static void _write_samples(void) {
 	frames_t frames = process.out_frames;
 	ISAMPLE_T *iptr   = (ISAMPLE_T *) process.outbuf;
@@ -91,14 +91,77 @@ static void _write_samples(void) {
 	UNLOCK_O;
 }
 
+// input frames that can be processed with certainty that output fits in 'frames'
+static frames_t _in_frames_for(frames_t frames) {
+	// resampler can be one frame ahead of the exact ratio, keep some margin
+	if (frames <= 2) return 0;
+	return ((u64_t) (frames - 2) * process.in_sample_rate) / process.out_sample_rate;
+}
+
 // process samples - called with decode mutex set
 void process_samples(void) {
+	u8_t *base = process.inbuf, *inbuf = base, *bounce = process.outbuf;
+	unsigned in_frames = process.in_frames, max_out_frames = process.max_out_frames;
 
-	SAMPLES_FUNC(&process);
+	/* Processing writes straight into outputbuf. This is safe without holding the O mutex
+	   as we are the only writer and all writep changes (flush, crossfade) are done either
+	   in this thread or with decode mutex, which we hold. Output thread only reads up to 
+	   writep which is moved once frames are there */
+	while (in_frames) {
+		frames_t space, cont, chunk;
 
-	_write_samples();
+		LOCK_O;
+		space = _buf_space(outputbuf) / BYTES_PER_FRAME;
+		cont = min(space, _buf_cont_write(outputbuf) / BYTES_PER_FRAME);
+		UNLOCK_O;
 
-	process.in_frames = 0;
+		process.inbuf = inbuf;
+
+		if ((chunk = min(in_frames, _in_frames_for(cont))) > 0) {
+
+			process.in_frames = chunk;
+			process.outbuf = outputbuf->writep;
+			process.max_out_frames = cont;
+
+			SAMPLES_FUNC(&process);
+
+		} else if ((chunk = min(in_frames, _in_frames_for(min(space, max_out_frames)))) > 0) {
+			size_t bytes, cont_bytes = cont * BYTES_PER_FRAME;
+
+			// not enough room before wrap, go through bounce buffer and split
+			process.in_frames = chunk;
+			process.outbuf = bounce;
+			process.max_out_frames = max_out_frames;
+
+			SAMPLES_FUNC(&process);
+
+			bytes = process.out_frames * BYTES_PER_FRAME;
+			memcpy(outputbuf->writep, bounce, min(bytes, cont_bytes));
+			if (bytes > cont_bytes) memcpy(outputbuf->buf, bounce + cont_bytes, bytes - cont_bytes);
+
+		} else {
+
+			// outputbuf is full, decoder will call us again before decoding more
+			LOG_DEBUG("outputbuf full, holding %u frames", in_frames);
+			break;
+		}
+
+		LOCK_O;
+		_buf_inc_writep(outputbuf, process.out_frames * BYTES_PER_FRAME);
+		UNLOCK_O;
+
+		inbuf += chunk * BYTES_PER_FRAME;
+		in_frames -= chunk;
+	}
+
+	// what could not be written stays at the beginning of inbuf for next call
+	if (in_frames && inbuf != base) memmove(base, inbuf, in_frames * BYTES_PER_FRAME);
+
+	process.inbuf = base;
+	process.in_frames = in_frames;
+	process.outbuf = bounce;
+	process.max_out_frames = max_out_frames;
+	process.out_frames = 0;
 }
 
 // drain at end of track - called with decode mutex set
@@ -19,22 +19,22 @@
  *
  */
 
-// upsampling using libsoxr - only included if RESAMPLE set
+// resampling using in-tree fixed-point polyphase - only included if RESAMPLE16 set
 
 #include "squeezelite.h"
 
 #if RESAMPLE16
 
-#include <resample16.h>
+#include "polyphase.h"
 
 extern log_level loglevel;
 
 struct resample16 {
-	struct resample16_s *resampler;
+	struct polyphase_s *resampler;
 	bool max_rate;
 	bool exception;
-	bool interp;
-	resample16_filter_e filter;
+	polyphase_quality_e filter;
+	unsigned in_rate, out_rate;
 };
 
 static struct resample16 r;
@@ -42,13 +42,8 @@ static struct resample16 r;
 void resample_samples(struct processstate *process) {
 	ssize_t odone;
 	
-	odone = resample16(r.resampler, (HWORD*) process->inbuf, process->in_frames, (HWORD*) process->outbuf);
+	odone = polyphase_process(r.resampler, (s16_t*) process->inbuf, process->in_frames, (s16_t*) process->outbuf);
 
-	if (odone < 0) {
-		LOG_INFO("resample16 error");
-		return;
-	}
-	
 	process->out_frames = odone;
 	process->total_in  += process->in_frames;
 	process->total_out += odone;
@@ -59,8 +54,8 @@ bool resample_drain(struct processstate *process) {
 	
 	LOG_INFO("resample track complete");
 
-	resample16_delete(r.resampler);
-	r.resampler = NULL;
+	// keep filter bank for next track, only reset history
+	if (r.resampler) polyphase_flush(r.resampler);
 
 	return true;
 }
@@ -108,16 +103,25 @@ bool resample_newstream(struct processstate *process, unsigned raw_sample_rate,
 	process->in_sample_rate = raw_sample_rate;
 	process->out_sample_rate = outrate;
 
-	if (r.resampler) {
-		resample16_delete(r.resampler);
-		r.resampler = NULL;
-	}
-
 	if (raw_sample_rate != outrate) {
 
-		LOG_INFO("resampling from %u -> %u", raw_sample_rate, outrate);
-		r.resampler = resample16_create((float) outrate / raw_sample_rate, r.filter, NULL, false);
+		// filter bank is only rebuilt when rates change
+		if (r.resampler && r.in_rate == raw_sample_rate && r.out_rate == outrate) {
+			polyphase_flush(r.resampler);
+		} else {
+			polyphase_delete(r.resampler);
+			r.resampler = polyphase_create(raw_sample_rate, outrate, r.filter);
+			r.in_rate = raw_sample_rate;
+			r.out_rate = outrate;
+		}
+
+		if (!r.resampler) {
+			LOG_ERROR("can't resample from %u -> %u", raw_sample_rate, outrate);
+			process->out_sample_rate = raw_sample_rate;
+			return false;
+		}
 
+		LOG_INFO("resampling from %u -> %u", raw_sample_rate, outrate);
 		return true;
 
 	} else {
@@ -128,14 +132,11 @@ bool resample_newstream(struct processstate *process, unsigned raw_sample_rate,
 }
 
 void resample_flush(void) {
-	if (r.resampler) {
-		resample16_delete(r.resampler);
-		r.resampler = NULL;
-	}
+	if (r.resampler) polyphase_flush(r.resampler);
 }
 
 bool resample_init(char *opt) {
-	char *filter = NULL, *interp = NULL;
+	char *filter = NULL;
 	
 	r.resampler = NULL;
 	r.max_rate = false;
@@ -143,20 +144,16 @@ bool resample_init(char *opt) {
 
 	if (opt) {
 		filter = next_param(opt, ':');
-		interp = next_param(NULL, ':');
 	}
 
 	if (filter) {
-		if (*filter == 'm') r.filter = RESAMPLE16_MED;
-		else if (*filter == 'l') r.filter = RESAMPLE16_LOW;
-		else r.filter = RESAMPLE16_BASIC;
+		if (*filter == 'h') r.filter = POLYPHASE_HIGH;
+		else if (*filter == 'm') r.filter = POLYPHASE_MED;
+		else if (*filter == 'l') r.filter = POLYPHASE_LOW;
+		else r.filter = POLYPHASE_BASIC;
 	}
 
-	if (interp && *interp == 'i') {
-		r.interp = true;	
-	}
-	
-	LOG_INFO("Resampling with filter %d %s", r.filter, r.interp ? "(interpolated)" : "");
+	LOG_INFO("Resampling with filter %d", r.filter);
 
 	return true;
 }
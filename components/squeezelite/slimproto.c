@@ -816,13 +816,22 @@ void wake_controller(void) {
 	wake_signal(wake_e);
 }
 
+#define DISCOVERY_MIN	50		// first re-send delay (ms), doubles up to DISCOVERY_MAX
+#define DISCOVERY_MAX	5000
+
+// 'max' is a number of DISCOVERY_MAX periods (0 = forever)
 in_addr_t discover_server(char *default_server, int max) {
 	struct sockaddr_in d;
 	struct sockaddr_in s;
 	char buf[32], port_d[] = "JSON", clip_d[] = "CLIP";
-	struct pollfd pollinfo;
+	struct pollfd pollinfo[2];
 	unsigned port;
 	u8_t len;
+	int nfds = 1;
+	in_addr_t last_ip = 0;
+	u16_t last_hport, last_cport;
+	u32_t now, start = gettime_ms(), next = start, resolved = start - DISCOVERY_MAX, wait = 0;
+	u32_t end = start + max * DISCOVERY_MAX;
 
 	int disc_sock = socket(AF_INET, SOCK_DGRAM, 0);
 
@@ -836,23 +845,67 @@ in_addr_t discover_server(char *default_server, int max) {
 	d.sin_port = htons(PORT);
 	d.sin_addr.s_addr = htonl(INADDR_BROADCAST);
 
-	pollinfo.fd = disc_sock;
-	pollinfo.events = POLLIN;
+	memset(&s, 0, sizeof(s));
+
+	pollinfo[0].fd = disc_sock;
+	pollinfo[0].events = POLLIN;
+
+	// try to connect to last known server while discovery runs, first to answer wins
+	if (!default_server && get_last_server(&last_ip, &last_hport, &last_cport)) {
+		struct sockaddr_in probe;
+
+		memset(&probe, 0, sizeof(probe));
+		probe.sin_family = AF_INET;
+		probe.sin_addr.s_addr = last_ip;
+		probe.sin_port = htons(PORT);
+		LOG_INFO("probing last server %s:%d", inet_ntoa(probe.sin_addr), PORT);
+
+		pollinfo[1].fd = socket(AF_INET, SOCK_STREAM, 0);
+		pollinfo[1].events = POLLOUT;
+		set_nonblock(pollinfo[1].fd);
+
+		if (connect(pollinfo[1].fd, (struct sockaddr *) &probe, sizeof(probe)) == 0 || last_error() == EINPROGRESS) nfds = 2;
+		else closesocket(pollinfo[1].fd);
+	}
 
-	do {
+	LOG_INFO("sending discovery %u", max);
 
-		LOG_INFO("sending discovery %u", max);
-		memset(&s, 0, sizeof(s));
+	while (s.sin_addr.s_addr == 0 && running) {
+		now = gettime_ms();
+
+		if ((s32_t) (now - next) >= 0) {
+			if (max && (s32_t) (now - end) >= 0) break;
+
+			LOG_DEBUG("sending discovery (%u ms)", now - start);
+			if (sendto(disc_sock, buf, len, 0, (struct sockaddr *)&d, sizeof(d)) < 0) {
+				LOG_INFO("error sending discovery");
+			}
+
+			if (default_server && now - resolved >= DISCOVERY_MAX) {
+				server_addr(default_server, &s.sin_addr.s_addr, &port);
+				resolved = now;
+				if (s.sin_addr.s_addr) break;
+			}
 
-		if (sendto(disc_sock, buf, len, 0, (struct sockaddr *)&d, sizeof(d)) < 0) {
-			LOG_INFO("error sending discovery");
+			wait = wait ? min(wait * 2, DISCOVERY_MAX) : DISCOVERY_MIN;
+			next = now + wait;
+			if (max && (s32_t) (next - end) > 0) next = end;
 		}
 
-		if (poll(&pollinfo, 1, 5000) == 1) {
+		if (poll(pollinfo, nfds, next - now) <= 0) continue;
+
+		if (pollinfo[0].revents & POLLIN) {
 			char readbuf[64], *p;
 			socklen_t slen = sizeof(s);
 			memset(readbuf, 0, sizeof(readbuf));
 			recvfrom(disc_sock, readbuf, sizeof(readbuf) - 1, 0, (struct sockaddr *)&s, &slen);
+
+			// only a server answers with 'E', ignore our own (or other players') requests
+			if (readbuf[0] != 'E') {
+				memset(&s, 0, sizeof(s));
+				continue;
+			}
+
 			LOG_INFO("got response from: %s:%d", inet_ntoa(s.sin_addr), ntohs(s.sin_port));
 
 			 if ((p = strstr(readbuf, port_d)) != NULL) {
@@ -864,14 +917,27 @@ in_addr_t discover_server(char *default_server, int max) {
 				p += strlen(clip_d);
 				slimproto_cport = atoi(p + 1);
 			}
-		}
+		} else if (nfds == 2 && pollinfo[1].revents) {
+			int error = 0;
+			socklen_t elen = sizeof(error);
 
-		if (default_server) {
-			server_addr(default_server, &s.sin_addr.s_addr, &port);
-		}
+			getsockopt(pollinfo[1].fd, SOL_SOCKET, SO_ERROR, (void *)&error, &elen);
+
+			if (!error && (pollinfo[1].revents & POLLOUT)) {
+				s.sin_addr.s_addr = last_ip;
+				slimproto_hport = last_hport;
+				slimproto_cport = last_cport;
+				LOG_INFO("last server %s reachable after %u ms", inet_ntoa(s.sin_addr), gettime_ms() - start);
+			} else {
+				LOG_INFO("last server not reachable (%d)", error);
+			}
 
-	} while (s.sin_addr.s_addr == 0 && running && (!max || --max));
+			closesocket(pollinfo[1].fd);
+			nfds = 1;
+		}
+	}
 
+	if (nfds == 2) closesocket(pollinfo[1].fd);
 	closesocket(disc_sock);
 
 	return s.sin_addr.s_addr;
@@ -1012,6 +1078,7 @@ void slimproto(log_level level, char *server, u8_t mac[6], const char *name, con
 
 			var_cap[0] = '\0';
 			failed_connect = 0;
+			set_last_server(slimproto_ip, slimproto_hport, slimproto_cport);
 
 			// check if this is a local player now we are connected & signal to server via 'loc' format
 			// this requires LocalPlayer server plugin to enable direct file access
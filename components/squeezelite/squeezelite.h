@@ -561,6 +561,10 @@ void slimproto_stop(void);
 void wake_controller(void);
 void slimproto_send_packet(u8_t *packet, size_t len);
 #define send_packet(p, s) slimproto_send_packet(p,s)
+#if !EMBEDDED
+#define get_last_server(ip, hport, cport) false
+#define set_last_server(ip, hport, cport)
+#endif
 
 // stream.c
 typedef enum { STOPPED = 0, DISCONNECT, STREAMING_WAIT,
@@ -657,6 +661,10 @@ typedef enum { S32_LE, S24_LE, S24_3LE, S16_LE, S24_BE, S24_3BE, S16_BE, S8_BE }
 #endif
 
 typedef enum { FADE_INACTIVE = 0, FADE_DUE, FADE_ACTIVE } fade_state;
+typedef enum { OUTPUT_MARK_TRACK = 0, OUTPUT_MARK_FORMAT, OUTPUT_MARK_EOS } output_mark_e;
+// <when> is the gettime_ms() at which the marked frame left the DAC (can be in the past)
+// OUTPUT_MARK_FORMAT <data> is the sample rate, applied when output reaches it, <cb> can be NULL
+typedef void (*output_mark_cb_t)(output_mark_e type, u32_t data, u32_t when);
 typedef enum { FADE_UP = 1, FADE_DOWN, FADE_CROSS } fade_dir;
 typedef enum { FADE_NONE = 0, FADE_CROSSFADE, FADE_IN, FADE_OUT, FADE_INOUT } fade_mode;
 
@@ -731,6 +739,9 @@ bool output_flush_streaming(void);
 // _* called with mutex locked
 frames_t _output_frames(frames_t avail);
 void _checkfade(bool);
+bool _output_mark(output_mark_e type, u32_t data, output_mark_cb_t cb);
+void _output_flush_marks(void);
+frames_t _output_pending_frames(void);
 
 // output_alsa.c
 #if ALSA
@@ -30,9 +30,18 @@
 #include <fcntl.h>
 
 #if USE_SSL
+#if EMBEDDED
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "esp_crt_bundle.h"
+#include "platform_config.h"
+#else
 #include "openssl/ssl.h"
 #include "openssl/err.h"
 #endif
+#endif
 
 #if SUN
 #include <signal.h>
@@ -78,16 +87,231 @@ static EXT_RAM_ATTR struct {
 #pragma pack(pop)    
 } ogg;
 
-#if USE_SSL
+#define RESUME_TRIES	5
+#define RESUME_BACKOFF	250
+#define RESUME_STALL	5000
+#define RESUME_TIMEOUT	5
+
+/* 
+HTTP sources that give their length and accept ranges are resumed when the 
+connection drops or stalls. The request is replayed with a Range starting at
+the first missing byte while output keeps playing from streambuf, and LMS only
+sees a disconnect once all attempts have failed
+*/
+static EXT_RAM_ATTR struct {
+	bool active, pending, abort;
+	unsigned generation, tries, idle;
+	u32_t ip, retry_at;
+	u16_t port;
+	bool use_ssl;
+	char host[256];
+	char *request;
+	size_t request_len;
+	u64_t offset, end;
+} resume;
+
+#if USE_SSL && EMBEDDED
+typedef mbedtls_ssl_context SSL;
+
+#define SSL_HANDSHAKE_TIMEOUT	10000
+
+/* 
+One TLS context at most is active as the stream thread handles a single 
+connection. The session of the last server is kept so that reconnecting to 
+the same host (seek, next track or reconnect) uses an abbreviated handshake
+*/
+static EXT_RAM_ATTR struct {
+	bool init;
+	int fd, error;
+	mbedtls_ssl_context context;
+	mbedtls_ssl_config conf;
+	mbedtls_entropy_context entropy;
+	mbedtls_ctr_drbg_context drbg;
+	mbedtls_x509_crt ca;
+	struct {
+		bool valid;
+		u16_t port;
+		char host[256];
+		mbedtls_ssl_session data;
+	} session;
+} tls;
+SSL *ssl;
+#elif USE_SSL
 static SSL_CTX *SSLctx;
 SSL *ssl;
 #endif
 
 #if !USE_SSL
-#define _recv(ssl, fc, buf, n, opt) recv(fd, buf, n, opt)
+#define _recv(ssl, fd, buf, n, opt) recv(fd, buf, n, opt)
 #define _send(ssl, fd, buf, n, opt) send(fd, buf, n, opt)
 #define _poll(ssl, pollinfo, timeout) poll(pollinfo, 1, timeout)
 #define _last_error() last_error()
+#elif EMBEDDED
+static int _last_error(void) {
+	if (!tls.error) return last_error();
+	return (tls.error == MBEDTLS_ERR_SSL_WANT_READ || tls.error == MBEDTLS_ERR_SSL_WANT_WRITE) ? ERROR_WOULDBLOCK : ECONNRESET;
+}
+
+static int ssl_bio_send(void *ctx, const unsigned char *buf, size_t len) {
+	int n = send(*(int*) ctx, buf, len, MSG_NOSIGNAL);
+	if (n < 0 && last_error() == ERROR_WOULDBLOCK) return MBEDTLS_ERR_SSL_WANT_WRITE;
+	return n < 0 ? MBEDTLS_ERR_NET_SEND_FAILED : n;
+}
+
+static int ssl_bio_recv(void *ctx, unsigned char *buf, size_t len) {
+	int n = recv(*(int*) ctx, buf, len, 0);
+	if (n < 0 && last_error() == ERROR_WOULDBLOCK) return MBEDTLS_ERR_SSL_WANT_READ;
+	return n < 0 ? MBEDTLS_ERR_NET_RECV_FAILED : n;
+}
+
+static bool ssl_init(void) {
+	char *ca = config_alloc_get(NVS_TYPE_STR, "https_ca");
+	int ret;
+
+	mbedtls_ssl_config_init(&tls.conf);
+	mbedtls_entropy_init(&tls.entropy);
+	mbedtls_ctr_drbg_init(&tls.drbg);
+	mbedtls_x509_crt_init(&tls.ca);
+	mbedtls_ssl_session_init(&tls.session.data);
+
+	if ((ret = mbedtls_ctr_drbg_seed(&tls.drbg, mbedtls_entropy_func, &tls.entropy, (const u8_t*) "squeezelite", 11)) != 0 ||
+		(ret = mbedtls_ssl_config_defaults(&tls.conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT)) != 0) {
+		LOG_ERROR("unable to initialize TLS (-0x%x)", -ret);
+		free(ca);
+		return false;
+	}
+
+	mbedtls_ssl_conf_rng(&tls.conf, mbedtls_ctr_drbg_random, &tls.drbg);
+
+	/* "https_ca" is either empty (built-in bundle, verification failure is only 
+	 * reported because many radios have broken chains), "none" or a PEM chain 
+	 * that must be matched */
+	if (ca && !strcasecmp(ca, "none")) {
+		mbedtls_ssl_conf_authmode(&tls.conf, MBEDTLS_SSL_VERIFY_NONE);
+		LOG_INFO("HTTPS certificates are not verified");
+	} else if (ca && *ca && (ret = mbedtls_x509_crt_parse(&tls.ca, (const u8_t*) ca, strlen(ca) + 1)) >= 0) {
+		mbedtls_ssl_conf_ca_chain(&tls.conf, &tls.ca, NULL);
+		mbedtls_ssl_conf_authmode(&tls.conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+		LOG_INFO("HTTPS using custom CA (%d certificates skipped)", ret);
+	} else {
+		if (ca && *ca) LOG_WARN("can't parse custom CA (-0x%x), using bundle", -ret);
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+		esp_crt_bundle_attach(&tls.conf);
+		mbedtls_ssl_conf_authmode(&tls.conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
+#else
+		mbedtls_ssl_conf_authmode(&tls.conf, MBEDTLS_SSL_VERIFY_NONE);
+#endif
+	}
+
+	free(ca);
+	tls.init = true;
+	return true;
+}
+
+static SSL *ssl_open(int sock, const char *host, u16_t port, bool *abort) {
+	u32_t start = gettime_ms();
+	int ret;
+
+	mbedtls_ssl_init(&tls.context);
+	tls.fd = sock;
+
+	if ((ret = mbedtls_ssl_setup(&tls.context, &tls.conf)) != 0 || (ret = mbedtls_ssl_set_hostname(&tls.context, *host ? host : NULL)) != 0) {
+		LOG_WARN("unable to setup TLS context (-0x%x)", -ret);
+		mbedtls_ssl_free(&tls.context);
+		return NULL;
+	}
+
+	mbedtls_ssl_set_bio(&tls.context, &tls.fd, ssl_bio_send, ssl_bio_recv, NULL);
+
+	if (tls.session.valid && tls.session.port == port && !strcasecmp(tls.session.host, host)) {
+		mbedtls_ssl_set_session(&tls.context, &tls.session.data);
+		LOG_DEBUG("resuming TLS session with %s", host);
+	}
+
+	// socket is non-blocking, so wait on it instead of spinning
+	while ((ret = mbedtls_ssl_handshake(&tls.context)) != 0) {
+		struct pollfd pollinfo = { .fd = sock };
+
+		if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+		if (gettime_ms() - start > SSL_HANDSHAKE_TIMEOUT || (abort && *abort)) {
+			ret = MBEDTLS_ERR_SSL_TIMEOUT;
+			break;
+		}
+
+		pollinfo.events = ret == MBEDTLS_ERR_SSL_WANT_READ ? POLLIN : POLLOUT;
+		poll(&pollinfo, 1, 100);
+	}
+
+	if (ret) {
+		LOG_WARN("unable to open TLS socket with %s (-0x%x)", host, -ret);
+		mbedtls_ssl_free(&tls.context);
+		// don't blame the session when we have been cancelled
+		if (!abort || !*abort) tls.session.valid = false;
+		return NULL;
+	}
+
+	if ((ret = mbedtls_ssl_get_verify_result(&tls.context)) != 0) {
+		LOG_WARN("certificate of %s can't be verified (0x%x)", host, ret);
+	}
+
+	// memorize session for next time
+	mbedtls_ssl_session_free(&tls.session.data);
+	mbedtls_ssl_session_init(&tls.session.data);
+	tls.session.valid = !mbedtls_ssl_get_session(&tls.context, &tls.session.data);
+	strncpy(tls.session.host, host, sizeof(tls.session.host) - 1);
+	tls.session.port = port;
+
+	LOG_INFO("TLS with %s using %s in %u ms", host, mbedtls_ssl_get_ciphersuite(&tls.context), gettime_ms() - start);
+
+	tls.error = 0;
+	return &tls.context;
+}
+
+static void ssl_close(SSL *ssl) {
+	mbedtls_ssl_close_notify(ssl);
+	mbedtls_ssl_free(ssl);
+}
+
+static int _recv(SSL *ssl, int fd, void *buffer, size_t bytes, int options) {
+	size_t n = 0;
+	int ret;
+
+	tls.error = 0;
+	if (!ssl) return recv(fd, buffer, bytes, options);
+
+	// each call returns at most one record, so drain all that are already received
+	do {
+		ret = mbedtls_ssl_read(ssl, (u8_t*) buffer + n, bytes - n);
+		if (ret > 0) n += ret;
+	} while (ret > 0 && n < bytes);
+
+	if (n) return n;
+	if (ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) return 0;
+
+	tls.error = ret;
+	return -1;
+}
+
+static int _send(SSL *ssl, int fd, void *buffer, size_t bytes, int options) {
+	int n;
+	tls.error = 0;
+	if (!ssl) return send(fd, buffer, bytes, options);
+	if ((n = mbedtls_ssl_write(ssl, (u8_t*) buffer, bytes)) >= 0) return n;
+	if (n != MBEDTLS_ERR_SSL_WANT_READ && n != MBEDTLS_ERR_SSL_WANT_WRITE) LOG_INFO("SSL write error -0x%x", -n);
+	tls.error = n;
+	return -1;
+}
+
+// decrypted data might be pending while socket has nothing left
+static int _poll(SSL *ssl, struct pollfd *pollinfo, int timeout) {
+	if (!ssl) return poll(pollinfo, 1, timeout);
+	if (pollinfo->events & POLLIN && mbedtls_ssl_get_bytes_avail(ssl)) {
+		if (pollinfo->events & POLLOUT) poll(pollinfo, 1, 0);
+		pollinfo->revents = POLLIN;
+		return 1;
+	}
+	return poll(pollinfo, 1, timeout);
+}
 #else
 #define _last_error() ERROR_WOULDBLOCK
 
@@ -128,8 +352,55 @@ static int _poll(SSL *ssl, struct pollfd *pollinfo, int timeout) {
 	}
 	return poll(pollinfo, 1, timeout);
 }
+
+static SSL *ssl_open(int sock, const char *host, u16_t port, bool *abort) {
+	SSL *ssl = SSL_new(SSLctx);
+	SSL_set_fd(ssl, sock);
+
+	// add SNI
+	if (*host) SSL_set_tlsext_host_name(ssl, (char*) host);
+
+	while (1) {
+		int status, err = 0;
+
+		ERR_clear_error();
+		status = SSL_connect(ssl);
+
+		// successful negotiation
+		if (status == 1) return ssl;
+
+		// error or non-blocking requires more time
+		if (status < 0) {
+			err = SSL_get_error(ssl, status);
+			if ((err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) && !(abort && *abort)) continue;
+		}
+
+		LOG_WARN("unable to open SSL socket %d (%d)", status, err);
+		SSL_free(ssl);
+		return NULL;
+	}
+}
+
+static void ssl_close(SSL *ssl) {
+	SSL_shutdown(ssl);
+	SSL_free(ssl);
+}
 #endif
 
+// value of a field in HTTP headers that might not be null-terminated
+static const char *http_field(const char *header, size_t len, const char *field, size_t *value_len) {
+	size_t field_len = strlen(field);
+
+	for (size_t i = 0; i + field_len < len; i++) {
+		if ((i && header[i - 1] != '\n') || header[i + field_len] != ':' || strncasecmp(header + i, field, field_len)) continue;
+		for (i += field_len + 1; i < len && header[i] == ' '; i++);
+		for (*value_len = 0; i + *value_len < len && header[i + *value_len] != '\r' && header[i + *value_len] != '\n'; (*value_len)++);
+		return header + i;
+	}
+
+	return NULL;
+}
+
 static bool send_header(void) {
 	char *ptr = stream.header;
 	int len = stream.header_len;
@@ -166,18 +437,249 @@ static void _disconnect(stream_state state, disconnect_code disconnect) {
 	stream.disconnect = disconnect;
     if (ogg.state == OGG_PAGE && ogg.data) free(ogg.data);
     ogg.data = NULL;
+	resume.active = resume.pending = false;
 #if USE_SSL
-	if (ssl) {
-		SSL_shutdown(ssl);
-		SSL_free(ssl);
-		ssl = NULL;
-	}
+	if (ssl) ssl_close(ssl);
+	ssl = NULL;
 #endif
 	closesocket(fd);
 	fd = -1;
 	wake_controller();
 }
 
+// response is resumable when we know where it ends and server accepts ranges
+static void resume_arm(void) {
+	const char *p;
+	size_t len;
+	unsigned code = 0;
+
+	resume.active = false;
+	if (!resume.request_len) return;
+	sscanf(stream.header, "HTTP/%*s %u", &code);
+
+	if (code == 206 && (p = http_field(stream.header, stream.header_len, "Content-Range", &len)) != NULL) {
+		unsigned long long first, last;
+		if (sscanf(p, "bytes %llu-%llu", &first, &last) == 2) {
+			resume.offset = first;
+			resume.end = last + 1;
+			resume.active = true;
+		}
+	} else if (code == 200 && (p = http_field(stream.header, stream.header_len, "Accept-Ranges", &len)) != NULL && !strncasecmp(p, "bytes", 5) &&
+			   (p = http_field(stream.header, stream.header_len, "Content-Length", &len)) != NULL) {
+		resume.offset = 0;
+		resume.end = strtoull(p, NULL, 10);
+		resume.active = resume.end > 0;
+	}
+
+	resume.tries = resume.idle = 0;
+	if (resume.active) LOG_INFO("stream can be resumed (" FMT_u64 "-" FMT_u64 ")", resume.offset, resume.end - 1);
+}
+
+// drop connection and schedule a reconnect if that's possible (LOCK must be held)
+static bool _resume(void) {
+	if (!resume.active || stream.meta_interval || resume.tries >= RESUME_TRIES || resume.offset + stream.bytes >= resume.end) return false;
+
+	LOG_WARN("connection lost at " FMT_u64 "/" FMT_u64 ", resuming", resume.offset + stream.bytes, resume.end);
+
+#if USE_SSL
+	if (ssl) ssl_close(ssl);
+	ssl = NULL;
+#endif
+	closesocket(fd);
+	fd = -1;
+
+	resume.pending = true;
+	resume.retry_at = gettime_ms() + (resume.tries ? RESUME_BACKOFF << (resume.tries - 1) : 0);
+	return true;
+}
+
+// connect by small steps so that a new stream does not have to wait for us
+static int resume_connect(int sock, struct sockaddr_in *addr) {
+	u32_t start = gettime_ms();
+
+	if (connect(sock, (struct sockaddr *) addr, sizeof(*addr)) == 0) return 0;
+#if !WIN
+	if (last_error() != EINPROGRESS) return -1;
+#else
+	if (last_error() != WSAEWOULDBLOCK) return -1;
+#endif
+
+	while (!resume.abort && gettime_ms() - start < RESUME_TIMEOUT * 1000) {
+		struct pollfd pollinfo = { .fd = sock, .events = POLLOUT };
+		if (poll(&pollinfo, 1, 100) > 0) {
+			int	error = 0;
+			socklen_t len = sizeof(error);
+			getsockopt(sock, SOL_SOCKET, SO_ERROR, (void *)&error, &len);
+			return error;
+		}
+	}
+
+	return -1;
+}
+
+// send ranged request and check response, returns -2 if server can't do it
+static int resume_open(const char *request, size_t len, u64_t offset, void **sslp) {
+	struct sockaddr_in addr;
+	u32_t start = gettime_ms();
+	char *header = NULL;
+	size_t header_len = 0;
+	void *sock_ssl = NULL;
+	int sock, ret = -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = resume.ip;
+	addr.sin_port = resume.port;
+
+	if ((sock = socket(AF_INET, SOCK_STREAM, 0)) < 0) return -1;
+
+	set_nonblock(sock);
+	set_nosigpipe(sock);
+
+	if (resume_connect(sock, &addr) != 0) {
+		LOG_INFO("unable to reconnect to server");
+		goto done;
+	}
+
+#if USE_SSL
+	if (resume.use_ssl && (sock_ssl = ssl_open(sock, resume.host, ntohs(resume.port), &resume.abort)) == NULL) goto done;
+#endif
+
+	while (len) {
+		struct pollfd pollinfo = { .fd = sock, .events = POLLOUT };
+		int n = _send(sock_ssl, sock, (void*) request, len, MSG_NOSIGNAL);
+		if (n > 0) {
+			request += n;
+			len -= n;
+		} else if (n < 0 && _last_error() == ERROR_WOULDBLOCK && gettime_ms() - start < RESUME_TIMEOUT * 1000 && !resume.abort) {
+			poll(&pollinfo, 1, 100);
+		} else {
+			goto done;
+		}
+	}
+
+	// only the status and a few fields matter but read all to catch the end
+	header = malloc(MAX_HEADER);
+
+	while (header_len < 4 || memcmp(header + header_len - 4, "\r\n\r\n", 4)) {
+		struct pollfd pollinfo = { .fd = sock, .events = POLLIN };
+		int n;
+
+		if (header_len == MAX_HEADER - 1 || gettime_ms() - start > RESUME_TIMEOUT * 1000 || resume.abort) goto done;
+		if (!_poll(sock_ssl, &pollinfo, 100)) continue;
+
+		if ((n = _recv(sock_ssl, sock, header + header_len, 1, 0)) > 0) header_len += n;
+		else if (n == 0 || _last_error() != ERROR_WOULDBLOCK) goto done;
+	}
+
+	header[header_len] = '\0';
+	LOG_DEBUG("resume headers: len: %zu\n%s", header_len, header);
+
+	unsigned code = 0;
+	unsigned long long first = 0;
+	const char *p = http_field(header, header_len, "Content-Range", &len);
+
+	sscanf(header, "HTTP/%*s %u", &code);
+	if (p) sscanf(p, "bytes %llu-", &first);
+
+	if (code == 206 && first == offset) {
+		ret = sock;
+	} else if (code / 100 == 5) {
+		LOG_INFO("server error %u on resume", code);
+	} else {
+		LOG_WARN("server refused to resume (code %u, range %llu)", code, first);
+		ret = -2;
+	}
+
+done:
+	free(header);
+	if (ret < 0) {
+#if USE_SSL
+		if (sock_ssl) ssl_close(sock_ssl);
+#endif
+		closesocket(sock);
+		sock_ssl = NULL;
+	}
+	*sslp = sock_ssl;
+	return ret;
+}
+
+static void stream_reconnect(void) {
+	char *request = malloc(MAX_HEADER + 64);
+	unsigned generation;
+	size_t len = 0;
+	void *sock_ssl;
+	u64_t offset;
+
+	LOCK;
+
+	// stream_sock() might have cancelled us already
+	if (!resume.pending) {
+		UNLOCK;
+		free(request);
+		return;
+	}
+
+	// make sure stream_sock() does not reuse socket or TLS context while we are connecting
+	polling = true;
+	resume.abort = false;
+	generation = resume.generation;
+	offset = resume.offset + stream.bytes;
+	resume.tries++;
+
+	// replay original request without its range and ask what's missing
+	if (request) {
+		const char *p = resume.request, *end = resume.request + resume.request_len - 2;
+		const char *range = http_field(resume.request, resume.request_len, "Range", &len);
+
+		if (range) {
+			while (range > p && range[-1] != '\n') range--;
+			memcpy(request, p, range - p);
+			len = range - p;
+			for (p = range; p < end && *p != '\n'; p++);
+			if (p < end) p++;
+		} else len = 0;
+
+		memcpy(request + len, p, end - p);
+		len += end - p;
+		len += sprintf(request + len, "Range: bytes=" FMT_u64 "-" FMT_u64 "\r\n\r\n", offset, resume.end - 1);
+	}
+	UNLOCK;
+
+	LOG_INFO("resuming stream at " FMT_u64 " (try %u)", offset, resume.tries);
+
+	int sock = request ? resume_open(request, len, offset, &sock_ssl) : -1;
+	polling = false;
+	free(request);
+
+	LOCK;
+
+	if (generation != resume.generation || !resume.pending) {
+		// stream has been stopped or replaced in the meantime
+		if (sock >= 0) {
+#if USE_SSL
+			if (sock_ssl) ssl_close(sock_ssl);
+#endif
+			closesocket(sock);
+		}
+	} else if (sock >= 0) {
+		LOG_INFO("stream resumed at " FMT_u64, offset);
+		fd = sock;
+#if USE_SSL
+		ssl = sock_ssl;
+#endif
+		resume.pending = false;
+		resume.idle = 0;
+	} else if (sock == -2 || resume.tries >= RESUME_TRIES) {
+		LOG_WARN("unable to resume stream");
+		_disconnect(DISCONNECT, REMOTE_DISCONNECT);
+	} else {
+		resume.retry_at = gettime_ms() + (RESUME_BACKOFF << (resume.tries - 1));
+	}
+
+	UNLOCK;
+}
+
 static size_t memfind(const u8_t* haystack, size_t n, const char* needle, size_t len, size_t* offset) {
 	size_t i;
 	for (i = 0; i < n && *offset != len; i++) *offset = (haystack[i] == needle[*offset]) ? *offset + 1 : 0;
@@ -320,6 +822,12 @@ static void *stream_thread() {
 
 		LOCK;
 
+		if (resume.pending && (s32_t) (gettime_ms() - resume.retry_at) >= 0) {
+			UNLOCK;
+			stream_reconnect();
+			continue;
+		}
+
 		space = min(_buf_space(streambuf), _buf_cont_write(streambuf));
 
 		if (fd < 0 || !space || stream.state <= STREAMING_WAIT) {
@@ -413,6 +921,7 @@ static void *stream_thread() {
 						if (endtok == 4) {
 							*(stream.header + stream.header_len) = '\0';
 							LOG_INFO("headers: len: %d\n%s", stream.header_len, stream.header);
+							resume_arm();
 							stream.state = stream.cont_wait ? STREAMING_WAIT : STREAMING_BUFFERING;
 							wake_controller();
 						}
@@ -484,16 +993,17 @@ static void *stream_thread() {
 					}
 
 					n = _recv(ssl, fd, streambuf->writep, space, 0);
-					if (n == 0) {
+					if (n == 0 && !_resume()) {
 						LOG_INFO("end of stream (%u bytes)", stream.bytes);
 						_disconnect(DISCONNECT, DISCONNECT_OK);
 					}
 					if (n < 0 && _last_error() != ERROR_WOULDBLOCK) {
 						LOG_INFO("error reading: %s", strerror(last_error()));
-						_disconnect(DISCONNECT, REMOTE_DISCONNECT);
+						if (!_resume()) _disconnect(DISCONNECT, REMOTE_DISCONNECT);
 					}
 					
 					if (n > 0) {
+						resume.tries = resume.idle = 0;
                         stream_ogg(n);
 						_buf_inc_writep(streambuf, n);
 						stream.bytes += n;
@@ -519,10 +1029,27 @@ static void *stream_thread() {
 		} else {
 			polling = false;
 			LOG_SDEBUG("poll timeout");
+
+			// we only poll when there is room in streambuf, so silence means a stalled connection
+			if (resume.active && ++resume.idle * 100 >= RESUME_STALL) {
+				LOCK;
+				if (fd >= 0 && (stream.state == STREAMING_BUFFERING || stream.state == STREAMING_HTTP)) _resume();
+				resume.idle = 0;
+				UNLOCK;
+			}
 		}
 	}
 	
-#if USE_SSL	
+#if USE_SSL && EMBEDDED
+	if (tls.init) {
+		mbedtls_ssl_session_free(&tls.session.data);
+		mbedtls_x509_crt_free(&tls.ca);
+		mbedtls_ssl_config_free(&tls.conf);
+		mbedtls_ctr_drbg_free(&tls.drbg);
+		mbedtls_entropy_free(&tls.entropy);
+		tls.init = false;
+	}
+#elif USE_SSL	
 	if (SSLctx) {
 		SSL_CTX_free(SSLctx);
 	}	
@@ -545,7 +1072,10 @@ void stream_init(log_level level, unsigned stream_buf_size) {
 		exit(2);
 	}
 	
-#if USE_SSL
+#if USE_SSL && EMBEDDED
+	if (!ssl_init()) exit(3);
+	ssl = NULL;
+#elif USE_SSL
 #if !LINKALL && !NO_SSLSYM
 	if (ssl_loaded) {
 #endif
@@ -568,6 +1098,7 @@ void stream_init(log_level level, unsigned stream_buf_size) {
 	stream.state = STOPPED;
 	stream.header = malloc(MAX_HEADER);
 	*stream.header = '\0';
+	resume.request = malloc(MAX_HEADER);
 
 	fd = -1;
 
@@ -598,6 +1129,7 @@ void stream_close(void) {
 	pthread_join(thread, NULL);
 #endif
 	free(stream.header);
+	free(resume.request);
 	buf_destroy(streambuf);
 }
 
@@ -634,14 +1166,25 @@ void stream_file(const char *header, size_t header_len, unsigned threshold) {
 	stream.bytes = 0;
 	stream.threshold = threshold;
 
+	resume.active = resume.pending = false;
+	resume.abort = true;
+	resume.generation++;
+
 	UNLOCK;
 }
 
 void stream_sock(u32_t ip, u16_t port, bool use_ssl, bool use_ogg, const char *header, size_t header_len, unsigned threshold, bool cont_wait) {
 	struct sockaddr_in addr;
 
+	// stream is replaced, so cancel any reconnect that would share TLS context with us
+	LOCK;
+	resume.active = resume.pending = false;
+	resume.generation++;
+	resume.abort = true;
+	UNLOCK;
+
 #if EMBEDDED
-	// wait till we are not polling anymore
+	// wait till we are not polling anymore, which is short as reconnect aborts
 	while (polling && running) { usleep(10000);	}	
 #endif	
 
@@ -671,48 +1214,27 @@ void stream_sock(u32_t ip, u16_t port, bool use_ssl, bool use_ogg, const char *h
 		return;
 	}
 	
-#if USE_SSL
-	if (ntohs(port) == 443) {
-		char server[256], *p;
-
-		ssl = SSL_new(SSLctx);
-		SSL_set_fd(ssl, sock);
-
-		// add SNI
-		sscanf(header, "Host:%255s", server);
-		if (server) {
-			if ((p = strchr(server, ':')) != NULL) *p = '\0';
-			SSL_set_tlsext_host_name(ssl, server);
-		}
-		
-		while (1) {
-			int status, err = 0;
-
-			ERR_clear_error();
-			status = SSL_connect(ssl);
-
-			// successful negotiation
-			if (status == 1) break;
-
-			// error or non-blocking requires more time
-			if (status < 0) {
-				err = SSL_get_error(ssl, status);
-				if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) continue;
-			}
+	char host[256] = "";
+	size_t len;
+	const char *p = http_field(header, header_len, "Host", &len);
+
+	// SNI and TLS session are bound to the host, without port
+	if (p) {
+		for (len = min(len, sizeof(host) - 1); len && memchr(p, ':', len); len--);
+		memcpy(host, p, len);
+		host[len] = '\0';
+	}
 
-			LOG_WARN("unable to open SSL socket %d (%d)", status, err);
-			closesocket(sock);
-			SSL_free(ssl);
-			ssl = NULL;
-			LOCK;
-			stream.state = DISCONNECT;
-			stream.disconnect = UNREACHABLE;
-			UNLOCK;
+#if USE_SSL
+	SSL *sock_ssl = NULL;
 
-			return;
-		}
-	} else {
-		ssl = NULL;	
+	if ((use_ssl || ntohs(port) == 443) && (sock_ssl = ssl_open(sock, host, ntohs(port), NULL)) == NULL) {
+		closesocket(sock);
+		LOCK;
+		stream.state = DISCONNECT;
+		stream.disconnect = UNREACHABLE;
+		UNLOCK;
+		return;
 	}
 #endif
 
@@ -721,6 +1243,9 @@ void stream_sock(u32_t ip, u16_t port, bool use_ssl, bool use_ogg, const char *h
 	LOCK;
 
 	fd = sock;
+#if USE_SSL
+	ssl = sock_ssl;
+#endif
 	stream.state = SEND_HEADERS;
 	stream.cont_wait = cont_wait;
 	stream.meta_interval = 0;
@@ -742,6 +1267,19 @@ void stream_sock(u32_t ip, u16_t port, bool use_ssl, bool use_ogg, const char *h
     ogg.flac = false;
     ogg.serial = ULLONG_MAX;
 
+	// memorize what's needed to replay the request
+	resume.active = resume.pending = false;
+	resume.generation++;
+	resume.ip = ip;
+	resume.port = port;
+	resume.use_ssl = use_ssl || ntohs(port) == 443;
+	strcpy(resume.host, host);
+	resume.request_len = 0;
+	if (resume.request && header_len >= 4 && !memcmp(header + header_len - 4, "\r\n\r\n", 4)) {
+		memcpy(resume.request, header, header_len);
+		resume.request_len = header_len;
+	}
+
 	UNLOCK;
 }
 
@@ -749,12 +1287,14 @@ bool stream_disconnect(void) {
 	bool disc = false;
 	LOCK;
 #if USE_SSL
-	if (ssl) {
-		SSL_shutdown(ssl);
-		SSL_free(ssl);
-		ssl = NULL;
-	}
+	if (ssl) ssl_close(ssl);
+	ssl = NULL;
 #endif
+	// a stream waiting to be resumed is still a stream
+	disc = resume.pending;
+	resume.active = resume.pending = false;
+	resume.abort = true;
+	resume.generation++;
 	if (fd != -1) {
 		closesocket(fd);
 		fd = -1;
@@ -29,14 +29,14 @@ static void headset(bool active);
 static bool volume(unsigned left, unsigned right);
 static void power(adac_power_e mode);
 
-const struct adac_s dac_tas57xx = { "TAS57xx", init, adac_deinit, power, speaker, headset, volume };
+const struct adac_s dac_tas57xx = { "TAS57xx", init, adac_deinit, power, speaker, headset, volume, false };
 
 struct tas57xx_cmd_s {
 	uint8_t reg;
 	uint8_t value;
 };
 
-static const struct tas57xx_cmd_s tas57xx_init_sequence[] = {
+static const struct adac_reg_s tas57xx_init_sequence[] = {
     { 0x00, 0x00 },		// select page 0
     { 0x02, 0x10 },		// standby
     { 0x0d, 0x10 },		// use SCK for PLL
@@ -49,7 +49,6 @@ static const struct tas57xx_cmd_s tas57xx_init_sequence[] = {
 	{ 0x28, 0x00 },		// I2S length 16 bits
 #endif
 	{ 0x02, 0x00 },		// restart
-	{ 0xff, 0xff }		// end of table
 };
 
 // matching orders
@@ -82,19 +81,8 @@ static bool init(char *config, int i2c_port, i2s_config_t *i2s_config, bool *mck
 		return false;
 	}
 
-	i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-	
-	for (int i = 0; tas57xx_init_sequence[i].reg != 0xff; i++) {
-		i2c_master_start(i2c_cmd);
-		i2c_master_write_byte(i2c_cmd, (tas57_addr << 1) | I2C_MASTER_WRITE, I2C_MASTER_NACK);
-		i2c_master_write_byte(i2c_cmd, tas57xx_init_sequence[i].reg, I2C_MASTER_NACK);
-		i2c_master_write_byte(i2c_cmd, tas57xx_init_sequence[i].value, I2C_MASTER_NACK);
-		ESP_LOGD(TAG, "i2c write %x at %u", tas57xx_init_sequence[i].reg, tas57xx_init_sequence[i].value);
-	}
-
-	i2c_master_stop(i2c_cmd);	
-	esp_err_t res = i2c_master_cmd_begin(i2c_port, i2c_cmd, 500 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(i2c_cmd);
+	// whole sequence goes in one I2C transaction
+	esp_err_t res = adac_write_table(tas57_addr, tas57xx_init_sequence, sizeof(tas57xx_init_sequence) / sizeof(*tas57xx_init_sequence), false);
 	
 	if (res != ESP_OK) {
 		ESP_LOGE(TAG, "could not intialize TAS57xx %d", res);
@@ -25,6 +25,7 @@
 // NOTE: works with Tremor version here: http://svn.xiph.org/trunk/Tremor, not vorbisidec.1.0.2 currently in ubuntu
 
 #include <ogg/ogg.h>
+#include "oggdemux.h"
 #ifdef TREMOR_ONLY
 #include <vorbis/ivorbiscodec.h>
 #else
@@ -50,12 +51,10 @@ static inline int32_t clip15(int32_t x) {
 
 struct vorbis {
 	bool opened;
-	enum { OGG_ID_HEADER, OGG_COMMENT_HEADER, OGG_SETUP_HEADER } status;
+	enum { OGG_ID_HEADER, OGG_COMMENT_HEADER, OGG_SETUP_HEADER, OGG_AUDIO_DATA } status;
 	struct {
-		ogg_stream_state state;
+		struct ogg_demux demux;
 		ogg_packet packet;
-		ogg_sync_state sync;
-		ogg_page page;
 	};
 	struct {
 		vorbis_dsp_state decoder;
@@ -83,24 +82,6 @@ static struct vorbis {
 	long (* ov_read_tremor)(OggVorbis_File *vf, char *buffer, int length, int *bitstream);
 	int (* ov_open_callbacks)(void *datasource, OggVorbis_File *vf, const char *initial, long ibytes, ov_callbacks callbacks);
 } gv;
-
-static struct {
-	void *handle;
-	int (*ogg_stream_init)(ogg_stream_state* os, int serialno);
-	int (*ogg_stream_clear)(ogg_stream_state* os);
-	int (*ogg_stream_reset)(ogg_stream_state* os);
-	int (*ogg_stream_eos)(ogg_stream_state* os);
-	int (*ogg_stream_reset_serialno)(ogg_stream_state* os, int serialno);
-	int (*ogg_sync_clear)(ogg_sync_state* oy);
-	void (*ogg_packet_clear)(ogg_packet* op);
-	char* (*ogg_sync_buffer)(ogg_sync_state* oy, long size);
-	int (*ogg_sync_wrote)(ogg_sync_state* oy, long bytes);
-	long (*ogg_sync_pageseek)(ogg_sync_state* oy, ogg_page* og);
-	int (*ogg_sync_pageout)(ogg_sync_state* oy, ogg_page* og);
-	int (*ogg_stream_pagein)(ogg_stream_state* os, ogg_page* og);
-	int (*ogg_stream_packetout)(ogg_stream_state* os, ogg_packet* op);
-	int (*ogg_page_packets)(const ogg_page* og);
-} go;
 #endif
 
 static struct vorbis *v;
@@ -132,145 +113,104 @@ extern struct processstate process;
 
 #if LINKALL
 #define OV(h, fn, ...) (vorbis_ ## fn)(__VA_ARGS__)
-#define OG(h, fn, ...) (ogg_ ## fn)(__VA_ARGS__)
 #else
 #define OV(h, fn, ...) (h)->ov_##fn(__VA_ARGS__)
-#define OG(h, fn, ...) (h)->ogg_ ## fn(__VA_ARGS__)
 #endif
 
-static int get_audio_packet(void) {
-	int status, packet = -1;
+static void vorbis_clear(void) {
+	if (v->opened) {
+		OV(&gv, block_clear, &v->block);
+		OV(&gv, dsp_clear, &v->decoder);
+        // info must be last otherwise there is memory leak (where is it said... nowhere)
+		OV(&gv, info_clear, &v->info);
+        // we don' t have comments to free
+	}
 
-	LOCK_S;
-	size_t bytes = min(_buf_used(streambuf), _buf_cont_read(streambuf));
+	v->opened = false;
+}
 
-	while (!(status = OG(&go, stream_packetout, &v->state, &v->packet)) && bytes) {
-		
-		// if sync_pageout (or sync_pageseek) is not called here, sync buffers build up
-		while (!(status = OG(&go, sync_pageout, &v->sync, &v->page)) && bytes) {
-			size_t consumed = min(bytes, 4096);
-			char* buffer = OG(&go, sync_buffer, &v->sync, consumed);
-			memcpy(buffer, streambuf->readp, consumed);
-			OG(&go, sync_wrote, &v->sync, consumed);
-
-			_buf_inc_readp(streambuf, consumed);
-			bytes -= consumed;
-		}
+static int vorbis_header(void) {
+	int status;
+
+	// no need for a switch...case
+	if (v->status == OGG_ID_HEADER) {
+		OV(&gv, info_init, &v->info);
+		status = OV(&gv, synthesis_headerin, &v->info, &v->comment, &v->packet);
 
-		// if we have a new page, put it in and reset serialno at BoS
 		if (status) {
-			OG(&go, stream_pagein, &v->state, &v->page);
-			if (OG(&go, page_bos, &v->page)) OG(&go, stream_reset_serialno, &v->state, OG(&go, page_serialno, &v->page));	
+			LOG_ERROR("id header packet error %d", status);
+			OV(&gv, info_clear, &v->info);
+			return -1;
 		}
-	}
 
-	/* odd packets are not audio and should be discarded. With no packet, we
-	 * return a negative value when there is really nothing more to proceed */
-	if (status > 0 && (v->packet.packet[0] & 0x01) == 0) packet = status;
-	else if (stream.state > DISCONNECT || _buf_used(streambuf)) packet = 0;
+		if (v->rate && v->rate != v->info.rate) LOG_WARN("chained stream changes rate %d => %d", v->rate, v->info.rate);
+
+		v->channels = v->info.channels;
+		v->rate = v->info.rate;
+		v->status = OGG_COMMENT_HEADER;
+		LOG_INFO("id acquired");
+	} else if (v->status == OGG_COMMENT_HEADER) {
+		// we have a "fake" comment as the real one has been skipped
+		OV(&gv, comment_init, &v->comment);
+		v->comment.vendor = "N/A";
+		v->status = OGG_SETUP_HEADER;
+		LOG_INFO("comment skipped successfully");
+	} else {
+		// finally build a codec if we have the packet
+		if (OV(&gv, synthesis_headerin, &v->info, &v->comment, &v->packet) ||
+			OV(&gv, synthesis_init, &v->decoder, &v->info)) {
+			LOG_ERROR("setup header packet error");
+			// no need to free comment, it's fake
+			OV(&gv, info_clear, &v->info);
+			return -1;
+		}
 
-	UNLOCK_S;
-	return packet;
+		OV(&gv, block_init, &v->decoder, &v->block);
+		v->opened = true;
+		v->status = OGG_AUDIO_DATA;
+		LOG_INFO("codec up and running");
+	}
+
+	return 0;
 }
 
-static int read_vorbis_header(void) {
-	int done = 0;
-	bool fetch = true;
+static int get_vorbis_packet(bool audio) {
+	struct ogg_demux_packet packet;
+	int status = 0;
 
 	LOCK_S;
-	size_t bytes = min(_buf_used(streambuf), _buf_cont_read(streambuf));
-
-	while (bytes && !done) {
-		int status;
-
-		// get aligned to a page and ready to bring it in
-		do {
-			size_t consumed = min(bytes, 4096);
-
-			char* buffer = OG(&go, sync_buffer, &v->sync, consumed);
-			memcpy(buffer, streambuf->readp, consumed);
-			OG(&go, sync_wrote, &v->sync, consumed);
-
-			_buf_inc_readp(streambuf, consumed);
-			bytes -= consumed;
-
-			status = fetch ? OG(&go, sync_pageout, &v->sync, &v->page) :
-		 					 OG(&go, sync_pageseek, &v->sync, &v->page);
-		} while (bytes && status <= 0);
-
-		// nothing has been found and we have no more bytes, come back later
-		if (status <= 0) break;
-
-		// always set stream serialno if we have a new one (no multiplexed streams)
-		if (OG(&go, page_bos, &v->page)) OG(&go, stream_reset_serialno, &v->state, OG(&go, page_serialno, &v->page));
-
-		// bring new page in if we want it (otherwise we're just skipping)
-		if (fetch) OG(&go, stream_pagein, &v->state, &v->page);
-
-		// not a switch...case b/c we might have multiple packets in a page in vorbis
-		if (v->status == OGG_ID_HEADER) {
-			// we need the id packet, get more pages if we don't
-			if (!OG(&go, stream_packetout, &v->state, &v->packet)) continue;
-
-			OV(&gv, info_init, &v->info);
-			status = OV(&gv, synthesis_headerin, &v->info, &v->comment, &v->packet);
-
-			if (status) {
-				LOG_ERROR("id header packet error %d", status);
-				done = -1;
-			} else {
-				v->channels = v->info.channels;
-				v->rate = v->info.rate;
-				v->status = OGG_COMMENT_HEADER;
-				fetch = false;
-				LOG_INFO("id acquired");
-				// we should only have one packet, so get next pages
-				if (OG(&go, page_packets, &v->page) == 1) continue;
-			}
-		} 
-		
-		if (v->status == OGG_COMMENT_HEADER) {
-			// don't consume VorbisComment which could be a huge packet, just skip it
-			int packets = OG(&go, page_packets, &v->page);
-			if (!packets) continue;
-
-			// we have a "fake" comment packet that is just has the last page...
-			v->status = OGG_SETUP_HEADER;
-			OG(&go, stream_pagein, &v->state, &v->page);
-			OG(&go, stream_packetout, &v->state, &v->packet);
-
-			OV(&gv, comment_init, &v->comment);
-			v->comment.vendor = "N/A";
-			fetch = true;
-			LOG_INFO("comment skipped successfully");
-
-			// because of lack of page alignment, we might have the setup page already fully in
-			if (packets == 1) continue;
-		}
+	bool ended = stream.state <= DISCONNECT;
+
+	/* headers are processed here, even when we are looking for audio as streams can be
+	 * chained. VorbisComment could be a huge packet so it is skipped, not stored */
+	while (!status && (audio || v->status != OGG_AUDIO_DATA) &&
+		   _ogg_demux_packet(&v->demux, streambuf, &packet, v->status == OGG_COMMENT_HEADER)) {
 
-		if (v->status == OGG_SETUP_HEADER) {
-			// we need the setup packet, get more pages if we don't
-			if (OG(&go, stream_packetout, &v->state, &v->packet) <= 0) continue;
-
-			// finally build a codec if we have the packet
-			if (OV(&gv, synthesis_headerin, &v->info, &v->comment, &v->packet) ||
-				OV(&gv, synthesis_init, &v->decoder, &v->info)) {
-				LOG_ERROR("setup header packet error %d", status);
-				// no need to free comment, it's fake
-				OV(&gv, info_clear, &v->info);
-				done = -1;
-			} else {
-				OV(&gv, block_init, &v->decoder, &v->block);
-				v->opened = true;
-				LOG_INFO("codec up and running");
-				done = 1;
-			}
-			break;
+		// new logical stream, decoder must be rebuilt from its headers
+		if (packet.bos) {
+			vorbis_clear();
+			v->status = OGG_ID_HEADER;
 		}
+
+		v->packet.packet = packet.data;
+		v->packet.bytes = packet.bytes;
+		v->packet.b_o_s = packet.bos;
+		v->packet.e_o_s = packet.eos;
+		v->packet.granulepos = packet.granule;
+		v->packet.packetno = packet.bos ? 0 : v->packet.packetno + 1;
+
+		// odd packets are not audio and should be discarded
+		if (v->status != OGG_AUDIO_DATA) status = vorbis_header();
+		else if (packet.bytes && (packet.data[0] & 0x01) == 0) status = 1;
 	}
 
+	/* when looking for headers, just say if we have them. Otherwise with no packet, we
+	 * return a negative value when there is really nothing more to proceed */
+	if (!audio && v->status == OGG_AUDIO_DATA) status = 1;
+	else if (!status && ended) status = -1;
+
 	UNLOCK_S;
-	return done;
+	return status;
 }
 
 inline int pcm_out(vorbis_dsp_state* decoder, void*** pcm) {
@@ -285,7 +225,7 @@ static decode_state vorbis_decode(void) {
 	u8_t *write_buf;
     
 	if (decode.new_stream) {
-        int status = read_vorbis_header();
+        int status = get_vorbis_packet(false);
 
 		if (status == 0) {
 			return DECODE_RUNNING;
@@ -326,8 +266,14 @@ static decode_state vorbis_decode(void) {
     if (v->overflow) {
         n = pcm_out(&v->decoder, &pcm);
         v->overflow = n - min(n, frames);                
-    } else if ((packet = get_audio_packet()) > 0) {
+    } else if ((packet = get_vorbis_packet(true)) > 0) {
 		n = OV(&gv, synthesis, &v->block, &v->packet);
+
+		// packet might still be in streambuf
+		LOCK_S;
+		_ogg_demux_release(&v->demux, streambuf);
+		UNLOCK_S;
+
 		if (n == 0) n = OV(&gv, synthesis_blockin, &v->decoder, &v->block);
         if (n == 0) n = pcm_out(&v->decoder, &pcm);
         v->overflow = n - min(n, frames);
@@ -412,46 +358,24 @@ static decode_state vorbis_decode(void) {
 }
 
 static void vorbis_open(u8_t size, u8_t rate, u8_t chan, u8_t endianness) {
-	if (v->opened) {
-		OV(&gv, block_clear, &v->block);
-		OV(&gv, dsp_clear, &v->decoder);
-		OV(&gv, info_clear, &v->info);        
-	}
-    
-    v->opened = false;
+	vorbis_clear();
+
 	v->status = OGG_ID_HEADER;
+	v->rate = 0;
     v->overflow = 0;
 
-    OG(&go, stream_clear, &v->state);  
-    OG(&go, sync_clear, &v->sync);
-    OG(&go, stream_init, &v->state, -1);    
+	ogg_demux_init(&v->demux, "\x01vorbis", 7);
 }
 
 static void vorbis_close() {
-	if (v->opened) {
-		OV(&gv, block_clear, &v->block);
-		OV(&gv, dsp_clear, &v->decoder);
-        // info must be last otherwise there is memory leak (where is it said... nowhere)
-		OV(&gv, info_clear, &v->info);
-        // we don' t have comments to free
-	}
-    
-    v->opened = false;
-
-	OG(&go, stream_clear, &v->state);
-	OG(&go, sync_clear, &v->sync);
+	vorbis_clear();
+	ogg_demux_close(&v->demux);
 }
 
 static bool load_vorbis() {
 #if !LINKALL
     char *err;
     
-    void *g_handle = dlopen(LIBOGG, RTLD_NOW);
-    if (!g_handle) {
-        LOG_INFO("ogg dlerror: %s", dlerror());
-		return false
-    }
-    
     void *v_handle = NULL;
 #ifndef TREMOR_ONLY
 	v_handle = dlopen(LIBVORBIS, RTLD_NOW);
@@ -461,26 +385,11 @@ static bool load_vorbis() {
 		if (v_handle) {
 			tremor = true;
 		} else {
-            dlclose(g_handle);
 			LOG_INFO("vorbis/tremor dlerror: %s", dlerror());
 			return false;
 		}
 	}
     
-    g_handle->ogg_stream_clear = dlsym(g_handle->handle, "ogg_stream_clear");
-	g_handle->ogg_stream_reset = dlsym(g_handle->handle, "ogg_stream_reset");
-	g_handle->ogg_stream_eos = dlsym(g_handle->handle, "ogg_stream_eos");
-	g_handle->ogg_stream_reset_serialno = dlsym(g_handle->handle, "ogg_stream_reset_serialno");
-	g_handle->ogg_sync_clear = dlsym(g_handle->handle, "ogg_sync_clear");
-	g_handle->ogg_packet_clear = dlsym(g_handle->handle, "ogg_packet_clear");
-	g_handle->ogg_sync_buffer = dlsym(g_handle->handle, "ogg_sync_buffer");
-	g_handle->ogg_sync_wrote = dlsym(g_handle->handle, "ogg_sync_wrote");
-	g_handle->ogg_sync_pageseek = dlsym(g_handle->handle, "ogg_sync_pageseek");
-	g_handle->ogg_sync_pageout = dlsym(g_handle->handle, "ogg_sync_pageout");
-	g_handle->ogg_stream_pagein = dlsym(g_handle->handle, "ogg_stream_pagein");
-	g_handle->ogg_stream_packetout = dlsym(g_handle->handle, "ogg_stream_packetout");
-	g_handle->ogg_page_packets = dlsym(g_handle->handle, "ogg_page_packets");
-
 	v_handle.ov_read = dlsym(handle, "ov_read");
 	v_handle.ov_info = dlsym(handle, "ov_info");
 	v_handle.ov_clear = dlsym(handle, "ov_clear");
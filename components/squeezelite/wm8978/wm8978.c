@@ -25,12 +25,12 @@ static bool volume(unsigned left, unsigned right) { return false; }
 static void power(adac_power_e mode);
 static bool init(char *config, int i2c_port_num, i2s_config_t *i2s_config, bool *mck);
 
-static esp_err_t i2c_write_shadow(uint8_t reg, uint16_t val);
+static esp_err_t i2c_write_shadow_table(const struct adac_reg_s *table, size_t count);
 static uint16_t i2c_read_shadow(uint8_t reg);
 
 static int WM8978;
 
-const struct adac_s dac_wm8978 = { "WM8978", init, adac_deinit, power, speaker, headset, volume };
+const struct adac_s dac_wm8978 = { "WM8978", init, adac_deinit, power, speaker, headset, volume, false };
 
 // initiation table for non-readbale 9-bit i2c registers
 static uint16_t WM8978_REGVAL_TBL[58] =	{
@@ -44,6 +44,10 @@ static uint16_t WM8978_REGVAL_TBL[58] =	{
 		0X0001, 0X0001
 };
 
+static const struct adac_reg_s WM8978_init_sequence[] = {
+	{ 0, 0 }, { 4, 16 }, { 6, 0 }, { 10, 8 }, { 43, 16 }, { 49, 102 }
+};
+
 /****************************************************************************************
  * init
  */
@@ -56,12 +60,7 @@ static bool init(char *config, int i2c_port, i2s_config_t *i2s_config, bool *mck
     *mck = true;
     
 	// init sequence
-	i2c_write_shadow(0, 0);
-	i2c_write_shadow(4, 16);
-	i2c_write_shadow(6, 0);
-	i2c_write_shadow(10, 8);
-	i2c_write_shadow(43, 16);
-	i2c_write_shadow(49, 102);
+	i2c_write_shadow_table(WM8978_init_sequence, sizeof(WM8978_init_sequence) / sizeof(*WM8978_init_sequence));
 	
 	return true;
 }	
@@ -70,21 +69,23 @@ static bool init(char *config, int i2c_port, i2s_config_t *i2s_config, bool *mck
  * power
  */
 static void power(adac_power_e mode) {
-	uint16_t *data, off[] = {0, 0, 0}, on[] = {11, 384, 111};
-	data = (mode == ADAC_STANDBY || mode == ADAC_OFF) ? off : on;
-	i2c_write_shadow(1, data[0]);
-	i2c_write_shadow(2, data[1]);
-	i2c_write_shadow(3, data[2]);
+	static const struct adac_reg_s off[] = { {1, 0}, {2, 0}, {3, 0} }, on[] = { {1, 11}, {2, 384}, {3, 111} };
+	i2c_write_shadow_table((mode == ADAC_STANDBY || mode == ADAC_OFF) ? off : on, 3);
 }
 
 /****************************************************************************************
- *  Write with custom reg/value structure
+ *  Write a table in one transaction, 9th bit of value goes in register's LSB
  */
- static esp_err_t i2c_write_shadow(uint8_t reg, uint16_t val) {
-	WM8978_REGVAL_TBL[reg] = val;
-	reg = (reg << 1) | ((val >> 8) & 0x01);
-    val &= 0xff;  
-	return adac_write_byte(WM8978, reg, val);
+static esp_err_t i2c_write_shadow_table(const struct adac_reg_s *table, size_t count) {
+	struct adac_reg_s encoded[count];
+	
+	for (size_t i = 0; i < count; i++) {
+		WM8978_REGVAL_TBL[table[i].reg] = table[i].value;
+		encoded[i].reg = (table[i].reg << 1) | ((table[i].value >> 8) & 0x01);
+		encoded[i].value = table[i].value & 0xff;
+	}
+	
+	return adac_write_table(WM8978, encoded, count, false);
 }
 
 /****************************************************************************************
@@ -1,8 +1,13 @@
 #include <stdint.h>
-#include "esp_system.h"
+#include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#ifdef ESP_PLATFORM
+#include "esp_system.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "soc/soc_memory_layout.h"
 #include "freertos/xtensa_api.h"
 #include "freertos/FreeRTOSConfig.h"
 #include "freertos/FreeRTOS.h"
@@ -10,9 +15,14 @@
 #include "freertos/task.h"
 #include "esp_event.h"
 #include "tools.h"
+#else
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#endif
 #include "trace.h"
 
-
+#ifdef ESP_PLATFORM
 static const char TAG[] = "TRACE";
 // typedef struct mem_usage_trace_for_thread {
 //     TaskHandle_t task;
@@ -118,3 +128,416 @@ void memtrace_print_delta(const char * msg, const char * tag, const char * funct
     malloc_spiram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
     malloc_dma = heap_caps_get_free_size(MALLOC_CAP_DMA);
 }
+#endif
+
+/****************************************************************************************
+ * Allocation tracker
+ *
+ * Heap functions are interposed at link time (--wrap, see CMakeLists.txt) and every 
+ * allocation is accounted to the address it was called from. Nothing is recorded until 
+ * memtrack_start() allocates the tables, then it costs two small hash lookups under a 
+ * spinlock. Sizes are the requested ones and the heap region is decided by address.
+ * On esp32 it is only built with CONFIG_MEMTRACK. Heap functions must then stay callable 
+ * while flash cache is disabled, so the whole path is in IRAM and tracking is skipped 
+ * as the tables sit in PSRAM.
+ */
+
+#if !defined(ESP_PLATFORM) || CONFIG_MEMTRACK
+
+#define MEMTRACK_SLOTS	4096	// live blocks, power of 2 and never filled above 3/4
+#define MEMTRACK_SITES	256		// call sites, power of 2 and index 0 collects the overflow
+#define MEMTRACK_MAX	16		// maximum sites in a report
+
+enum { MEMTRACK_INTERNAL, MEMTRACK_SPIRAM, MEMTRACK_REGIONS };
+
+struct memtrack_slot_s {
+	void *ptr;
+	uint32_t size : 24, site : 8;
+};
+
+struct memtrack_site_s {
+	uintptr_t pc;
+	int32_t live[MEMTRACK_REGIONS], blocks;
+	uint32_t allocs, bytes;
+	uint32_t last_allocs, last_bytes;
+};
+
+static struct {
+	volatile bool active;
+	struct memtrack_slot_s *slots;
+	struct memtrack_site_s *sites;
+	int count;
+	uint32_t untracked, started, last;
+} memtrack;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+#ifdef ESP_PLATFORM
+#include <reent.h>
+#include "esp_spi_flash.h"
+
+void *__real__malloc_r(struct _reent *r, size_t size);
+void *__real__calloc_r(struct _reent *r, size_t n, size_t size);
+void *__real__realloc_r(struct _reent *r, void *ptr, size_t size);
+void __real__free_r(struct _reent *r, void *ptr);
+void *__real_heap_caps_malloc(size_t size, uint32_t caps);
+void *__real_heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void *__real_heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+void __real_heap_caps_free(void *ptr);
+
+static portMUX_TYPE memtrack_mux = portMUX_INITIALIZER_UNLOCKED;
+#define MEMTRACK_LOCK		portENTER_CRITICAL(&memtrack_mux)
+#define MEMTRACK_UNLOCK		portEXIT_CRITICAL(&memtrack_mux)
+// windowed ABI keeps call size in the 2 MSB of return address, point to the call itself
+#define MEMTRACK_CALLER		(((((uintptr_t) __builtin_return_address(0)) & 0x3fffffff) | 0x40000000) - 3)
+#define MEMTRACK_REGION(p)	(esp_ptr_external_ram(p) ? MEMTRACK_SPIRAM : MEMTRACK_INTERNAL)
+#define MEMTRACK_ALLOC(s)	heap_caps_calloc_prefer(1, s, 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_INTERNAL)
+#define MEMTRACK_FREE(p)	__real_heap_caps_free(p)
+#define MEMTRACK_IRAM		IRAM_ATTR
+#define MEMTRACK_ON			(memtrack.active && spi_flash_cache_enabled())
+
+static uint32_t memtrack_now(void) {
+	return esp_timer_get_time() / 1000;
+}
+#else
+static pthread_mutex_t memtrack_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define MEMTRACK_LOCK		pthread_mutex_lock(&memtrack_mutex)
+#define MEMTRACK_UNLOCK		pthread_mutex_unlock(&memtrack_mutex)
+#define MEMTRACK_CALLER		((uintptr_t) __builtin_return_address(0))
+#define MEMTRACK_REGION(p)	MEMTRACK_INTERNAL
+#define MEMTRACK_ALLOC(s)	__real_calloc(1, s)
+#define MEMTRACK_FREE(p)	__real_free(p)
+#define MEMTRACK_IRAM
+#define MEMTRACK_ON			(memtrack.active)
+
+static uint32_t memtrack_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+#endif
+
+static inline MEMTRACK_IRAM uint32_t memtrack_hash(uintptr_t value, uint32_t mask) {
+	return (((uint32_t) (value >> 2) * 2654435761u) >> 16) & mask;
+}
+
+static int MEMTRACK_IRAM memtrack_site(uintptr_t pc) {
+	uint32_t i = memtrack_hash(pc, MEMTRACK_SITES - 1);
+
+	for (int n = MEMTRACK_SITES; --n >= 0; i = (i + 1) & (MEMTRACK_SITES - 1)) {
+		if (!i) continue;
+		if (memtrack.sites[i].pc == pc) return i;
+		if (!memtrack.sites[i].pc) {
+			memtrack.sites[i].pc = pc;
+			return i;
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t MEMTRACK_IRAM memtrack_slot(void *ptr) {
+	uint32_t i = memtrack_hash((uintptr_t) ptr, MEMTRACK_SLOTS - 1);
+	while (memtrack.slots[i].ptr && memtrack.slots[i].ptr != ptr) i = (i + 1) & (MEMTRACK_SLOTS - 1);
+	return i;
+}
+
+static void MEMTRACK_IRAM memtrack_alloc(void *ptr, size_t size, uintptr_t pc) {
+	if (!ptr) return;
+	int region = MEMTRACK_REGION(ptr);
+	if (size > 0xffffff) size = 0xffffff;
+
+	MEMTRACK_LOCK;
+
+	if (memtrack.slots) {
+		struct memtrack_slot_s *slot = memtrack.slots + memtrack_slot(ptr);
+		struct memtrack_site_s *site;
+
+		if (slot->ptr) {
+			// nested interposed call, outermost caller takes it
+			site = memtrack.sites + slot->site;
+			site->live[region] -= slot->size;
+			site->blocks--;
+			site->allocs--;
+			site->bytes -= slot->size;
+		} else if (memtrack.count < MEMTRACK_SLOTS * 3 / 4) {
+			slot->ptr = ptr;
+			memtrack.count++;
+		} else {
+			memtrack.untracked++;
+			slot = NULL;
+		}
+
+		if (slot) {
+			slot->size = size;
+			slot->site = memtrack_site(pc);
+			site = memtrack.sites + slot->site;
+			site->live[region] += size;
+			site->blocks++;
+			site->allocs++;
+			site->bytes += size;
+		}
+	}
+
+	MEMTRACK_UNLOCK;
+}
+
+static size_t MEMTRACK_IRAM memtrack_free(void *ptr) {
+	size_t size = 0;
+	if (!ptr) return 0;
+
+	MEMTRACK_LOCK;
+
+	if (memtrack.slots) {
+		uint32_t i = memtrack_slot(ptr);
+
+		if (memtrack.slots[i].ptr) {
+			struct memtrack_site_s *site = memtrack.sites + memtrack.slots[i].site;
+			size = memtrack.slots[i].size;
+			site->live[MEMTRACK_REGION(ptr)] -= size;
+			site->blocks--;
+			memtrack.count--;
+
+			// backward shift deletion so that probing chains stay unbroken
+			for (uint32_t j = i;;) {
+				memtrack.slots[i].ptr = NULL;
+				uint32_t k;
+				do {
+					j = (j + 1) & (MEMTRACK_SLOTS - 1);
+					if (!memtrack.slots[j].ptr) goto done;
+					k = memtrack_hash((uintptr_t) memtrack.slots[j].ptr, MEMTRACK_SLOTS - 1);
+				} while (i <= j ? (i < k && k <= j) : (i < k || k <= j));
+				memtrack.slots[i] = memtrack.slots[j];
+				i = j;
+			}
+		}
+	}
+
+done:
+	MEMTRACK_UNLOCK;
+	return size;
+}
+
+void *MEMTRACK_IRAM __wrap_malloc(size_t size) {
+	void *ptr = __real_malloc(size);
+	if (MEMTRACK_ON) memtrack_alloc(ptr, size, MEMTRACK_CALLER);
+	return ptr;
+}
+
+void *MEMTRACK_IRAM __wrap_calloc(size_t n, size_t size) {
+	void *ptr = __real_calloc(n, size);
+	if (MEMTRACK_ON) memtrack_alloc(ptr, n * size, MEMTRACK_CALLER);
+	return ptr;
+}
+
+void *MEMTRACK_IRAM __wrap_realloc(void *ptr, size_t size) {
+	if (!MEMTRACK_ON) return __real_realloc(ptr, size);
+
+	// forget old block first, another task might get its address once released
+	size_t old = memtrack_free(ptr);
+	void *new = __real_realloc(ptr, size);
+	if (new) memtrack_alloc(new, size, MEMTRACK_CALLER);
+	else if (size && old) memtrack_alloc(ptr, old, MEMTRACK_CALLER);
+	return new;
+}
+
+void MEMTRACK_IRAM __wrap_free(void *ptr) {
+	if (MEMTRACK_ON) memtrack_free(ptr);
+	__real_free(ptr);
+}
+
+#ifdef ESP_PLATFORM
+void *MEMTRACK_IRAM __wrap__malloc_r(struct _reent *r, size_t size) {
+	void *ptr = __real__malloc_r(r, size);
+	if (MEMTRACK_ON) memtrack_alloc(ptr, size, MEMTRACK_CALLER);
+	return ptr;
+}
+
+void *MEMTRACK_IRAM __wrap__calloc_r(struct _reent *r, size_t n, size_t size) {
+	void *ptr = __real__calloc_r(r, n, size);
+	if (MEMTRACK_ON) memtrack_alloc(ptr, n * size, MEMTRACK_CALLER);
+	return ptr;
+}
+
+void *MEMTRACK_IRAM __wrap__realloc_r(struct _reent *r, void *ptr, size_t size) {
+	if (!MEMTRACK_ON) return __real__realloc_r(r, ptr, size);
+
+	size_t old = memtrack_free(ptr);
+	void *new = __real__realloc_r(r, ptr, size);
+	if (new) memtrack_alloc(new, size, MEMTRACK_CALLER);
+	else if (size && old) memtrack_alloc(ptr, old, MEMTRACK_CALLER);
+	return new;
+}
+
+void MEMTRACK_IRAM __wrap__free_r(struct _reent *r, void *ptr) {
+	if (MEMTRACK_ON) memtrack_free(ptr);
+	__real__free_r(r, ptr);
+}
+
+void *MEMTRACK_IRAM __wrap_heap_caps_malloc(size_t size, uint32_t caps) {
+	void *ptr = __real_heap_caps_malloc(size, caps);
+	if (MEMTRACK_ON) memtrack_alloc(ptr, size, MEMTRACK_CALLER);
+	return ptr;
+}
+
+void *MEMTRACK_IRAM __wrap_heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+	void *ptr = __real_heap_caps_calloc(n, size, caps);
+	if (MEMTRACK_ON) memtrack_alloc(ptr, n * size, MEMTRACK_CALLER);
+	return ptr;
+}
+
+void *MEMTRACK_IRAM __wrap_heap_caps_realloc(void *ptr, size_t size, uint32_t caps) {
+	if (!MEMTRACK_ON) return __real_heap_caps_realloc(ptr, size, caps);
+
+	size_t old = memtrack_free(ptr);
+	void *new = __real_heap_caps_realloc(ptr, size, caps);
+	if (new) memtrack_alloc(new, size, MEMTRACK_CALLER);
+	else if (size && old) memtrack_alloc(ptr, old, MEMTRACK_CALLER);
+	return new;
+}
+
+void MEMTRACK_IRAM __wrap_heap_caps_free(void *ptr) {
+	if (MEMTRACK_ON) memtrack_free(ptr);
+	__real_heap_caps_free(ptr);
+}
+#endif
+
+bool memtrack_start(void) {
+	if (memtrack.active) return true;
+
+	struct memtrack_slot_s *slots = MEMTRACK_ALLOC(MEMTRACK_SLOTS * sizeof(struct memtrack_slot_s));
+	struct memtrack_site_s *sites = MEMTRACK_ALLOC(MEMTRACK_SITES * sizeof(struct memtrack_site_s));
+
+	if (!slots || !sites) {
+		MEMTRACK_FREE(slots);
+		MEMTRACK_FREE(sites);
+		return false;
+	}
+
+	MEMTRACK_LOCK;
+	memtrack.slots = slots;
+	memtrack.sites = sites;
+	memtrack.count = memtrack.untracked = 0;
+	memtrack.started = memtrack.last = memtrack_now();
+	memtrack.active = true;
+	MEMTRACK_UNLOCK;
+
+	return true;
+}
+
+void memtrack_stop(void) {
+	MEMTRACK_LOCK;
+	struct memtrack_slot_s *slots = memtrack.slots;
+	struct memtrack_site_s *sites = memtrack.sites;
+	memtrack.active = false;
+	memtrack.slots = NULL;
+	memtrack.sites = NULL;
+	MEMTRACK_UNLOCK;
+
+	MEMTRACK_FREE(slots);
+	MEMTRACK_FREE(sites);
+}
+
+bool memtrack_active(void) {
+	return memtrack.active;
+}
+#else
+bool memtrack_start(void) {
+	return false;
+}
+
+void memtrack_stop(void) { }
+
+bool memtrack_active(void) {
+	return false;
+}
+#endif
+
+size_t memtrack_report(char *buf, size_t size, int top, bool by_rate) {
+	size_t len = 0;
+
+#define REPORT(...) if (len < size) len += snprintf(buf + len, size - len, __VA_ARGS__)
+
+	*buf = '\0';
+
+#ifdef ESP_PLATFORM
+	static const struct { const char *name; uint32_t caps; } regions[] = {
+		{ "internal", MALLOC_CAP_INTERNAL }, { "spiram", MALLOC_CAP_SPIRAM }, { "dma", MALLOC_CAP_DMA } };
+
+	REPORT("region      free       min   largest\n");
+	for (int i = 0; i < sizeof(regions) / sizeof(*regions); i++) {
+		REPORT("%-8s %7zu   %7zu   %7zu\n", regions[i].name, heap_caps_get_free_size(regions[i].caps),
+				heap_caps_get_minimum_free_size(regions[i].caps), heap_caps_get_largest_free_block(regions[i].caps));
+	}
+#endif
+
+#if !defined(ESP_PLATFORM) || CONFIG_MEMTRACK
+	struct memtrack_site_s sites[MEMTRACK_MAX];
+	uint32_t rank[MEMTRACK_MAX], now = memtrack_now(), elapsed, count, untracked, uptime;
+	int n = 0;
+
+	if (top > MEMTRACK_MAX) top = MEMTRACK_MAX;
+
+	MEMTRACK_LOCK;
+
+	if (!memtrack.sites) {
+		MEMTRACK_UNLOCK;
+		REPORT("allocation tracking is off\n");
+		return len < size ? len : size - 1;
+	}
+
+	// keep the first sites by live size or by number of allocations since last report
+	for (int i = 0; i < MEMTRACK_SITES; i++) {
+		struct memtrack_site_s *site = memtrack.sites + i;
+		uint32_t key = by_rate ? site->allocs - site->last_allocs : site->live[MEMTRACK_INTERNAL] + site->live[MEMTRACK_SPIRAM];
+		int j;
+
+		if (key && top) {
+			for (j = n; j > 0 && rank[j - 1] < key; j--) {
+				if (j < top) {
+					rank[j] = rank[j - 1];
+					sites[j] = sites[j - 1];
+				}
+			}
+			if (j < top) {
+				rank[j] = key;
+				sites[j] = *site;
+				if (n < top) n++;
+			}
+		}
+
+		site->last_allocs = site->allocs;
+		site->last_bytes = site->bytes;
+	}
+
+	elapsed = now - memtrack.last;
+	uptime = now - memtrack.started;
+	count = memtrack.count;
+	untracked = memtrack.untracked;
+	memtrack.last = now;
+
+	MEMTRACK_UNLOCK;
+
+	if (!elapsed) elapsed = 1;
+	REPORT("%u live blocks (%u untracked) over %us, rates over last %u.%us\n", count, untracked,
+			uptime / 1000, elapsed / 1000, (elapsed % 1000) / 100);
+	REPORT("      site   internal     spiram  blocks   allocs/s    bytes/s     allocs\n");
+
+	for (int i = 0; i < n; i++) {
+		uint32_t allocs = (uint64_t) (sites[i].allocs - sites[i].last_allocs) * 10000 / elapsed;
+		uint32_t bytes = (uint64_t) (sites[i].bytes - sites[i].last_bytes) * 1000 / elapsed;
+		REPORT("0x%08lx %10d %10d %7d %8u.%u %10u %10u\n", (unsigned long) sites[i].pc,
+				sites[i].live[MEMTRACK_INTERNAL], sites[i].live[MEMTRACK_SPIRAM], sites[i].blocks,
+				allocs / 10, allocs % 10, bytes, sites[i].allocs);
+	}
+#else
+	REPORT("allocation tracker not built (CONFIG_MEMTRACK)\n");
+#endif
+
+#undef REPORT
+
+	return len < size ? len : size - 1;
+}
@@ -11,10 +11,27 @@
  
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #ifdef ENABLE_MEMTRACE
 #define MEMTRACE_PRINT_DELTA() memtrace_print_delta(NULL,TAG,__FUNCTION__);
 #define MEMTRACE_PRINT_DELTA_MESSAGE(x) memtrace_print_delta(x,TAG,__FUNCTION__);
 #else
 #define MEMTRACE_PRINT_DELTA()
 #define MEMTRACE_PRINT_DELTA_MESSAGE(x) ESP_LOGD(TAG,"%s",x);
-#endif
\ No newline at end of file
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// allocation tracker, heap functions are interposed at link time
+bool 	memtrack_start(void);
+void 	memtrack_stop(void);
+bool 	memtrack_active(void);
+size_t 	memtrack_report(char *buf, size_t size, int top, bool by_rate);
+
+#ifdef __cplusplus
+}
+#endif
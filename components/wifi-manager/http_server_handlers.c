@@ -14,6 +14,7 @@ Copyright (c) 2017-2021 Sebastien L
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/timers.h"
 #include "platform_config.h"
 #include "sys/param.h"
 #include "esp_vfs.h"
@@ -1135,6 +1136,164 @@ esp_err_t status_get_handler(httpd_req_t *req){
 	return ESP_OK;
 }
 
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+/*
+ * Live status channel. Websocket clients get the full status object when
+ * they connect, then a periodic push from the httpd task only carries status
+ * keys that changed (removed keys are sent as null) along with any pending
+ * messages, so an idle UI costs nothing but the timer tick. Messages come from
+ * a subscription of their own so that /messages.json pollers still get them.
+ */
+#define LIVE_PUSH_INTERVAL_MS	1000
+#define LIVE_MAX_CLIENTS		3
+
+static int live_fds[LIVE_MAX_CLIENTS] = { -1, -1, -1 };
+static cJSON * live_status = NULL;
+static TimerHandle_t live_timer = NULL;
+static bool live_queued = false;
+static RingbufHandle_t live_messaging = NULL;
+
+static cJSON * live_status_delta(cJSON * previous, cJSON * current){
+	cJSON * delta = cJSON_CreateObject();
+	cJSON * item;
+	cJSON_ArrayForEach(item, current){
+		cJSON * old = previous ? cJSON_GetObjectItemCaseSensitive(previous, item->string) : NULL;
+		if(!old || !cJSON_Compare(old, item, true)){
+			cJSON_AddItemToObject(delta, item->string, cJSON_Duplicate(item, true));
+		}
+	}
+	if(previous){
+		cJSON_ArrayForEach(item, previous){
+			if(!cJSON_GetObjectItemCaseSensitive(current, item->string)){
+				cJSON_AddNullToObject(delta, item->string);
+			}
+		}
+	}
+	return delta;
+}
+
+static void live_send(httpd_handle_t server, const char * text){
+	httpd_ws_frame_t frame = { .final = true, .type = HTTPD_WS_TYPE_TEXT, .payload = (uint8_t *)text, .len = strlen(text) };
+	for(int i = 0; i < LIVE_MAX_CLIENTS; i++){
+		if(live_fds[i] < 0) continue;
+		// socket might have been closed or purged by the server since last push
+		if(httpd_ws_get_fd_info(server, live_fds[i]) != HTTPD_WS_CLIENT_WEBSOCKET ||
+		   httpd_ws_send_frame_async(server, live_fds[i], &frame) != ESP_OK){
+			ESP_LOGD_LOC(TAG, "Dropping live client fd %d", live_fds[i]);
+			live_fds[i] = -1;
+		}
+	}
+}
+
+static int live_count(void){
+	int count = 0;
+	for(int i = 0; i < LIVE_MAX_CLIENTS; i++) if(live_fds[i] >= 0) count++;
+	return count;
+}
+
+// runs in httpd task context, so client table and sockets are never accessed concurrently
+static void live_push(void * arg){
+	httpd_handle_t server = (httpd_handle_t)arg;
+	cJSON * update, * current = NULL;
+	live_queued = false;
+
+	if(!live_count()){
+		xTimerStop(live_timer, 0);
+		cJSON_Delete(live_status);
+		live_status = NULL;
+		return;
+	}
+
+	update = cJSON_CreateObject();
+	if(network_status_lock_json_buffer(( TickType_t ) 200/portTICK_PERIOD_MS)) {
+		current = network_status_alloc_get_ip_info_cjson();
+		network_status_unlock_json_buffer();
+	}
+	if(current){
+		cJSON * delta = live_status_delta(live_status, current);
+		if(delta->child) cJSON_AddItemToObject(update, "status", delta);
+		else cJSON_Delete(delta);
+		cJSON_Delete(live_status);
+		live_status = current;
+	}
+
+	cJSON * messages = live_messaging ? messaging_retrieve_messages(live_messaging) : NULL;
+	if(messages && cJSON_GetArraySize(messages)) cJSON_AddItemToObject(update, "messages", messages);
+	else cJSON_Delete(messages);
+
+	if(update->child){
+		char * text = cJSON_PrintUnformatted(update);
+		if(text){
+			live_send(server, text);
+			free(text);
+		}
+	}
+	cJSON_Delete(update);
+
+	// update status for next push
+	network_async_update_status();
+}
+
+static void live_timer_cb(TimerHandle_t timer){
+	httpd_handle_t server = http_get_server(NULL);
+	// don't pile up work items if httpd is busy serving a large file
+	if(server && !live_queued && httpd_queue_work(server, live_push, server) == ESP_OK){
+		live_queued = true;
+	}
+}
+
+esp_err_t status_ws_handler(httpd_req_t *req){
+	int fd = httpd_req_to_sockfd(req);
+	if(req->method == HTTP_GET){
+		// handshake done, register client and give it the whole picture
+		ESP_LOGD_LOC(TAG, "Live client connected, fd %d", fd);
+		int slot = -1;
+		for(int i = 0; i < LIVE_MAX_CLIENTS && slot < 0; i++) if(live_fds[i] < 0 || live_fds[i] == fd) slot = i;
+		if(slot < 0){
+			ESP_LOGW_LOC(TAG, "Too many live clients");
+			return ESP_FAIL;
+		}
+		live_fds[slot] = fd;
+		if(!live_messaging) live_messaging = messaging_register_subscriber(10, "http_live");
+
+		char * text = NULL;
+		if(network_status_lock_json_buffer(( TickType_t ) 200/portTICK_PERIOD_MS)) {
+			char * buff = network_status_alloc_get_ip_info_json();
+			network_status_unlock_json_buffer();
+			if(buff){
+				text = malloc_init_external(strlen(buff) + sizeof("{\"status\":}"));
+				if(text) sprintf(text, "{\"status\":%s}", buff);
+				free(buff);
+			}
+		}
+		if(text){
+			httpd_ws_frame_t frame = { .final = true, .type = HTTPD_WS_TYPE_TEXT, .payload = (uint8_t *)text, .len = strlen(text) };
+			httpd_ws_send_frame(req, &frame);
+			free(text);
+		}
+
+		if(!live_timer) live_timer = xTimerCreate("live status", pdMS_TO_TICKS(LIVE_PUSH_INTERVAL_MS), pdTRUE, NULL, live_timer_cb);
+		if(live_timer && !xTimerIsTimerActive(live_timer)) xTimerStart(live_timer, 0);
+		return ESP_OK;
+	}
+
+	// client has nothing to say for now, just drain its frames
+	httpd_ws_frame_t frame = { 0 };
+	esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+	if(err != ESP_OK) return err;
+	if(frame.len){
+		frame.payload = malloc(frame.len);
+		if(!frame.payload) return ESP_ERR_NO_MEM;
+		err = httpd_ws_recv_frame(req, &frame, frame.len);
+		free(frame.payload);
+	}
+	if(frame.type == HTTPD_WS_TYPE_CLOSE){
+		for(int i = 0; i < LIVE_MAX_CLIENTS; i++) if(live_fds[i] == fd) live_fds[i] = -1;
+	}
+	return err;
+}
+#endif
+
 
 esp_err_t err_handler(httpd_req_t *req, httpd_err_code_t error){
 	esp_err_t err = ESP_OK;
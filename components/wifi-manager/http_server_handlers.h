@@ -58,6 +58,9 @@ esp_err_t recovery_post_handler(httpd_req_t *req);
 esp_err_t flash_post_handler(httpd_req_t *req);
 esp_err_t status_get_handler(httpd_req_t *req);
 esp_err_t messages_get_handler(httpd_req_t *req);
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+esp_err_t status_ws_handler(httpd_req_t *req);
+#endif
 esp_err_t console_cmd_get_handler(httpd_req_t *req);
 esp_err_t console_cmd_post_handler(httpd_req_t *req);
 esp_err_t ap_scan_handler(httpd_req_t *req);
@@ -960,6 +960,8 @@ static state_machine_result_t WIFI_CONNECTED_STATE_entry_handler(state_machine_t
         ESP_LOGD(TAG, "Wifi Config changed. Saving it.");
         network_wifi_save_sta_config();
     }
+    ESP_LOGD(TAG, "Caching connected access point.");
+    network_wifi_cache_active_ap();
     ESP_LOGD(TAG, "Updating the ip info json.");
     network_interface_coexistence(State_Machine);
     nm->wifi_connected = true;
@@ -100,6 +100,9 @@ void network_status_clear_ip() {
 char* network_status_alloc_get_ip_info_json() {
     return cJSON_PrintUnformatted(ip_info_cjson);
 }
+cJSON* network_status_alloc_get_ip_info_cjson() {
+    return cJSON_Duplicate(ip_info_cjson, true);
+}
 
 void network_status_unlock_json_buffer() {
     ESP_LOGV(TAG, "Unlocking json buffer!");
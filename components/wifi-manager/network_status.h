@@ -6,6 +6,7 @@ extern "C" {
 
 #endif
 char* network_status_alloc_get_ip_info_json();
+cJSON* network_status_alloc_get_ip_info_cjson();
 /**
  * @brief Tries to get access to json buffer mutex.
  *
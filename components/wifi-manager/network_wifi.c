@@ -34,6 +34,8 @@ const char ap_list_nsv_namespace[] = "aplist";
 //Roaming support - int rrm_ctx = 0;
 
 uint16_t ap_num = 0;
+/* set while associating with a cached BSSID/channel, cleared on success or fallback */
+static volatile bool directed_connect = false;
 
 esp_netif_t* wifi_netif;
 esp_netif_t* wifi_ap_netif;
@@ -257,18 +259,39 @@ bool network_wifi_known_ap_in_range(){
 }
 const char * network_wifi_get_next_ap_in_range(){
     known_access_point_t* it;
-    time_t last_try_min=(esp_timer_get_time() / 1000);
+    known_access_point_t* best = NULL;
+    const wifi_ap_record_t* best_seen = NULL;
+    /* least recently tried first and, among those, the strongest one from the last scan */
     SLIST_FOREACH(it, &s_ap_list, next) {
-        if (it->found && it->last_try < last_try_min) {
-            last_try_min = it->last_try;
+        if (!it->found) {
+            continue;
         }
-    }
-    SLIST_FOREACH(it, &s_ap_list, next) {
-        if (it->found && it->last_try == last_try_min) {
-            return it->ssid;
+        const wifi_ap_record_t* seen = network_wifi_get_ssid_info(it->ssid);
+        if (!best || it->last_try < best->last_try ||
+            (it->last_try == best->last_try && seen && (!best_seen || seen->rssi > best_seen->rssi))) {
+            best = it;
+            best_seen = seen;
         }
     }
-    return NULL;
+    return best ? best->ssid : NULL;
+}
+static bool network_wifi_has_cached_ap(const known_access_point_t* item) {
+    static const uint8_t none[6] = {0};
+    return item && item->primary > 0 && item->primary <= 14 && memcmp(item->bssid, none, sizeof(none)) != 0;
+}
+static void network_wifi_set_scan_method(wifi_sta_config_t* sta, const known_access_point_t* item) {
+    if (network_wifi_has_cached_ap(item)) {
+        /* last successful AP: probe its channel only and associate with that BSSID */
+        sta->scan_method = WIFI_FAST_SCAN;
+        sta->channel = item->primary;
+        sta->bssid_set = true;
+        memcpy(sta->bssid, item->bssid, sizeof(sta->bssid));
+    } else {
+        sta->scan_method = WIFI_ALL_CHANNEL_SCAN;
+        sta->channel = 0;
+        sta->bssid_set = false;
+    }
+    sta->sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
 }
 
 esp_err_t network_wifi_alloc_ap_json(known_access_point_t* item, char** json_string) {
@@ -314,6 +337,7 @@ bool network_wifi_str2mac(const char* mac, uint8_t* values) {
 esp_err_t network_wifi_add_json_entry(const char* json_text) {
     esp_err_t err = ESP_OK;
     known_access_point_t known_ap;
+    memset(&known_ap, 0x00, sizeof(known_ap));
     if (!json_text || strlen(json_text) == 0) {
         ESP_LOGE(TAG, "Invalid access point json");
         return ESP_ERR_INVALID_ARG;
@@ -468,6 +492,31 @@ esp_err_t network_wifi_store_ap_json(known_access_point_t* item) {
     return err;
 }
 
+esp_err_t network_wifi_cache_active_ap() {
+    wifi_ap_record_t ap;
+    esp_err_t err = esp_wifi_sta_get_ap_info(&ap);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Could not get connected access point info: %s", esp_err_to_name(err));
+        return err;
+    }
+    known_access_point_t* item = network_wifi_get_ap_entry(ap_ssid_string(&ap));
+    if (!item) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (memcmp(item->bssid, ap.bssid, sizeof(item->bssid)) == 0 && item->primary == ap.primary && item->authmode == ap.authmode) {
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "Caching access point for %s on channel %d for faster reconnect", item->ssid, ap.primary);
+    memcpy(item->bssid, ap.bssid, sizeof(item->bssid));
+    item->primary = ap.primary;
+    item->authmode = ap.authmode;
+    item->phy_11b = ap.phy_11b;
+    item->phy_11g = ap.phy_11g;
+    item->phy_11n = ap.phy_11n;
+    item->phy_lr = ap.phy_lr;
+    return network_wifi_store_ap_json(item);
+}
+
 esp_netif_t* network_wifi_get_interface() {
     return wifi_netif;
 }
@@ -664,7 +713,7 @@ bool network_wifi_get_config_for_ssid(wifi_config_t* config, const char* ssid) {
     memset(&config->ap, 0x00, sizeof(config->ap));
     strncpy((char*)config->ap.ssid, item->ssid, sizeof(config->ap.ssid));
     strncpy((char*)config->ap.password, item->password, sizeof(config->ap.ssid));
-    config->sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    network_wifi_set_scan_method(&config->sta, item);
     return true;
 }
 
@@ -744,6 +793,7 @@ static void network_wifi_event_handler(void* arg, esp_event_base_t event_base, i
             }
             FREE_AND_NULL(bssid);
             FREE_AND_NULL(ssid);
+            directed_connect = false;
             network_async(EN_CONNECTED);
 
         } break;
@@ -771,6 +821,18 @@ static void network_wifi_event_handler(void* arg, esp_event_base_t event_base, i
             FREE_AND_NULL(bssid);
             if (s->reason == WIFI_REASON_ROAMING) {
                 ESP_LOGI(TAG, "WiFi Roaming to new access point");
+            } else if (directed_connect && s->reason != WIFI_REASON_ASSOC_LEAVE) {
+                /* cached AP is gone or has moved: retry right away with a full scan */
+                wifi_config_t config;
+                directed_connect = false;
+                ESP_LOGW(TAG, "Cached access point not available. Scanning all channels");
+                if (esp_wifi_get_config(WIFI_IF_STA, &config) == ESP_OK) {
+                    network_wifi_set_scan_method(&config.sta, NULL);
+                    if (esp_wifi_set_config(WIFI_IF_STA, &config) == ESP_OK && esp_wifi_connect() == ESP_OK) {
+                        break;
+                    }
+                }
+                network_async_lost_connection((wifi_event_sta_disconnected_t*)event_data);
             } else {
                 network_async_lost_connection((wifi_event_sta_disconnected_t*)event_data);
             }
@@ -982,9 +1044,9 @@ void network_wifi_filter_unique(wifi_ap_record_t* aplist, uint16_t* aps) {
             wifi_ap_record_t* ap1 = &aplist[j];
             if ((strcmp((const char*)ap->ssid, (const char*)ap1->ssid) == 0) &&
                 (ap->authmode == ap1->authmode)) { /* same SSID, different auth mode is skipped */
-                /* save the rssi for the display */
+                /* keep the strongest AP so rssi, channel and bssid match */
                 if ((ap1->rssi) > (ap->rssi))
-                    ap->rssi = ap1->rssi;
+                    memcpy(ap, ap1, sizeof(wifi_ap_record_t));
                 /* clearing the record */
                 memset(ap1, 0, sizeof(wifi_ap_record_t));
             }
@@ -1157,7 +1219,13 @@ esp_err_t network_wifi_connect(const char* ssid, const char* password) {
     // First Disconnect
     esp_wifi_disconnect();
 
-    config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    // use cached AP details only if we are re-connecting with the same credentials
+    known_access_point_t* item = network_wifi_get_ap_entry(ssid);
+    if (item && password && strcmp(STR_OR_BLANK(item->password), password) != 0) {
+        item = NULL;
+    }
+    network_wifi_set_scan_method(&config.sta, item);
+    directed_connect = config.sta.bssid_set;
     if ((err = esp_wifi_set_config(WIFI_IF_STA, &config)) != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set STA configuration. Error %s", esp_err_to_name(err));
     }
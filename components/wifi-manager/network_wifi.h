@@ -11,6 +11,11 @@ void destroy_network_wifi();
  */
 esp_err_t network_wifi_save_sta_config();
 
+/**
+ * @brief stores BSSID, channel and auth mode of the connected AP so next connection can skip the full scan.
+ */
+esp_err_t network_wifi_cache_active_ap();
+
 
 /**
  * @brief fetch a previously STA wifi config in the flash ram storage.
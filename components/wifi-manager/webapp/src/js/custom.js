@@ -902,10 +902,6 @@ window.saveAutoexec1 = function (apply) {
   const resample=$('#cmd_opt_R input[name=resample]:checked');
   if (resample.length>0 && resample.attr('suffix')!=='') {
     commandLine += resample.attr('suffix');
-    // now check resample_i option and if checked, add suffix to command line
-    if ($('#resample_i').is(":checked") && resample.attr('aint') =='true')  {
-          commandLine += $('#resample_i').attr('suffix');
-    }
 }
 
     
@@ -1489,6 +1485,7 @@ $(document).ready(function () {
   getCommands();
   getMessages();
   checkStatus();
+  startLiveChannel();
 
 });
 
@@ -1636,93 +1633,97 @@ function btExists(name) {
 function getBTSinkOpt(name) {
   return $(`${btSinkNamesOptSel} option:contains('${name}')`);
 }
-function getMessages() {
-  $.ajaxSetup({
-    timeout: messageInterval //Time in milliseconds
-  });
-  $.getJSON('/messages.json', async function (data) {
-    for (const msg of data) {
-      const msgAge = msg.current_time - msg.sent_time;
-      var msgTime = new Date();
-      msgTime.setTime(msgTime.getTime() - msgAge);
-      switch (msg.class) {
-        case 'MESSAGING_CLASS_OTA':
-          flashState.EventOTAMessageClass(msg.message);
-          break;
-        case 'MESSAGING_CLASS_STATS':
-          // for task states, check structure : task_state_t
-          var statsData = JSON.parse(msg.message);
-          console.debug(
-            msgTime.toLocalShort() +
-            ' - Number of running tasks: ' +
-            statsData.ntasks
-          );
-          console.debug(
-            msgTime.toLocalShort() +
-            '\tname' +
-            '\tcpu' +
-            '\tstate' +
-            '\tminstk' +
-            '\tbprio' +
-            '\tcprio' +
-            '\tnum'
-          );
-          if (statsData.tasks) {
-            if ($('#tasks_sect').css('visibility') === 'collapse') {
-              $('#tasks_sect').css('visibility', 'visible');
-            }
-            $('tbody#tasks').html('');
-            statsData.tasks
-              .sort(function (a, b) {
-                return b.cpu - a.cpu;
-              })
-              .forEach(showTask, msgTime);
-          } else if ($('#tasks_sect').css('visibility') === 'visible') {
-            $('tbody#tasks').empty();
-            $('#tasks_sect').css('visibility', 'collapse');
+function handleMessages(data) {
+  for (const msg of data) {
+    const msgAge = msg.current_time - msg.sent_time;
+    var msgTime = new Date();
+    msgTime.setTime(msgTime.getTime() - msgAge);
+    switch (msg.class) {
+      case 'MESSAGING_CLASS_OTA':
+        flashState.EventOTAMessageClass(msg.message);
+        break;
+      case 'MESSAGING_CLASS_STATS':
+        // for task states, check structure : task_state_t
+        var statsData = JSON.parse(msg.message);
+        console.debug(
+          msgTime.toLocalShort() +
+          ' - Number of running tasks: ' +
+          statsData.ntasks
+        );
+        console.debug(
+          msgTime.toLocalShort() +
+          '\tname' +
+          '\tcpu' +
+          '\tstate' +
+          '\tminstk' +
+          '\tbprio' +
+          '\tcprio' +
+          '\tnum'
+        );
+        if (statsData.tasks) {
+          if ($('#tasks_sect').css('visibility') === 'collapse') {
+            $('#tasks_sect').css('visibility', 'visible');
           }
-          break;
-        case 'MESSAGING_CLASS_SYSTEM':
-          showMessage(msg, msgTime);
-          break;
-        case 'MESSAGING_CLASS_CFGCMD':
-          var msgparts = msg.message.split(/([^\n]*)\n(.*)/gs);
-          showCmdMessage(msgparts[1], msg.type, msgparts[2], true);
-          break;
-        case 'MESSAGING_CLASS_BT':
-          if ($("#cfg-audio-bt_source-sink_name").is('input')) {
-            var attr = $("#cfg-audio-bt_source-sink_name")[0].attributes;
-            var attrs = '';
-            for (var j = 0; j < attr.length; j++) {
-              if (attr.item(j).name != "type") {
-                attrs += `${attr.item(j).name} = "${attr.item(j).value}" `;
-              }
+          $('tbody#tasks').html('');
+          statsData.tasks
+            .sort(function (a, b) {
+              return b.cpu - a.cpu;
+            })
+            .forEach(showTask, msgTime);
+        } else if ($('#tasks_sect').css('visibility') === 'visible') {
+          $('tbody#tasks').empty();
+          $('#tasks_sect').css('visibility', 'collapse');
+        }
+        break;
+      case 'MESSAGING_CLASS_SYSTEM':
+        showMessage(msg, msgTime);
+        break;
+      case 'MESSAGING_CLASS_CFGCMD':
+        var msgparts = msg.message.split(/([^\n]*)\n(.*)/gs);
+        showCmdMessage(msgparts[1], msg.type, msgparts[2], true);
+        break;
+      case 'MESSAGING_CLASS_BT':
+        if ($("#cfg-audio-bt_source-sink_name").is('input')) {
+          var attr = $("#cfg-audio-bt_source-sink_name")[0].attributes;
+          var attrs = '';
+          for (var j = 0; j < attr.length; j++) {
+            if (attr.item(j).name != "type") {
+              attrs += `${attr.item(j).name} = "${attr.item(j).value}" `;
             }
-            var curOpt = $("#cfg-audio-bt_source-sink_name")[0].value;
-            $("#cfg-audio-bt_source-sink_name").replaceWith(`<select id="cfg-audio-bt_source-sink_name" ${attrs}><option value="${curOpt}" data-bs-description="${curOpt}">${curOpt}</option></select> `);
           }
-          JSON.parse(msg.message).forEach(function (btEntry) {
-            //<input type="text" class="form-control bg-success" placeholder="name" hasvalue="true" longopts="sink_name" shortopts="n" checkbox="false" cmdname="cfg-audio-bt_source" id="cfg-audio-bt_source-sink_name" name="cfg-audio-bt_source-sink_name">
-            //<select hasvalue="true" longopts="jack_behavior" shortopts="j" checkbox="false" cmdname="cfg-audio-general" id="cfg-audio-general-jack_behavior" name="cfg-audio-general-jack_behavior" class="form-control "><option>--</option><option>Headphones</option><option>Subwoofer</option></select>            
-            if (!btExists(btEntry.name)) {
-              $("#cfg-audio-bt_source-sink_name").append(`<option>${btEntry.name}</option>`);
-              showMessage({ type: msg.type, message: `BT Audio device found: ${btEntry.name} RSSI: ${btEntry.rssi} ` }, msgTime);
-            }
-            getBTSinkOpt(btEntry.name).attr('data-bs-description', `${btEntry.name} (${btEntry.rssi}dB)`)
-              .attr('rssi', btEntry.rssi)
-              .attr('value', btEntry.name)
-              .text(`${btEntry.name} [${btEntry.rssi}dB]`).trigger('change');
+          var curOpt = $("#cfg-audio-bt_source-sink_name")[0].value;
+          $("#cfg-audio-bt_source-sink_name").replaceWith(`<select id="cfg-audio-bt_source-sink_name" ${attrs}><option value="${curOpt}" data-bs-description="${curOpt}">${curOpt}</option></select> `);
+        }
+        JSON.parse(msg.message).forEach(function (btEntry) {
+          //<input type="text" class="form-control bg-success" placeholder="name" hasvalue="true" longopts="sink_name" shortopts="n" checkbox="false" cmdname="cfg-audio-bt_source" id="cfg-audio-bt_source-sink_name" name="cfg-audio-bt_source-sink_name">
+          //<select hasvalue="true" longopts="jack_behavior" shortopts="j" checkbox="false" cmdname="cfg-audio-general" id="cfg-audio-general-jack_behavior" name="cfg-audio-general-jack_behavior" class="form-control "><option>--</option><option>Headphones</option><option>Subwoofer</option></select>            
+          if (!btExists(btEntry.name)) {
+            $("#cfg-audio-bt_source-sink_name").append(`<option>${btEntry.name}</option>`);
+            showMessage({ type: msg.type, message: `BT Audio device found: ${btEntry.name} RSSI: ${btEntry.rssi} ` }, msgTime);
+          }
+          getBTSinkOpt(btEntry.name).attr('data-bs-description', `${btEntry.name} (${btEntry.rssi}dB)`)
+            .attr('rssi', btEntry.rssi)
+            .attr('value', btEntry.name)
+            .text(`${btEntry.name} [${btEntry.rssi}dB]`).trigger('change');
 
-          });
-          $(btSinkNamesOptSel).append($(`${btSinkNamesOptSel} option`).remove().sort(function (a, b) {
-            console.log(`${parseInt($(a).attr('rssi'))} < ${parseInt($(b).attr('rssi'))} ? `);
-            return parseInt($(a).attr('rssi')) < parseInt($(b).attr('rssi')) ? 1 : -1;
-          }));
-          break;
-        default:
-          break;
-      }
+        });
+        $(btSinkNamesOptSel).append($(`${btSinkNamesOptSel} option`).remove().sort(function (a, b) {
+          console.log(`${parseInt($(a).attr('rssi'))} < ${parseInt($(b).attr('rssi'))} ? `);
+          return parseInt($(a).attr('rssi')) < parseInt($(b).attr('rssi')) ? 1 : -1;
+        }));
+        break;
+      default:
+        break;
     }
+  }
+}
+function getMessages() {
+  if (liveChannel) return;
+  $.ajaxSetup({
+    timeout: messageInterval //Time in milliseconds
+  });
+  $.getJSON('/messages.json', async function (data) {
+    handleMessages(data);
     setTimeout(getMessages, messageInterval);
   }).fail(function (xhr, ajaxOptions, thrownError) {
 
@@ -1901,83 +1902,118 @@ function batteryToIcon(voltage) {
 
   return { label: '▪▪▪▪', icon: "battery_full" };
 }
-function checkStatus() {
-  $.ajaxSetup({
-    timeout: statusInterval //Time in milliseconds
-  });
-  $.getJSON('/status.json', function (data) {
-    handleRecoveryMode(data);
-    handleNVSVisible();
-    handleNetworkStatus(data);
-    handlebtstate(data);
-    flashState.EventTargetStatus(data);
-    if(data.depth) {
-      depth = data.depth;
-      if(depth==16){
-        $('#cmd_opt_R').show();
-      }
-      else{
-        $('#cmd_opt_R').hide();
+// live channel: status deltas and messages pushed over a websocket, polling is
+// only used when it is not available (older firmware) or while reconnecting
+let liveChannel = null;
+let liveStatus = {};
+function startLiveChannel() {
+  if (!('WebSocket' in window)) return;
+  const ws = new WebSocket(`ws://${window.location.host}/ws`);
+  ws.onopen = function () {
+    liveChannel = ws;
+    liveStatus = {};
+  };
+  ws.onmessage = function (event) {
+    const update = JSON.parse(event.data);
+    if (update.status) {
+      for (const [key, value] of Object.entries(update.status)) {
+        if (value === null) delete liveStatus[key];
+        else liveStatus[key] = value;
       }
+      handleStatus(liveStatus);
     }
-
-
-    if (data.project_name && data.project_name !== '') {
-      project_name = data.project_name;
-    }
-    if (data.platform_name && data.platform_name !== '') {
-      platform_name = data.platform_name;
-    }
-    if (board_model === '') board_model = project_name;
-    if (board_model === '') board_model = 'Squeezelite-ESP32';
-    if (data.version && data.version !== '') {
-      versionName = data.version;
-      $("#navtitle").html(`${board_model}${recovery ? '<br>[recovery]' : ''}`);
-      $('span#foot-fw').html(`fw: <strong>${versionName}</strong>, mode: <strong>${recovery ? "Recovery" : project_name}</strong>`);
-    } else {
-      $('span#flash-status').html('');
-    }
-    if (data.Voltage) {
-      const bat_icon = batteryToIcon(data.Voltage);
-      $('#battery').html(`${getIcon(bat_icon)}`);
-      $('#battery').attr("aria-label", bat_icon.label);
-      $('#battery').attr("icon", bat_icon.icon);
-      $('#battery').show();
-    } else {
-      $('#battery').hide();
-    }
-    if ((data.message ?? '') != '' && prevmessage != data.message) {
-      // supporting older recovery firmwares - messages will come from the status.json structure
-      prevmessage = data.message;
-      showLocalMessage(data.message, 'MESSAGING_INFO')
+    if (update.messages) handleMessages(update.messages);
+  };
+  ws.onclose = function () {
+    if (liveChannel === ws) {
+      liveChannel = null;
+      getMessages();
+      checkStatus();
     }
-    is_i2c_locked = data.is_i2c_locked;
-    if (is_i2c_locked) {
-      $('flds-cfg-hw-preset').hide();
+    setTimeout(startLiveChannel, statusInterval * 5);
+  };
+}
+function handleStatus(data) {
+  handleRecoveryMode(data);
+  handleNVSVisible();
+  handleNetworkStatus(data);
+  handlebtstate(data);
+  flashState.EventTargetStatus(data);
+  if(data.depth) {
+    depth = data.depth;
+    if(depth==16){
+      $('#cmd_opt_R').show();
     }
-    else {
-      $('flds-cfg-hw-preset').show();
+    else{
+      $('#cmd_opt_R').hide();
     }
-    $("button[onclick*='handleReboot']").removeClass('rebooting');
+  }
 
-    if (typeof lmsBaseUrl == "undefined" || data.lms_ip != prevLMSIP && data.lms_ip && data.lms_port) {
-      const baseUrl = 'http://' + data.lms_ip + ':' + data.lms_port;
-      prevLMSIP = data.lms_ip;
-      $.ajax({
-        url: baseUrl + '/plugins/SqueezeESP32/firmware/-check.bin',
-        type: 'HEAD',
-        dataType: 'text',
-        cache: false,
-        error: function () {
-          // define the value, so we don't check it any more.
-          lmsBaseUrl = '';
-        },
-        success: function () {
-          lmsBaseUrl = baseUrl;
-        }
-      });
-    }
-    $('#o_jack').css({ display: Number(data.Jack) ? 'inline' : 'none' });
+
+  if (data.project_name && data.project_name !== '') {
+    project_name = data.project_name;
+  }
+  if (data.platform_name && data.platform_name !== '') {
+    platform_name = data.platform_name;
+  }
+  if (board_model === '') board_model = project_name;
+  if (board_model === '') board_model = 'Squeezelite-ESP32';
+  if (data.version && data.version !== '') {
+    versionName = data.version;
+    $("#navtitle").html(`${board_model}${recovery ? '<br>[recovery]' : ''}`);
+    $('span#foot-fw').html(`fw: <strong>${versionName}</strong>, mode: <strong>${recovery ? "Recovery" : project_name}</strong>`);
+  } else {
+    $('span#flash-status').html('');
+  }
+  if (data.Voltage) {
+    const bat_icon = batteryToIcon(data.Voltage);
+    $('#battery').html(`${getIcon(bat_icon)}`);
+    $('#battery').attr("aria-label", bat_icon.label);
+    $('#battery').attr("icon", bat_icon.icon);
+    $('#battery').show();
+  } else {
+    $('#battery').hide();
+  }
+  if ((data.message ?? '') != '' && prevmessage != data.message) {
+    // supporting older recovery firmwares - messages will come from the status.json structure
+    prevmessage = data.message;
+    showLocalMessage(data.message, 'MESSAGING_INFO')
+  }
+  is_i2c_locked = data.is_i2c_locked;
+  if (is_i2c_locked) {
+    $('flds-cfg-hw-preset').hide();
+  }
+  else {
+    $('flds-cfg-hw-preset').show();
+  }
+  $("button[onclick*='handleReboot']").removeClass('rebooting');
+
+  if (typeof lmsBaseUrl == "undefined" || data.lms_ip != prevLMSIP && data.lms_ip && data.lms_port) {
+    const baseUrl = 'http://' + data.lms_ip + ':' + data.lms_port;
+    prevLMSIP = data.lms_ip;
+    $.ajax({
+      url: baseUrl + '/plugins/SqueezeESP32/firmware/-check.bin',
+      type: 'HEAD',
+      dataType: 'text',
+      cache: false,
+      error: function () {
+        // define the value, so we don't check it any more.
+        lmsBaseUrl = '';
+      },
+      success: function () {
+        lmsBaseUrl = baseUrl;
+      }
+    });
+  }
+  $('#o_jack').css({ display: Number(data.Jack) ? 'inline' : 'none' });
+}
+function checkStatus() {
+  if (liveChannel) return;
+  $.ajaxSetup({
+    timeout: statusInterval //Time in milliseconds
+  });
+  $.getJSON('/status.json', function (data) {
+    handleStatus(data);
     setTimeout(checkStatus, statusInterval);
   }).fail(function (xhr, ajaxOptions, thrownError) {
     handleExceptionResponse(xhr, ajaxOptions, thrownError);
@@ -2321,13 +2357,9 @@ function processSqueezeliteCommandLine(val) {
     }
   });
   if (parsed.options.hasOwnProperty('u')) {
-    // parse -u v[:i] and check the appropriate radio button with id #resample_v
-    const [resampleValue, resampleInterpolation] = parsed.options.u.split(':');
+    // parse -u v and check the appropriate radio button with id #resample_v (former :i is ignored)
+    const [resampleValue] = parsed.options.u.split(':');
     $(`#resample_${resampleValue}`).prop('checked', true);
-    // if resampleinterpolation is set, check  resample_i checkbox
-    if (resampleInterpolation) {
-      $('#resample_i').prop('checked', true);
-    }
   }
   if (parsed.options.hasOwnProperty('s')) {
     // parse -u v[:i] and check the appropriate radio button with id #resample_v
@@ -71,6 +71,10 @@ void register_regular_handlers(httpd_handle_t server){
 	httpd_register_uri_handler(server, &status_get);
 	httpd_uri_t messages_get = { .uri = "/messages.json", .method = HTTP_GET, .handler = messages_get_handler, .user_ctx = rest_context };
 	httpd_register_uri_handler(server, &messages_get);
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+	httpd_uri_t status_ws = { .uri = "/ws", .method = HTTP_GET, .handler = status_ws_handler, .user_ctx = rest_context, .is_websocket = true };
+	httpd_register_uri_handler(server, &status_ws);
+#endif
 
 	httpd_uri_t commands_get = { .uri = "/commands.json", .method = HTTP_GET, .handler = console_cmd_get_handler, .user_ctx = rest_context };
 	httpd_register_uri_handler(server, &commands_get);
@@ -148,7 +152,8 @@ esp_err_t http_server_start()
 
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.max_uri_handlers = 30;
-    config.max_open_sockets = 3;
+    // one more than before as a live status client keeps its socket open
+    config.max_open_sockets = 4;
 	config.lru_purge_enable = true;
 	config.backlog_conn = 1;
     config.uri_match_fn = httpd_uri_match_wildcard;
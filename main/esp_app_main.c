@@ -114,6 +114,7 @@ const DefaultStringVal defaultStringVals[] = {
     {"dhcp_tmout", "8"},
     {"target", CONFIG_TARGET},
     {"led_vu_config", ""},
+    {"multiroom", ""},
 #ifdef CONFIG_BT_SINK
     {"bt_sink_pin", STR(CONFIG_BT_SINK_PIN)},
     {"bt_sink_volume", "127"},
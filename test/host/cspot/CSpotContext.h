@@ -0,0 +1,29 @@
+#pragma once
+
+// Host stand-in for cspot's context, only what PlaybackState uses
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "Utils.h"  // for getCurrentTimestamp
+
+namespace cspot {
+class TimeProvider {
+ public:
+  unsigned long long getSyncedTimestamp() { return getCurrentTimestamp(); }
+};
+
+struct Context {
+  struct ConfigState {
+    std::string deviceId;
+    std::string deviceName;
+    int volume;
+    std::string username;
+  };
+
+  ConfigState config;
+
+  std::shared_ptr<TimeProvider> timeProvider;
+};
+}  // namespace cspot
@@ -0,0 +1,3 @@
+#pragma once
+
+#define ESP_TASK_PRIO_MIN	0
@@ -0,0 +1,19 @@
+#pragma once
+
+// Host stand-in for FreeRTOS and sdkconfig, only what topology.c uses
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define configMAX_TASK_NAME_LEN					16
+#define tskNO_AFFINITY							0x7FFFFFFF
+#define CONFIG_ESP32_PTHREAD_TASK_PRIO_DEFAULT	5
+#define CONFIG_PTHREAD_TASK_CORE_DEFAULT		1
+#define CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS	1
+
+typedef void* TaskHandle_t;
+typedef unsigned UBaseType_t;
+
+// newlib has it, glibc only since 2.38
+size_t strlcpy(char *dst, const char *src, size_t size);
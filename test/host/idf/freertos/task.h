@@ -0,0 +1,13 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct {
+	const char *pcTaskName;
+	uint32_t ulRunTimeCounter;
+} TaskStatus_t;
+
+TaskHandle_t xTaskGetHandle(const char *name);
+void vTaskPrioritySet(TaskHandle_t handle, UBaseType_t priority);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t count, uint32_t *total);
@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in for the NVS configuration, values are kept by the test
+
+#include <stddef.h>
+
+typedef enum { NVS_TYPE_STR } nvs_type_t;
+
+void* config_alloc_get_default(nvs_type_t type, const char *key, void *default_value, size_t blob_size);
+int config_set_value(nvs_type_t type, const char *key, const void *value);
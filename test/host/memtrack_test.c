@@ -0,0 +1,106 @@
+/* 
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2019, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "trace.h"
+
+#define THREADS	4
+#define LOOPS	100000
+#define KEPT	64
+
+#define CHECK(cond, ...) if (!(cond)) { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); exit(1); }
+
+static char report[4096];
+
+// each call site owns its own noinline function so that it gets a distinct caller address
+static __attribute__((noinline)) void *keep(size_t size) {
+	return malloc(size);
+}
+
+static __attribute__((noinline)) void *churn(size_t size) {
+	return calloc(1, size);
+}
+
+static __attribute__((noinline)) void *grow(void *ptr, size_t size) {
+	return realloc(ptr, size);
+}
+
+static void *worker(void *arg) {
+	unsigned seed = (uintptr_t) arg;
+	void *kept[KEPT] = { 0 };
+
+	for (int i = 0; i < LOOPS; i++) {
+		int n = rand_r(&seed) % KEPT;
+		free(churn(1 + rand_r(&seed) % 512));
+		if (kept[n]) kept[n] = grow(kept[n], 1 + rand_r(&seed) % 1024);
+		else kept[n] = keep(1 + rand_r(&seed) % 1024);
+	}
+
+	for (int i = 0; i < KEPT; i++) free(kept[i]);
+	return NULL;
+}
+
+// live bytes, blocks and allocations of the first site listed
+static void first_site(int *live, int *blocks, unsigned *allocs) {
+	char *line = strstr(report, "allocs\n");
+	CHECK(line, "no site header\n%s", report);
+	CHECK(sscanf(line + 7, "%*x %d %*d %d %*s %*u %u", live, blocks, allocs) == 3, "no site\n%s", report);
+}
+
+int main(void) {
+	pthread_t threads[THREADS];
+	void *blocks[10];
+	int live, count;
+	unsigned allocs;
+
+	// nothing recorded before start
+	free(keep(100));
+	memtrack_report(report, sizeof(report), 10, false);
+	CHECK(strstr(report, "tracking is off"), "tracking should be off\n%s", report);
+
+	CHECK(memtrack_start(), "can't start");
+	CHECK(memtrack_active(), "not active");
+
+	// one site with 10 x 1000 bytes
+	for (int i = 0; i < 10; i++) blocks[i] = keep(1000);
+	memtrack_report(report, sizeof(report), 1, false);
+	first_site(&live, &count, &allocs);
+	CHECK(live == 10000 && count == 10 && allocs == 10, "keep: live %d blocks %d allocs %u\n%s", live, count, allocs, report);
+
+	// realloc moves the accounting to the resizing site
+	blocks[0] = grow(blocks[0], 20000);
+	memtrack_report(report, sizeof(report), 1, false);
+	first_site(&live, &count, &allocs);
+	CHECK(live == 20000 && count == 1, "grow: live %d blocks %d\n%s", live, count, report);
+
+	for (int i = 0; i < 10; i++) free(blocks[i]);
+	memtrack_report(report, sizeof(report), 10, false);
+	CHECK(strstr(report, "0 live blocks"), "blocks left\n%s", report);
+
+	// concurrent churn, the churning site must come first by rate
+	for (int i = 0; i < THREADS; i++) pthread_create(threads + i, NULL, worker, (void*) (uintptr_t) (i + 1));
+	for (int i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+
+	memtrack_report(report, sizeof(report), 3, true);
+	first_site(&live, &count, &allocs);
+	CHECK(allocs == THREADS * LOOPS && live == 0 && count == 0, "churn: live %d blocks %d allocs %u\n%s", live, count, allocs, report);
+	CHECK(strstr(report, "0 live blocks (0 untracked)"), "blocks left after churn\n%s", report);
+
+	memtrack_stop();
+	CHECK(!memtrack_active(), "still active");
+	free(keep(100));
+
+	printf("%s", report);
+	return 0;
+}
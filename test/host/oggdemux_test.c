@@ -0,0 +1,410 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ Ogg demuxer against generated streams: random packet sizes, packets spanning pages,
+ large comments, chained and multiplexed logical streams, garbage to resync on and
+ false capture patterns. Streams are fed in random amounts into buffers of several
+ sizes and packets, released or not, must be exactly what was muxed. Then mutated
+ streams must be demuxed without stalling and with packets inside their buffers.
+ Built with OGG_BENCH, it measures throughput and zero-copy ratio on a long stream.
+*/
+
+#include <time.h>
+#include "squeezelite.h"
+#include "oggdemux.h"
+
+#define STREAMS		300
+#define MUTATIONS	400
+#define MAX_PACKETS	256
+#define PACKETS		20000	// bench
+#define REPEAT		20
+#define CHECK(cond, ...) if (!(cond)) { printf(__VA_ARGS__); printf("\n"); exit(1); }
+
+log_level loglevel = lERROR;
+
+struct blob {
+	u8_t *data;
+	size_t len, size;
+};
+
+struct packet {
+	u8_t *data;
+	size_t bytes;
+	bool bos, eos;
+	s64_t granule;
+};
+
+static unsigned seed;
+static struct blob ogg;
+static struct packet expected[MAX_PACKETS];
+static int count;
+
+void logprint(const char *fmt, ...) { }
+const char *logtime(void) { return ""; }
+
+static unsigned rnd(void) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static void append(struct blob *b, const void *data, size_t len) {
+	if (b->len + len > b->size) {
+		b->size = (b->len + len) * 2;
+		b->data = realloc(b->data, b->size);
+	}
+	if (data) memcpy(b->data + b->len, data, len);
+	else for (size_t i = 0; i < len; i++) b->data[b->len + i] = rnd();
+	b->len += len;
+}
+
+// bitwise, so that it does not share the demuxer's table
+static u32_t crc(const u8_t *p, size_t len) {
+	u32_t crc = 0;
+	while (len--) {
+		crc ^= (u32_t) *p++ << 24;
+		for (int i = 0; i < 8; i++) crc = crc & 0x80000000 ? crc << 1 ^ 0x04c11db7 : crc << 1;
+	}
+	return crc;
+}
+
+static void put32(u8_t *p, u32_t v) {
+	for (int i = 0; i < 4; i++) p[i] = v >> (8 * i);
+}
+
+static void packet_new(struct packet *packet, const char *magic, size_t bytes) {
+	size_t len = magic ? strlen(magic) : 0;
+	struct blob b = { 0 };
+
+	append(&b, magic, len);
+	append(&b, NULL, bytes);
+	packet->data = b.data;
+	packet->bytes = b.len;
+	packet->granule = -1;
+	packet->bos = packet->eos = false;
+}
+
+// random bytes, or ending with a capture pattern that only the CRC of a whole page can reject
+static void garbage(bool trap) {
+	append(&ogg, NULL, 1 + rnd() % 3000);
+	if (trap) {
+		append(&ogg, "OggS", 5);
+		append(&ogg, NULL, rnd() % 30);
+	}
+}
+
+/* Cut packets in pages of a random number of segments, the first page only has the first
+   packet. Pages are stored one after the other in 'pages' with their end offset in 'ends'
+   and 'clean' set when no packet continues in the next page */
+static int paginate(u32_t serial, struct packet *packets, int n, struct blob *pages, size_t *ends, bool *clean) {
+	static const int spans[] = { 1, 2, 3, 17, 100, 255, 255 };
+	struct segment { int packet; size_t offset; u8_t lacing; } *segments;
+	int count = 0, page = 0;
+
+	// a packet ends with a lacing value below 255, so a multiple of 255 ends with a 0
+	for (int i = 0; i < n; i++) count += packets[i].bytes / 255 + 1;
+	segments = malloc(count * sizeof(*segments));
+	count = 0;
+	for (int i = 0; i < n; i++) {
+		for (size_t offset = 0; ; offset += 255) {
+			size_t lacing = min(packets[i].bytes - offset, (size_t) 255);
+			segments[count++] = (struct segment) { i, offset, lacing };
+			if (lacing < 255) break;
+		}
+	}
+
+	for (int first = 0, last; first < count; first = last, page++) {
+		u8_t header[OGG_HEADER_SIZE + 255] = "OggS";
+		size_t start = pages->len;
+		s64_t granule = -1;
+
+		int span = page ? spans[rnd() % 7] : 1;
+		last = min(first + span, count);
+		for (int i = first; i < last; i++) header[OGG_HEADER_SIZE + i - first] = segments[i].lacing;
+
+		// granule position belongs to the last packet that ends in the page
+		for (int i = last - 1; i >= first && granule < 0; i--) {
+			if (segments[i].lacing == 255) continue;
+			granule = page * 1000 + 7;
+			packets[segments[i].packet].granule = granule;
+		}
+
+		header[5] = (page ? 0 : 0x02) | (segments[first].offset ? 0x01 : 0) | (last == count ? 0x04 : 0);
+		put32(header + 6, granule);
+		put32(header + 10, (u64_t) granule >> 32);
+		put32(header + 14, serial);
+		put32(header + 18, page);
+		header[26] = last - first;
+		append(pages, header, OGG_HEADER_SIZE + last - first);
+
+		for (int i = first; i < last; i++) {
+			append(pages, packets[segments[i].packet].data + segments[i].offset, segments[i].lacing);
+		}
+
+		put32(pages->data + start + 22, crc(pages->data + start, pages->len - start));
+		clean[page] = segments[last - 1].lacing < 255;
+		ends[page] = pages->len;
+	}
+
+	free(segments);
+	return page;
+}
+
+/* Up to 3 chained logical streams, each one possibly multiplexed with a foreign one and
+   with garbage where none of our packets is pending. The comment header is skipped like
+   codecs do, so it is expected without data */
+static void generate(void) {
+	static const size_t tags[] = { 10, 3000, 100000 };
+	bool trap = rnd() % 2;
+	int streams = 1 + rnd() % 3;
+
+	ogg.len = count = 0;
+	if (trap) garbage(true);
+
+	for (int s = 0; s < streams; s++) {
+		struct packet *packets = expected + count, foreign[11];
+		struct blob pages = { 0 }, others = { 0 };
+		size_t ends[8192], foreign_ends[256];
+		bool clean[8192], foreign_clean[256];
+		u32_t serial = rnd() << 8 ^ rnd();
+		int n = 2 + rnd() % 59, np, nf = 0;
+
+		packet_new(packets, "OpusHead", 11);
+		packet_new(packets + 1, "OpusTags", trap && !s ? 100000 : tags[rnd() % 3]);
+		for (int i = 2; i < n; i++) {
+			size_t sizes[] = { 0, 1, 254, 255, 256, 510, 1 + rnd() % 3000, 1 + rnd() % 20000 };
+			packet_new(packets + i, NULL, sizes[rnd() % 8]);
+		}
+		np = paginate(serial, packets, n, &pages, ends, clean);
+
+		if (rnd() % 2) {
+			packet_new(foreign, "\x80theora", 30);
+			for (int i = 1; i < 11; i++) packet_new(foreign + i, NULL, 1 + rnd() % 5000);
+			nf = paginate(serial ^ 0x5555, foreign, 11, &others, foreign_ends, foreign_clean);
+			for (int i = 0; i < 11; i++) free(foreign[i].data);
+		}
+
+		// our first page, then foreign pages randomly in between ours
+		for (int i = 0, f = 0; i < np || f < nf;) {
+			bool ours = i < np && (!i || f >= nf || (f && rnd() % 10 >= 3));
+			if (ours) {
+				append(&ogg, pages.data + (i ? ends[i - 1] : 0), ends[i] - (i ? ends[i - 1] : 0));
+				i++;
+			} else {
+				append(&ogg, others.data + (f ? foreign_ends[f - 1] : 0), foreign_ends[f] - (f ? foreign_ends[f - 1] : 0));
+				f++;
+			}
+			if ((!i || clean[i - 1]) && rnd() % 20 == 0) garbage(false);
+		}
+
+		packets[0].bos = true;
+		packets[n - 1].eos = true;
+		free(packets[1].data);
+		packets[1].data = NULL;
+		packets[1].bytes = 0;
+		count += n;
+
+		free(pages.data);
+		free(others.data);
+	}
+}
+
+static void release(void) {
+	for (int i = 0; i < count; i++) free(expected[i].data);
+	count = 0;
+}
+
+/* Feed 'ogg' in random amounts and take packets in random number, released or not. With
+   'check', packets must be the expected ones, otherwise they must just be within their
+   buffer. Return the number of zero-copy packets */
+static int demux(size_t size, bool check) {
+	struct ogg_demux d = { 0 };
+	struct ogg_demux_packet packet;
+	struct buffer b;
+	size_t pos = 0, idle = 0;
+	int got = 0, inplace = 0;
+	bool skip = false, done = false;
+
+	buf_init(&b, size);
+	ogg_demux_init(&d, "OpusHead", 8);
+
+	while (!done) {
+		size_t n = rnd() % 9000, used = _buf_used(&b);
+		int loops = rnd() % 4;
+
+		n = min(n, ogg.len - pos);
+		n = min(n, _buf_space(&b));
+		n = min(n, _buf_cont_write(&b));
+		memcpy(b.writep, ogg.data + pos, n);
+		_buf_inc_writep(&b, n);
+		pos += n;
+
+		// once everything is sent, take all that can be
+		if (pos == ogg.len) {
+			loops = -1;
+			done = true;
+		}
+
+		while (loops-- && _ogg_demux_packet(&d, &b, &packet, skip)) {
+			bool zero_copy = packet.data >= b.buf && packet.data < b.buf + b.size;
+
+			if (zero_copy) {
+				CHECK(packet.data + packet.bytes <= b.wrap, "packet of %zu bytes wraps", packet.bytes);
+				inplace++;
+			} else if (packet.data) {
+				CHECK(packet.data == d.buffer && packet.bytes <= d.size, "packet of %zu bytes is outside of buffers", packet.bytes);
+			} else {
+				CHECK(!packet.bytes, "packet of %zu bytes without data", packet.bytes);
+			}
+
+			if (check) {
+				struct packet *e = expected + got;
+				CHECK(got < count, "more than %d packets", count);
+				CHECK(packet.bos == e->bos && packet.eos == e->eos && packet.granule == e->granule && packet.bytes == e->bytes,
+					  "packet %d: bos %d eos %d granule %lld %zu bytes instead of %d %d %lld %zu bytes", got,
+					  packet.bos, packet.eos, (long long) packet.granule, packet.bytes, e->bos, e->eos, (long long) e->granule, e->bytes);
+				CHECK(!e->bytes || !memcmp(packet.data, e->data, e->bytes), "packet %d: content differs", got);
+			}
+
+			got++;
+			skip = packet.bos;
+			if (rnd() & 1) _ogg_demux_release(&d, &b);
+		}
+
+		// buffer full and nothing taken means the demuxer is stuck
+		idle = !n && _buf_used(&b) == used ? idle + 1 : 0;
+		CHECK(idle < 100, "stuck at %zu out of %zu bytes with %zu in buffer", pos, ogg.len, _buf_used(&b));
+	}
+
+	CHECK(!check || got == count, "%d packets instead of %d", got, count);
+
+	ogg_demux_close(&d);
+	buf_destroy(&b);
+
+	return inplace;
+}
+
+// random byte changes, deletions, insertions and copies of other parts of the stream
+static void mutate(void) {
+	for (int k = 1 + rnd() % 49; k; k--) {
+		size_t at = rnd() % ogg.len, len, from;
+		struct blob chunk = { 0 };
+
+		switch (rnd() % 10) {
+		case 0: case 1: case 2: case 3: case 4:
+			ogg.data[at] = rnd();
+			break;
+		case 5: case 6:
+			len = 1 + rnd() % 499;
+			len = min(len, ogg.len - at);
+			memmove(ogg.data + at, ogg.data + at + len, ogg.len - at - len);
+			ogg.len -= len;
+			break;
+		default:
+			len = 1 + rnd() % 499;
+			from = rnd() % ogg.len;
+			if (rnd() % 2) append(&chunk, NULL, len);
+			else append(&chunk, ogg.data + from, min(len * 6, ogg.len - from));
+			append(&ogg, NULL, chunk.len);
+			memmove(ogg.data + at + chunk.len, ogg.data + at, ogg.len - chunk.len - at);
+			memcpy(ogg.data + at, chunk.data, chunk.len);
+			free(chunk.data);
+			break;
+		}
+		if (!ogg.len) append(&ogg, NULL, 1);
+	}
+}
+
+#ifndef OGG_BENCH
+int main(void) {
+	size_t sizes[] = { 70000, 128 * 1024, 300000 };
+	int runs = 0, packets = 0, inplace = 0;
+
+	for (int i = 0; i < STREAMS; i++) {
+		seed = i + 1;
+		generate();
+		for (int j = 0; j < 3; j++) {
+			inplace += demux(sizes[j], true);
+			packets += count;
+			runs++;
+		}
+		release();
+	}
+
+	for (int i = 0; i < MUTATIONS; i++) {
+		seed = i + 1;
+		generate();
+		release();
+		mutate();
+		demux(sizes[i % 3], false);
+	}
+
+	printf("%d runs, %d packets (%d%% zero-copy) as muxed, %d mutated streams\n", runs, packets, 100 * inplace / packets, MUTATIONS);
+	free(ogg.data);
+
+	return 0;
+}
+#else
+int main(void) {
+	static struct packet packets[PACKETS + 2];
+	static size_t ends[PACKETS * 4];
+	static bool clean[PACKETS * 4];
+	struct blob pages = { 0 };
+	struct ogg_demux d = { 0 };
+	struct ogg_demux_packet packet;
+	struct buffer b;
+	int n = 0, inplace = 0;
+	unsigned sum = 0;
+
+	// typical Opus stream, 100 to 1000 bytes packets
+	seed = 1;
+	packet_new(packets, "OpusHead", 11);
+	packet_new(packets + 1, "OpusTags", 100);
+	for (int i = 2; i < PACKETS + 2; i++) packet_new(packets + i, NULL, 100 + rnd() % 900);
+	paginate(0x1234, packets, PACKETS + 2, &pages, ends, clean);
+
+	buf_init(&b, 2 * 1024 * 1024);
+	struct timespec t0, t1;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	for (int rep = 0; rep < REPEAT; rep++) {
+		size_t pos = 0;
+		bool skip = false;
+
+		ogg_demux_init(&d, "OpusHead", 8);
+		while (pos < pages.len || _buf_used(&b)) {
+			size_t k = min(pages.len - pos, _buf_cont_write(&b));
+			k = min(k, _buf_space(&b));
+			k = min(k, (size_t) 16384);
+			memcpy(b.writep, pages.data + pos, k);
+			_buf_inc_writep(&b, k);
+			pos += k;
+
+			while (_ogg_demux_packet(&d, &b, &packet, skip)) {
+				if (packet.data >= b.buf && packet.data < b.buf + b.size) inplace++;
+				if (packet.bytes) sum += packet.data[packet.bytes - 1];
+				skip = packet.bos;
+				n++;
+				_ogg_demux_release(&d, &b);
+			}
+
+			if (pos == pages.len && !k) break;
+		}
+		_buf_flush(&b);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	double s = t1.tv_sec - t0.tv_sec + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	CHECK(n == REPEAT * (PACKETS + 2), "%d packets instead of %d", n, REPEAT * (PACKETS + 2));
+	printf("%zu bytes stream: %.1f MB/s, %d%% of packets zero-copy (%u)\n", pages.len, REPEAT * pages.len / s / 1e6, 100 * inplace / n, sum);
+
+	return 0;
+}
+#endif
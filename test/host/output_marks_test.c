@@ -0,0 +1,159 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ Simulation of output thread timeline markers. A decoder writes many short tracks in
+ random chunks, some of them at another sample rate, and a device plays a DMA FIFO at
+ the rate each frame was sent with. Checks that:
+	- track and end of stream callbacks give the exact time their frame was played
+	- format markers switch the rate exactly at the first frame of the new format
+	- pending frames match outputbuf plus FIFO
+*/
+
+#include "squeezelite.h"
+
+#define DMA		300
+#define TRACKS	400
+#define CHECK(cond, ...) if (!(cond)) { printf(__VA_ARGS__); printf("\n"); exit(1); }
+
+struct decodestate decode;
+extern struct buffer *outputbuf;
+extern struct outputstate output;
+
+static u32_t now_ms = 5000;
+static unsigned seed = 88;
+
+// gettime_ms ticks by ms and rates are 1000 or 500 so that frames last 1 or 2 ms
+u32_t gettime_ms(void) { return now_ms; }
+void logprint(const char *fmt, ...) { }
+const char *logtime(void) { return ""; }
+bool test_open(const char *device, unsigned rates[], bool userdef_rates) { rates[0] = 1000; return true; }
+void touch_memory(u8_t *buf, size_t size) { }
+void wake_controller(void) { }
+s32_t gain(s32_t g, s32_t s) { return g; }
+s32_t to_gain(float f) { return FIXED_ONE; }
+
+static unsigned rnd(void) { 
+	seed = seed * 1103515245 + 12345; 
+	return seed >> 8; 
+}
+
+// each frame carries a tag (0 for silence) and its rate is known from the tag
+static struct { u32_t tag, rate; } fifo[DMA * 4];
+static int fifo_n;
+static u32_t rate_from[TRACKS + 1], rate_of[TRACKS + 1], formats;
+
+static u32_t tag_rate(u32_t tag) {
+	u32_t rate = 1000;
+	for (u32_t i = 0; i < formats && rate_from[i] <= tag; i++) rate = rate_of[i];
+	return rate;
+}
+
+static int write_cb(frames_t n, bool silence, s32_t gl, s32_t gr, u8_t flags, s32_t ci, s32_t co, ISAMPLE_T **cp) {
+	for (frames_t i = 0; i < n; i++, fifo_n++) {
+		fifo[fifo_n].tag = silence ? 0 : ((u32_t*) outputbuf->readp)[i];
+		fifo[fifo_n].rate = output.current_sample_rate;
+		CHECK(silence || fifo[fifo_n].rate == tag_rate(fifo[fifo_n].tag), "frame %u sent at %u instead of %u", 
+			  fifo[fifo_n].tag, fifo[fifo_n].rate, tag_rate(fifo[fifo_n].tag));
+	}
+	return n;
+}
+
+static u32_t track_first[TRACKS], played_at[TRACKS], fired_at[TRACKS], eos_tag, eos_played, eos_fired;
+static bool track_format[TRACKS];
+static int fired, formats_fired;
+
+static void mark_cb(output_mark_e type, u32_t data, u32_t when) {
+	if (type == OUTPUT_MARK_EOS) eos_fired = when;
+	else if (type == OUTPUT_MARK_FORMAT) formats_fired++;
+	else {
+		CHECK(data == fired, "track %u fired instead of %u", data, fired);
+		fired_at[fired++] = when;
+	}
+}
+
+int main(void) {
+	unsigned rates[MAX_SUPPORTED_SAMPLERATES] = { 1000 };
+	u32_t tag = 1, rate = 1000, last = 0;
+	int track = 0, left = 0, played = 0, bad = 0;
+
+	output_init_common(lERROR, "x", 2000 * BYTES_PER_FRAME, rates, 0);
+	output.write_cb = write_cb;
+	output.state = OUTPUT_RUNNING;
+	output.current_sample_rate = output.next_sample_rate = 1000;
+
+	for (int loop = 0; played < TRACKS || !eos_played || !eos_fired; loop++) {
+		CHECK(loop < 200000, "stuck with %d tracks played and %d fired", played, fired);
+
+		// decoder: short tracks (many fit in buffer), one in 8 changing rate, random chunks
+		for (int k = rnd() % 4; k >= 0; k--) {
+			if (!left && track < TRACKS) {
+				if (!_output_mark(OUTPUT_MARK_TRACK, track, mark_cb)) break;
+				if (rnd() % 8 == 0 && _output_mark(OUTPUT_MARK_FORMAT, rate ^ (1000 ^ 500), rnd() % 2 ? mark_cb : NULL)) {
+					rate ^= 1000 ^ 500;
+					rate_from[formats] = tag;
+					rate_of[formats++] = rate;
+					track_format[track] = true;
+				}
+				track_first[track++] = tag;
+				left = 20 + rnd() % 300;
+			}
+
+			// min() evaluates twice
+			int n = rnd() % 200, space = _buf_space(outputbuf) / BYTES_PER_FRAME - 1;
+			n = min(min(n, left), space);
+
+			for (int i = 0; i < n; i++) {
+				while (!_buf_cont_write(outputbuf));
+				*(u32_t*) outputbuf->writep = tag++;
+				_buf_inc_writep(outputbuf, BYTES_PER_FRAME);
+			}
+
+			if (n > 0) left -= n;
+			if (!left && track == TRACKS && !eos_tag && _output_mark(OUTPUT_MARK_EOS, 0, mark_cb)) eos_tag = tag;
+		}
+
+		// backend: snapshot device then fill DMA
+		output.device_frames = fifo_n;
+		output.updated = now_ms;
+		_output_frames(DMA - fifo_n);
+		output.frames_in_process = 0;
+
+		// device plays a random number of frames, each for the duration of the rate it was sent with
+		bool mixed = false;
+		for (int i = 1 + rnd() % 150; i && fifo_n; i--) {
+			mixed |= fifo[0].rate != output.current_sample_rate;
+			u32_t t = fifo[0].tag;
+			if (t && played < TRACKS && t == track_first[played]) played_at[played++] = now_ms;
+			if (eos_tag && !eos_played && last == eos_tag - 1 && t != last) eos_played = now_ms;
+			last = t;
+			now_ms += 1000 / fifo[0].rate;
+			memmove(fifo, fifo + 1, --fifo_n * sizeof(*fifo));
+		}
+
+		// elapsed time is converted to frames using current rate
+		frames_t pending = _output_pending_frames(), truth = _buf_used(outputbuf) / BYTES_PER_FRAME + fifo_n;
+		CHECK(mixed || pending == truth, "pending %u frames instead of %u", pending, truth);
+	}
+
+	// callbacks convert frames not yet played using current rate, only exact if no change is in DMA 
+	for (int i = 0; i < TRACKS; i++) {
+		bool exact = true;
+		for (int j = i + 1; j < TRACKS && track_first[j] < track_first[i] + DMA; j++) if (track_format[j]) exact = false;
+		if (exact ? fired_at[i] != played_at[i] : abs((int) (fired_at[i] - played_at[i])) > DMA) {
+			if (bad++ < 5) printf("track %d played at %u but fired at %u\n", i, played_at[i], fired_at[i]);
+		}
+	}
+
+	printf("%d tracks, %u format changes (%d callbacks), %d mismatches, end played at %u fired at %u\n", 
+		   TRACKS, formats, formats_fired, bad, eos_played, eos_fired);
+
+	return bad || eos_fired != eos_played;
+}
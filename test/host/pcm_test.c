@@ -0,0 +1,273 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ PCM sample format conversion kernels, checked against the former per-sample code for
+ every size, endianness and channel count. Streams start at every byte offset so that
+ kernels see all alignments and frames straddle the end of streambuf, which is fed and
+ outputbuf drained by random amounts so that chunks are split at both wraps.
+ Built for each BYTES_PER_FRAME.
+*/
+
+#include "squeezelite.h"
+
+#if BYTES_PER_FRAME == 4
+#define SHIFT 16
+#define OPTR_T	u16_t
+#else
+#define OPTR_T	u32_t
+#define SHIFT 0
+#endif
+
+#define STREAM		(4003 * 24)	// bytes, multiple of all frame sizes
+#define RING		4099		// frames
+#define FRAMES		20000
+#define CHECK(cond, ...) if (!(cond)) { printf(__VA_ARGS__); printf("\n"); exit(1); }
+
+log_level loglevel = lERROR;
+struct decodestate decode;
+struct streamstate stream;
+struct outputstate output;
+static struct buffer sbuf, obuf;
+struct buffer *streambuf = &sbuf, *outputbuf = &obuf;
+
+static unsigned seed = 5;
+static u8_t input[FRAMES * 8];
+static OPTR_T ref[FRAMES * 2], out[FRAMES * 2];
+
+void logprint(const char *fmt, ...) { }
+const char *logtime(void) { return ""; }
+unsigned decode_newstream(unsigned sample_rate, unsigned supported_rates[]) { return sample_rate; }
+void _checkfade(bool start) { }
+
+static unsigned rnd(void) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+// former conversion loop, except that it stored mono 24/32 bits samples 3 words apart
+static void scalar(u8_t *iptr, OPTR_T *optr, frames_t frames, int sample_size, int channels, bool bigendian) {
+	size_t count = frames * channels;
+
+	if (channels == 2) {
+		if (sample_size == 1) {
+			while (count--) {
+				*optr++ = *iptr++ << (24-SHIFT);
+			}
+		} else if (sample_size == 2) {
+			if (bigendian) {
+				while (count--) {
+					*optr++ = *(iptr) << (24-SHIFT) | *(iptr+1) << (16-SHIFT);
+					iptr += 2;
+				}
+			} else {
+				while (count--) {
+					*optr++ = *(iptr) << (16-SHIFT) | *(iptr+1) << (24-SHIFT);
+					iptr += 2;
+				}
+			}
+		} else if (sample_size == 3) {
+			if (bigendian) {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr++ = *(iptr) << 8 | *(iptr+1);
+#else
+					*optr++ = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8;
+#endif
+					iptr += 3;
+				}
+			} else {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr++ = *(iptr+1) | *(iptr+2) << 8;
+#else
+					*optr++ = *(iptr) << 8 | *(iptr+1) << 16 | *(iptr+2) << 24;
+#endif
+					iptr += 3;
+				}
+			}
+		} else if (sample_size == 4) {
+			if (bigendian) {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr++ = *(iptr) << 8 | *(iptr+1);
+#else
+					*optr++ = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8 | *(iptr+3);
+#endif
+					iptr += 4;
+				}
+			} else {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr++ = *(iptr+2) | *(iptr+3) << 8;
+#else
+					*optr++ = *(iptr) | *(iptr+1) << 8 | *(iptr+2) << 16 | *(iptr+3) << 24;
+#endif
+					iptr += 4;
+				}
+			}
+		}
+	} else if (channels == 1) {
+		if (sample_size == 1) {
+			while (count--) {
+				*optr = *iptr++ << (24-SHIFT);
+				*(optr+1) = *optr;
+				optr += 2;
+			}
+		} else if (sample_size == 2) {
+			if (bigendian) {
+				while (count--) {
+					*optr = *(iptr) << (24-SHIFT) | *(iptr+1) << (16-SHIFT);
+					*(optr+1) = *optr;
+					iptr += 2;
+					optr += 2;
+				}
+			} else {
+				while (count--) {
+					*optr = *(iptr) << (16-SHIFT) | *(iptr+1) << (24-SHIFT);
+					*(optr+1) = *optr;
+					iptr += 2;
+					optr += 2;
+				}
+			}
+		} else if (sample_size == 3) {
+			if (bigendian) {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr = *(iptr) << 8 | *(iptr+1);
+#else
+					*optr = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8;
+#endif
+					*(optr+1) = *optr;
+					iptr += 3;
+					optr += 2;
+				}
+			} else {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr = *(iptr+1) | *(iptr+2) << 8;
+#else
+					*optr = *(iptr) << 8 | *(iptr+1) << 16 | *(iptr+2) << 24;
+#endif
+					*(optr+1) = *optr;
+					iptr += 3;
+					optr += 2;
+				}
+			}
+		} else if (sample_size == 4) {
+			if (bigendian) {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr = *(iptr) << 8 | *(iptr+1);
+#else
+					*optr = *(iptr) << 24 | *(iptr+1) << 16 | *(iptr+2) << 8 | *(iptr+3);
+#endif
+					*(optr+1) = *optr;
+					iptr += 4;
+					optr += 2;
+				}
+			} else {
+				while (count--) {
+#if BYTES_PER_FRAME == 4
+					*optr = *(iptr+2) | *(iptr+3) << 8;
+#else
+					*optr = *(iptr) | *(iptr+1) << 8 | *(iptr+2) << 16 | *(iptr+3) << 24;
+#endif
+					*(optr+1) = *optr;
+					iptr += 4;
+					optr += 2;
+				}
+			}
+		}
+	}
+}
+
+// output thread takes up to 'frames' from outputbuf
+static size_t drain(u8_t *dst, frames_t frames) {
+	size_t bytes = min(frames * BYTES_PER_FRAME, _buf_used(outputbuf)), done = 0;
+
+	while (done < bytes) {
+		size_t n = min(bytes - done, _buf_cont_read(outputbuf));
+		memcpy(dst + done, outputbuf->readp, n);
+		_buf_inc_readp(outputbuf, n);
+		done += n;
+	}
+
+	return done;
+}
+
+// stream from 'offset' in streambuf, return number of decode calls
+static int run(struct codec *codec, int sample_size, int channels, bool bigendian, int offset) {
+	size_t frame_bytes = sample_size * channels, in_len = FRAMES * frame_bytes, sent = 0, got = 0;
+	int calls = 0;
+
+	// pcm_open realigns streambuf, then a header would have moved us anywhere
+	codec->open('0' + sample_size - 1, '3', '0' + channels, bigendian ? '0' : '1');
+	_buf_inc_readp(streambuf, offset);
+	_buf_inc_writep(streambuf, offset);
+	_buf_flush(outputbuf);
+	decode.new_stream = true;
+
+	while (got < FRAMES * BYTES_PER_FRAME) {
+		// stream thread writes random amounts, not aligned on frames
+		size_t n = rnd() % 3000;
+		n = min(n, in_len - sent);
+		n = min(n, _buf_space(streambuf));
+		while (n) {
+			size_t cont = min(n, _buf_cont_write(streambuf));
+			memcpy(streambuf->writep, input + sent, cont);
+			_buf_inc_writep(streambuf, cont);
+			sent += cont;
+			n -= cont;
+		}
+
+		codec->decode();
+		calls++;
+
+		frames_t f = rnd() % (RING / 2);
+		got += drain((u8_t*) out + got, f);
+		CHECK(calls < 100000, "stuck at %zu bytes out of %zu", got, in_len);
+	}
+
+	for (size_t i = 0; i < FRAMES * 2; i++) {
+		CHECK(out[i] == ref[i], "size %d channels %d %s offset %d: sample %zu is %x instead of %x",
+			  sample_size, channels, bigendian ? "BE" : "LE", offset, i, out[i], ref[i]);
+	}
+
+	return calls;
+}
+
+int main(void) {
+	struct codec *codec;
+	int runs = 0, calls = 0;
+
+	buf_init(streambuf, STREAM);
+	buf_init(outputbuf, RING * BYTES_PER_FRAME);
+	stream.state = STREAMING_HTTP;
+
+	codec = register_pcm();
+	for (size_t i = 0; i < sizeof(input); i++) input[i] = rnd();
+
+	for (int size = 1; size <= 4; size++) {
+		for (int channels = 1; channels <= 2; channels++) {
+			for (int bigendian = 0; bigendian <= 1; bigendian++) {
+				scalar(input, ref, FRAMES, size, channels, bigendian);
+				for (int offset = 0; offset < 2 * size * channels + 4; offset++) {
+					calls += run(codec, size, channels, bigendian, offset);
+					runs++;
+				}
+			}
+		}
+	}
+
+	printf("BYTES_PER_FRAME %d: %d streams, %d decode calls, all bit-exact\n", BYTES_PER_FRAME, runs, calls);
+
+	return 0;
+}
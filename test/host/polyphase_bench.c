@@ -0,0 +1,179 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ Quality and cost of polyphase.c tiers against the former libresample16 ones. For each
+ rate pair it reports:
+	- passband: worst gain of tones up to 0.7 of the lowest nyquist
+	- residual: worst level of everything that is not the tone (images, aliases, noise)
+	- stopband: level of a tone at 1.25 output nyquist that must be rejected (decimation)
+	- drift: error of the output rate, in ppm
+	- cost per stereo output frame, cycles on x86 or ns elsewhere (relative figures only)
+ Returns an error if a polyphase tier misses the figures documented in polyphase.h.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "polyphase.h"
+#include "resample16_ref.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT	"cycles"
+static uint64_t cost_now(void) { return __rdtsc(); }
+#else
+#define COST_UNIT	"ns"
+static uint64_t cost_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+
+#define SECONDS		1
+#define RUNS		10
+#define MAX_RATE	96000
+#define LEVEL		16000
+
+static int16_t in[MAX_RATE * SECONDS * 2], out[MAX_RATE * SECONDS * 2 * 4];
+
+struct resampler_s {
+	const char *name;
+	int tier;
+	int (*process)(int tier, int in_rate, int out_rate, const int16_t *in, int frames, int16_t *out);
+	struct polyphase_s *p;
+	struct { float passband, residual; } limit;
+};
+
+static struct polyphase_s *polyphase;
+
+static int run_polyphase(int tier, int in_rate, int out_rate, const int16_t *in, int frames, int16_t *out) {
+	polyphase_flush(polyphase);
+	return polyphase_process(polyphase, in, frames, out);
+}
+
+static int run_resample16(int tier, int in_rate, int out_rate, const int16_t *in, int frames, int16_t *out) {
+	return resample16_ref(tier, (double) out_rate / in_rate, in, frames, out);
+}
+
+static const struct resampler_s resamplers[] = {
+	{ "polyphase basic", POLYPHASE_BASIC, run_polyphase, NULL, { 4, -12 } },
+	{ "polyphase low", POLYPHASE_LOW, run_polyphase, NULL, { 3, -55 } },
+	{ "polyphase med", POLYPHASE_MED, run_polyphase, NULL, { 0.5, -75 } },
+	{ "polyphase high", POLYPHASE_HIGH, run_polyphase, NULL, { 0.2, -75 } },
+	{ "resample16 basic", RESAMPLE16_BASIC, run_resample16, NULL, { NAN, NAN } },
+	{ "resample16 low", RESAMPLE16_LOW, run_resample16, NULL, { NAN, NAN } },
+	{ "resample16 med", RESAMPLE16_MED, run_resample16, NULL, { NAN, NAN } },
+};
+
+// least squares fit of a tone at normalized frequency w in the middle of the output (edges lack
+// history), returns the energy of what is left
+static double fit(int frames, double w, double *s, double *c) {
+	double xs = 0, xc = 0, ss = 0, cc = 0, sc = 0, xx = 0;
+	int from = frames / 4, to = frames * 3 / 4;
+
+	for (int i = from; i < to; i++) {
+		double x = out[2 * i], sn = sin(w * i), cs = cos(w * i);
+		xs += x * sn;
+		xc += x * cs;
+		ss += sn * sn;
+		cc += cs * cs;
+		sc += sn * cs;
+		xx += x * x;
+	}
+
+	double det = ss * cc - sc * sc;
+	*s = (xs * cc - xc * sc) / det;
+	*c = (xc * ss - xs * sc) / det;
+	return (xx - *s * xs - *c * xc) / (to - from);
+}
+
+// gain of the tone at f and level of what's left once it is removed, both in dB re input
+static void measure(const struct resampler_s *r, int in_rate, int out_rate, double f, double *gain, double *residual, double *drift) {
+	double s, c, w = 2 * M_PI * f / out_rate;
+
+	for (int i = 0; i < in_rate * SECONDS; i++) in[2 * i] = in[2 * i + 1] = lrint(LEVEL * sin(2 * M_PI * f * i / in_rate));
+	int frames = r->process(r->tier, in_rate, out_rate, in, in_rate * SECONDS, out);
+
+	// a rate that is not exact shifts the tone, find where it is not to count it as residual
+	double ratio = 1, best = fit(frames, w, &s, &c);
+	for (double step = 20e-6; step > 0.05e-6; step /= 4) {
+		for (int k = -4; k <= 4; k++) {
+			double error = fit(frames, w * (ratio + k * step), &s, &c);
+			if (error < best) {
+				best = error;
+				ratio += k * step;
+				k = -5;
+			}
+		}
+	}
+
+	double error = fit(frames, w * ratio, &s, &c);
+
+	*gain = 20 * log10(sqrt(s * s + c * c) / LEVEL);
+	*residual = 10 * log10(2 * fmax(error, 1e-3) / (LEVEL * LEVEL));
+	if (drift) *drift = (ratio - 1) * 1e6;
+}
+
+int main(void) {
+	static const int rates[][2] = { { 44100, 48000 }, { 48000, 44100 }, { 88200, 48000 }, { 96000, 48000 }, { 44100, 32000 } };
+	int failed = 0;
+
+	printf("%-17s %13s %9s %9s %9s %6s %8s\n", "", "rates", "passband", "residual", "stopband", "drift", COST_UNIT);
+
+	for (int i = 0; i < sizeof(rates) / sizeof(*rates); i++) {
+		int in_rate = rates[i][0], out_rate = rates[i][1];
+		double nyquist = (in_rate < out_rate ? in_rate : out_rate) / 2.0;
+		double tones[] = { 997, nyquist * 0.25, nyquist * 0.5, nyquist * 0.7 };
+
+		for (int j = 0; j < sizeof(resamplers) / sizeof(*resamplers); j++) {
+			const struct resampler_s *r = resamplers + j;
+			double passband = 0, residual = -200, stopband = NAN, drift, gain, level;
+			uint64_t cost = 0;
+			long frames = 0;
+
+			if (r->process == run_polyphase) polyphase = polyphase_create(in_rate, out_rate, r->tier);
+
+			for (int k = 0; k < sizeof(tones) / sizeof(*tones); k++) {
+				measure(r, in_rate, out_rate, tones[k], &gain, &level, &drift);
+				if (fabs(gain) > fabs(passband)) passband = gain;
+				if (level > residual) residual = level;
+			}
+
+			// a tone above output nyquist (but still under input's) is all residual once aliased
+			if (in_rate > out_rate) {
+				double tone = fmin(out_rate / 2.0 * 1.25, in_rate / 2.0 * 0.98);
+				measure(r, in_rate, out_rate, tone, &gain, &stopband, NULL);
+			}
+
+			for (int k = 0; k < in_rate * SECONDS * 2; k++) in[k] = rand();
+			for (int k = 0; k < RUNS; k++) {
+				uint64_t start = cost_now();
+				frames += r->process(r->tier, in_rate, out_rate, in, in_rate * SECONDS, out);
+				cost += cost_now() - start;
+			}
+
+			if (polyphase) polyphase_delete(polyphase);
+			polyphase = NULL;
+
+			printf("%-17s %6d>%6d %+7.2fdB %7.1fdB %7.1fdB %6.1f %8.1f\n", r->name, in_rate, out_rate,
+				   passband, residual, stopband, drift, (double) cost / frames);
+
+			if (fabs(passband) > r->limit.passband || residual > r->limit.residual) {
+				printf("*** %s misses its limits (%.1fdB, %.1fdB)\n", r->name, r->limit.passband, r->limit.residual);
+				failed++;
+			}
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ Resampling straight into outputbuf. A decoder hands random sized blocks to process_samples
+ and an output thread drains a ring whose size is not a multiple of anything, sometimes
+ not at all, so that chunks hit the wrap point and frames are held on backpressure.
+ What comes out of outputbuf must be byte for byte what the former path produced, where
+ each block was resampled into process.outbuf and then copied.
+*/
+
+#include <math.h>
+#include "squeezelite.h"
+
+#define RING		10007	// frames
+#define FRAMES		400000	// input frames per run
+#define MIN_SPACE	(4096 * BYTES_PER_FRAME)
+#define CHECK(cond, ...) if (!(cond)) { printf(__VA_ARGS__); printf("\n"); exit(1); }
+
+log_level loglevel = lERROR;
+struct decodestate decode;
+extern struct processstate process;
+static struct codec pcm = { .min_space = MIN_SPACE };
+struct codec *codec = &pcm;
+static struct buffer buf;
+struct buffer *outputbuf = &buf;
+
+static unsigned seed;
+static s16_t *input;
+static u8_t *ref, *out;
+
+void logprint(const char *fmt, ...) { }
+const char *logtime(void) { return ""; }
+
+char *next_param(char *src, char c) {
+	return src;
+}
+
+static unsigned rnd(void) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+// former path: whole block into process.outbuf, then copied to a never full output
+static size_t old_process_samples(u8_t *dst) {
+	resample_samples(&process);
+	memcpy(dst, process.outbuf, process.out_frames * BYTES_PER_FRAME);
+	process.in_frames = 0;
+	return process.out_frames * BYTES_PER_FRAME;
+}
+
+// output thread takes up to 'frames' from outputbuf
+static size_t drain(u8_t *dst, frames_t frames) {
+	size_t bytes = min(frames * BYTES_PER_FRAME, _buf_used(outputbuf)), done = 0;
+
+	while (done < bytes) {
+		size_t n = min(bytes - done, _buf_cont_read(outputbuf));
+		memcpy(dst + done, outputbuf->readp, n);
+		_buf_inc_readp(outputbuf, n);
+		done += n;
+	}
+
+	return done;
+}
+
+// decoder block sizes are the same sequence in both runs
+static frames_t next_block(unsigned *blocks, frames_t left) {
+	*blocks = *blocks * 1103515245 + 12345;
+	frames_t n = 1 + (*blocks >> 8) % (MIN_SPACE / BYTES_PER_FRAME);
+	return n < left ? n : left;
+}
+
+static int run(unsigned in_rate, unsigned out_rate, char *quality) {
+	unsigned rates[] = { out_rate, 0 };
+	size_t ref_len = 0, out_len = 0;
+	unsigned blocks, held = 0, wraps = 0;
+	bool direct;
+
+	process_init(quality);
+	CHECK(process_newstream(&direct, in_rate, rates) == out_rate && !direct, "can't resample %u->%u", in_rate, out_rate);
+
+	// reference, feeding all input through the former path
+	blocks = in_rate;
+	for (frames_t pos = 0, n; pos < FRAMES; pos += n) {
+		n = next_block(&blocks, FRAMES - pos);
+		memcpy(process.inbuf, input + pos * 2, n * BYTES_PER_FRAME);
+		process.in_frames = n;
+		ref_len += old_process_samples(ref + ref_len);
+	}
+
+	// same stream, processed into outputbuf like the decode thread does
+	CHECK(process_newstream(&direct, in_rate, rates) == out_rate && !direct, "can't restart %u->%u", in_rate, out_rate);
+	_buf_flush(outputbuf);
+	blocks = in_rate;
+
+	for (frames_t pos = 0, n; pos < FRAMES || process.in_frames; ) {
+		u8_t *writep = outputbuf->writep;
+
+		// held frames go first, then a new block
+		if (!process.in_frames) {
+			n = next_block(&blocks, FRAMES - pos);
+			memcpy(process.inbuf, input + pos * 2, n * BYTES_PER_FRAME);
+			process.in_frames = n;
+			pos += n;
+		}
+
+		process_samples();
+
+		if (process.in_frames) held++;
+		if (outputbuf->writep < writep) wraps++;
+
+		// output thread is sometimes slow, sometimes stalled
+		switch (rnd() % 4) {
+		case 0: break;
+		case 1: n = rnd() % 1024; out_len += drain(out + out_len, n); break;
+		default: n = rnd() % (RING / 2); out_len += drain(out + out_len, n); break;
+		}
+	}
+
+	out_len += drain(out + out_len, RING);
+
+	printf("%6u->%6u %s: %zu bytes, %u wraps, held %u times\n", in_rate, out_rate, quality, out_len, wraps, held);
+
+	CHECK(held && wraps, "backpressure and wrap not exercised");
+	CHECK(out_len == ref_len, "output has %zu bytes instead of %zu", out_len, ref_len);
+	for (size_t i = 0; i < ref_len; i++) CHECK(ref[i] == out[i], "byte %zu differs (frame %zu)", i, i / BYTES_PER_FRAME);
+
+	return 0;
+}
+
+int main(void) {
+	struct { unsigned in, out; } rates[] = { { 44100, 48000 }, { 48000, 44100 }, { 88200, 48000 }, { 22050, 44100 }, { 44100, 32000 }, { 44100, 88200 } };
+	char *qualities[] = { "b", "l", "m", "h" };
+
+	input = malloc(FRAMES * BYTES_PER_FRAME);
+	ref = malloc(FRAMES * 4 * BYTES_PER_FRAME);
+	out = malloc(FRAMES * 4 * BYTES_PER_FRAME);
+	buf_init(outputbuf, RING * BYTES_PER_FRAME);
+	mutex_create(decode.mutex);
+
+	// full scale noise and a tone so that saturation and history both matter
+	seed = 1;
+	for (int i = 0; i < FRAMES; i++) {
+		input[2 * i] = (s16_t) rnd();
+		input[2 * i + 1] = (s16_t) (20000 * sin(i * 0.01));
+	}
+
+	for (size_t r = 0; r < sizeof(rates) / sizeof(*rates); r++) {
+		for (int q = 0; q < 4; q++) run(rates[r].in, rates[r].out, qualities[q]);
+	}
+
+	return 0;
+}
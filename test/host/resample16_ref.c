@@ -0,0 +1,87 @@
+/*
+ *  Host reference of the former libresample16
+ *
+ *  The algorithm, constants and fixed-point arithmetic are those of resample16.c and
+ *  filterkit.c in libresample16, the 16 bits version of Julius O. Smith III's "resample"
+ *  package (bandlimited interpolation, https://ccrma.stanford.edu/~jos/resample/).
+ *  Upstream is distributed under the GNU Lesser General Public License v2.1 or later,
+ *  which applies to this file. It is only built for host tests, never in the firmware.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "resample16_ref.h"
+#include "resample16_tables.h"
+
+#define Nhc		8
+#define Na		7
+#define Np		(Nhc + Na)
+#define Npc		(1 << Nhc)
+#define Pmask	((1 << Np) - 1)
+#define Nh		16
+#define Nhxn	14
+#define Nhg		(Nh - Nhxn)
+#define NLpScl	13
+
+static inline int16_t word_to_hword(int32_t v, int scl) {
+	v = (v + (1 << (scl - 1))) >> scl;
+	if (v > 32767) return 32767;
+	if (v < -32768) return -32768;
+	return v;
+}
+
+// one wing of the filter, ho is the position in the table with Na fractional bits
+static inline int32_t filter(const int16_t *imp, int nwing, const int16_t *x, uint32_t ph, int inc, uint32_t dhb) {
+	uint32_t ho = (ph * dhb) >> Np;
+	const int16_t *end = imp + nwing;
+	int32_t v = 0;
+
+	if (inc > 0) {
+		end--;
+		if (!ph) ho += dhb;
+	}
+
+	for (const int16_t *hp; (hp = imp + (ho >> Na)) < end; ho += dhb, x += inc * 2) {
+		int32_t t = *hp * *x;
+		if (t & (1 << (Nhxn - 1))) t += 1 << (Nhxn - 1);
+		v += t >> Nhxn;
+	}
+
+	return v;
+}
+
+int resample16_ref(resample16_filter_e type, double factor, const int16_t *in, int frames, int16_t *out) {
+	const int16_t *imp = type == RESAMPLE16_MED ? med_imp : low_imp;
+	int nwing = type == RESAMPLE16_MED ? sizeof(med_imp) / sizeof(*med_imp) : sizeof(low_imp) / sizeof(*low_imp);
+	uint32_t dtb = (1.0 / factor) * (1 << Np) + 0.5;
+	uint32_t dhb = (factor < 1 ? factor * Npc : Npc) * (1 << Na) + 0.5;
+	int pad = nwing / Npc / (factor < 1 ? factor : 1) + 2, n = 0;
+	int32_t dc = imp[0];
+
+	// unity gain, scaled down with the cutoff when decimating
+	for (int i = Npc; i < nwing; i += Npc) dc += 2 * imp[i];
+	uint32_t scl = (double) (1 << (Nhxn + Nhg + NLpScl)) / dc * (factor < 1 ? factor : 1) + 0.5;
+
+	int16_t *x = calloc(frames + 2 * pad, 4);
+	memcpy(x + pad * 2, in, frames * 4);
+
+	for (uint64_t time = 0; (time >> Np) < (uint64_t) frames; time += dtb, n++) {
+		const int16_t *xp = x + (pad + (time >> Np)) * 2;
+		uint32_t ph = time & Pmask;
+
+		for (int c = 0; c < 2; c++) {
+			int32_t v;
+			if (type == RESAMPLE16_BASIC) {
+				v = xp[c] * (int32_t) ((1 << Np) - ph) + xp[c + 2] * (int32_t) ph;
+				out[n * 2 + c] = word_to_hword(v, Np);
+			} else {
+				v = filter(imp, nwing, xp + c, ph, -1, dhb) + filter(imp, nwing, xp + c + 2, (-ph) & Pmask, 1, dhb);
+				out[n * 2 + c] = word_to_hword((v >> Nhg) * (int32_t) scl, NLpScl);
+			}
+		}
+	}
+
+	free(x);
+	return n;
+}
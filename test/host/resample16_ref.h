@@ -0,0 +1,25 @@
+/*
+ *  Host reference of the former libresample16
+ *
+ *  The algorithm, constants and fixed-point arithmetic are those of resample16.c and
+ *  filterkit.c in libresample16, the 16 bits version of Julius O. Smith III's "resample"
+ *  package (bandlimited interpolation, https://ccrma.stanford.edu/~jos/resample/).
+ *  Upstream is distributed under the GNU Lesser General Public License v2.1 or later,
+ *  which applies to this file. It is only built for host tests, never in the firmware.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ Host reference of the former libresample16 (J.O. Smith's bandlimited interpolation,
+ 16 bits fixed point), used to compare it with polyphase.c. Same constants, same filter
+ tables and no coefficient interpolation, which is how squeezelite created it. It does
+ a whole interleaved stereo buffer in one call, missing history being zeros.
+*/
+
+typedef enum { RESAMPLE16_BASIC, RESAMPLE16_LOW, RESAMPLE16_MED } resample16_filter_e;
+
+int resample16_ref(resample16_filter_e filter, double factor, const int16_t *in, int frames, int16_t *out);
@@ -0,0 +1,276 @@
+/*
+ *  Filter wings of the former libresample16 (LOW_FILTER_IMP and F21T8_IMP), Npc = 256
+ *  coefficients per zero crossing, Q15. They are data from libresample16, the 16 bits
+ *  version of Julius O. Smith III's "resample" package (https://ccrma.stanford.edu/~jos/resample/),
+ *  copied from the prebuilt library before it was removed so that host tests can compare
+ *  polyphase.c with what it replaced. Upstream is distributed under the GNU Lesser General
+ *  Public License v2.1 or later, which applies to this file. It is never built in the firmware.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// 13 zero crossings
+static const int16_t low_imp[1536] = {
+	32767, 32766, 32764, 32760, 32755, 32749, 32741, 32731, 32721, 32708, 32695, 32679, 32663, 32645, 32625, 32604,
+	32582, 32558, 32533, 32506, 32478, 32448, 32417, 32385, 32351, 32316, 32279, 32241, 32202, 32161, 32119, 32075,
+	32030, 31984, 31936, 31887, 31836, 31784, 31731, 31676, 31620, 31563, 31504, 31444, 31383, 31320, 31256, 31191,
+	31124, 31056, 30987, 30916, 30845, 30771, 30697, 30621, 30544, 30466, 30387, 30306, 30224, 30141, 30057, 29971,
+	29884, 29796, 29707, 29617, 29525, 29433, 29339, 29244, 29148, 29050, 28952, 28852, 28752, 28650, 28547, 28443,
+	28338, 28232, 28125, 28017, 27908, 27797, 27686, 27574, 27461, 27346, 27231, 27115, 26998, 26879, 26760, 26640,
+	26519, 26398, 26275, 26151, 26027, 25901, 25775, 25648, 25520, 25391, 25262, 25131, 25000, 24868, 24735, 24602,
+	24467, 24332, 24197, 24060, 23923, 23785, 23647, 23507, 23368, 23227, 23086, 22944, 22802, 22659, 22515, 22371,
+	22226, 22081, 21935, 21789, 21642, 21494, 21346, 21198, 21049, 20900, 20750, 20600, 20449, 20298, 20146, 19995,
+	19842, 19690, 19537, 19383, 19230, 19076, 18922, 18767, 18612, 18457, 18302, 18146, 17990, 17834, 17678, 17521,
+	17365, 17208, 17051, 16894, 16737, 16579, 16422, 16264, 16106, 15949, 15791, 15633, 15475, 15317, 15159, 15001,
+	14843, 14685, 14527, 14369, 14212, 14054, 13896, 13739, 13581, 13424, 13266, 13109, 12952, 12795, 12639, 12482,
+	12326, 12170, 12014, 11858, 11703, 11548, 11393, 11238, 11084, 10929, 10776, 10622, 10469, 10316, 10164, 10011,
+	9860, 9708, 9557, 9407, 9256, 9106, 8957, 8808, 8659, 8511, 8364, 8216, 8070, 7924, 7778, 7633,
+	7488, 7344, 7200, 7057, 6914, 6773, 6631, 6490, 6350, 6210, 6071, 5933, 5795, 5658, 5521, 5385,
+	5250, 5115, 4981, 4848, 4716, 4584, 4452, 4322, 4192, 4063, 3935, 3807, 3680, 3554, 3429, 3304,
+	3180, 3057, 2935, 2813, 2692, 2572, 2453, 2335, 2217, 2101, 1985, 1870, 1755, 1642, 1529, 1418,
+	1307, 1197, 1088, 979, 872, 765, 660, 555, 451, 348, 246, 145, 44, -54, -153, -250,
+	-347, -443, -537, -631, -724, -816, -908, -998, -1087, -1175, -1263, -1349, -1435, -1519, -1603, -1685,
+	-1767, -1848, -1928, -2006, -2084, -2161, -2237, -2312, -2386, -2459, -2531, -2603, -2673, -2742, -2810, -2878,
+	-2944, -3009, -3074, -3137, -3200, -3261, -3322, -3381, -3440, -3498, -3554, -3610, -3665, -3719, -3772, -3824,
+	-3875, -3925, -3974, -4022, -4069, -4116, -4161, -4205, -4249, -4291, -4333, -4374, -4413, -4452, -4490, -4527,
+	-4563, -4599, -4633, -4666, -4699, -4730, -4761, -4791, -4820, -4848, -4875, -4901, -4926, -4951, -4974, -4997,
+	-5019, -5040, -5060, -5080, -5098, -5116, -5133, -5149, -5164, -5178, -5192, -5205, -5217, -5228, -5238, -5248,
+	-5257, -5265, -5272, -5278, -5284, -5289, -5293, -5297, -5299, -5301, -5303, -5303, -5303, -5302, -5300, -5298,
+	-5295, -5291, -5287, -5282, -5276, -5270, -5263, -5255, -5246, -5237, -5228, -5217, -5206, -5195, -5183, -5170,
+	-5157, -5143, -5128, -5113, -5097, -5081, -5064, -5047, -5029, -5010, -4991, -4972, -4952, -4931, -4910, -4889,
+	-4867, -4844, -4821, -4797, -4774, -4749, -4724, -4699, -4673, -4647, -4620, -4593, -4566, -4538, -4510, -4481,
+	-4452, -4422, -4393, -4363, -4332, -4301, -4270, -4238, -4206, -4174, -4142, -4109, -4076, -4042, -4009, -3975,
+	-3940, -3906, -3871, -3836, -3801, -3765, -3729, -3693, -3657, -3620, -3584, -3547, -3510, -3472, -3435, -3397,
+	-3360, -3322, -3283, -3245, -3207, -3168, -3129, -3091, -3052, -3013, -2973, -2934, -2895, -2855, -2816, -2776,
+	-2736, -2697, -2657, -2617, -2577, -2537, -2497, -2457, -2417, -2377, -2337, -2297, -2256, -2216, -2176, -2136,
+	-2096, -2056, -2016, -1976, -1936, -1896, -1856, -1817, -1777, -1737, -1698, -1658, -1619, -1579, -1540, -1501,
+	-1462, -1423, -1384, -1345, -1306, -1268, -1230, -1191, -1153, -1115, -1077, -1040, -1002, -965, -927, -890,
+	-854, -817, -780, -744, -708, -672, -636, -600, -565, -530, -494, -460, -425, -391, -356, -322,
+	-289, -255, -222, -189, -156, -123, -91, -59, -27, 4, 35, 66, 97, 127, 158, 188,
+	218, 247, 277, 306, 334, 363, 391, 419, 447, 474, 501, 528, 554, 581, 606, 632,
+	657, 683, 707, 732, 756, 780, 803, 827, 850, 872, 895, 917, 939, 960, 981, 1002,
+	1023, 1043, 1063, 1082, 1102, 1121, 1139, 1158, 1176, 1194, 1211, 1228, 1245, 1262, 1278, 1294,
+	1309, 1325, 1340, 1354, 1369, 1383, 1397, 1410, 1423, 1436, 1448, 1461, 1473, 1484, 1496, 1507,
+	1517, 1528, 1538, 1548, 1557, 1566, 1575, 1584, 1592, 1600, 1608, 1616, 1623, 1630, 1636, 1643,
+	1649, 1654, 1660, 1665, 1670, 1675, 1679, 1683, 1687, 1690, 1694, 1697, 1700, 1702, 1704, 1706,
+	1708, 1709, 1711, 1712, 1712, 1713, 1713, 1713, 1713, 1712, 1711, 1710, 1709, 1708, 1706, 1704,
+	1702, 1700, 1697, 1694, 1691, 1688, 1685, 1681, 1677, 1673, 1669, 1664, 1660, 1655, 1650, 1644,
+	1639, 1633, 1627, 1621, 1615, 1609, 1602, 1596, 1589, 1582, 1575, 1567, 1560, 1552, 1544, 1536,
+	1528, 1520, 1511, 1503, 1494, 1485, 1476, 1467, 1458, 1448, 1439, 1429, 1419, 1409, 1399, 1389,
+	1379, 1368, 1358, 1347, 1337, 1326, 1315, 1304, 1293, 1282, 1271, 1260, 1248, 1237, 1225, 1213,
+	1202, 1190, 1178, 1166, 1154, 1142, 1130, 1118, 1106, 1094, 1081, 1069, 1057, 1044, 1032, 1019,
+	1007, 994, 981, 969, 956, 943, 931, 918, 905, 892, 879, 867, 854, 841, 828, 815,
+	802, 790, 777, 764, 751, 738, 725, 713, 700, 687, 674, 662, 649, 636, 623, 611,
+	598, 585, 573, 560, 548, 535, 523, 510, 498, 486, 473, 461, 449, 437, 425, 413,
+	401, 389, 377, 365, 353, 341, 330, 318, 307, 295, 284, 272, 261, 250, 239, 228,
+	217, 206, 195, 184, 173, 163, 152, 141, 131, 121, 110, 100, 90, 80, 70, 60,
+	51, 41, 31, 22, 12, 3, -5, -14, -23, -32, -41, -50, -59, -67, -76, -84,
+	-93, -101, -109, -117, -125, -133, -140, -148, -156, -163, -170, -178, -185, -192, -199, -206,
+	-212, -219, -226, -232, -239, -245, -251, -257, -263, -269, -275, -280, -286, -291, -297, -302,
+	-307, -312, -317, -322, -327, -332, -336, -341, -345, -349, -354, -358, -362, -366, -369, -373,
+	-377, -380, -384, -387, -390, -394, -397, -400, -402, -405, -408, -411, -413, -416, -418, -420,
+	-422, -424, -426, -428, -430, -432, -433, -435, -436, -438, -439, -440, -442, -443, -444, -445,
+	-445, -446, -447, -447, -448, -448, -449, -449, -449, -449, -449, -449, -449, -449, -449, -449,
+	-449, -448, -448, -447, -447, -446, -445, -444, -443, -443, -442, -441, -440, -438, -437, -436,
+	-435, -433, -432, -430, -429, -427, -426, -424, -422, -420, -419, -417, -415, -413, -411, -409,
+	-407, -405, -403, -400, -398, -396, -393, -391, -389, -386, -384, -381, -379, -376, -374, -371,
+	-368, -366, -363, -360, -357, -355, -352, -349, -346, -343, -340, -337, -334, -331, -328, -325,
+	-322, -319, -316, -313, -310, -307, -304, -301, -298, -294, -291, -288, -285, -282, -278, -275,
+	-272, -269, -265, -262, -259, -256, -252, -249, -246, -243, -239, -236, -233, -230, -226, -223,
+	-220, -217, -213, -210, -207, -204, -200, -197, -194, -191, -187, -184, -181, -178, -175, -172,
+	-168, -165, -162, -159, -156, -153, -150, -147, -143, -140, -137, -134, -131, -128, -125, -122,
+	-120, -117, -114, -111, -108, -105, -102, -99, -97, -94, -91, -88, -86, -83, -80, -78,
+	-75, -72, -70, -67, -65, -62, -59, -57, -55, -52, -50, -47, -45, -43, -40, -38,
+	-36, -33, -31, -29, -27, -25, -22, -20, -18, -16, -14, -12, -10, -8, -6, -4,
+	-2, 0, 0, 2, 4, 6, 8, 9, 11, 13, 14, 16, 17, 19, 21, 22,
+	24, 25, 27, 28, 29, 31, 32, 33, 35, 36, 37, 38, 40, 41, 42, 43,
+	44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 56, 57, 58,
+	59, 59, 60, 61, 62, 62, 63, 63, 64, 64, 65, 66, 66, 66, 67, 67,
+	68, 68, 69, 69, 69, 70, 70, 70, 70, 71, 71, 71, 71, 71, 72, 72,
+	72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72,
+	72, 72, 72, 72, 72, 71, 71, 71, 71, 71, 70, 70, 70, 70, 69, 69,
+	69, 69, 68, 68, 68, 67, 67, 67, 66, 66, 66, 65, 65, 64, 64, 64,
+	63, 63, 62, 62, 62, 61, 61, 60, 60, 59, 59, 58, 58, 58, 57, 57,
+	56, 56, 55, 55, 54, 54, 53, 53, 52, 52, 51, 51, 50, 50, 49, 48,
+	48, 47, 47, 46, 46, 45, 45, 44, 44, 43, 43, 42, 42, 41, 41, 40,
+	39, 39, 38, 38, 37, 37, 36, 36, 35, 35, 34, 34, 33, 33, 32, 32,
+	31, 31, 30, 30, 29, 29, 28, 28, 27, 27, 26, 26, 25, 25, 24, 24,
+	23, 23, 23, 22, 22, 21, 21, 20, 20, 20, 19, 19, 18, 18, 17, 17,
+	17, 16, 16, 15, 15, 15, 14, 14, 14, 13, 13, 12, 12, 12, 11, 11,
+	11, 10, 10, 10, 9, 9, 9, 9, 8, 8, 8, 7, 7, 7, 7, 6,
+	6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3, 3,
+	2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -2, -2, -2, -2, -2, -2, -2, -2,
+	-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+	-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+	-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+	-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+// 21 zero crossings
+static const int16_t med_imp[2560] = {
+	32767, 32766, 32764, 32761, 32756, 32750, 32742, 32733, 32723, 32711, 32698, 32684, 32668, 32651, 32632, 32613,
+	32591, 32569, 32545, 32519, 32493, 32465, 32435, 32405, 32373, 32339, 32304, 32268, 32231, 32192, 32152, 32111,
+	32068, 32024, 31978, 31932, 31884, 31834, 31784, 31732, 31679, 31624, 31568, 31511, 31453, 31393, 31332, 31270,
+	31207, 31142, 31076, 31009, 30941, 30871, 30800, 30728, 30655, 30581, 30505, 30428, 30350, 30271, 30190, 30109,
+	30026, 29942, 29857, 29771, 29683, 29595, 29505, 29414, 29322, 29229, 29135, 29040, 28944, 28847, 28748, 28649,
+	28548, 28447, 28344, 28240, 28136, 28030, 27923, 27816, 27707, 27597, 27487, 27375, 27263, 27149, 27035, 26919,
+	26803, 26686, 26568, 26449, 26329, 26208, 26086, 25964, 25841, 25716, 25591, 25466, 25339, 25211, 25083, 24954,
+	24824, 24694, 24563, 24430, 24298, 24164, 24030, 23895, 23759, 23623, 23486, 23348, 23210, 23071, 22932, 22792,
+	22651, 22509, 22367, 22225, 22082, 21938, 21794, 21649, 21504, 21358, 21211, 21065, 20917, 20770, 20621, 20473,
+	20324, 20174, 20024, 19874, 19723, 19572, 19420, 19268, 19116, 18963, 18811, 18657, 18504, 18350, 18196, 18041,
+	17887, 17732, 17577, 17421, 17266, 17110, 16954, 16797, 16641, 16485, 16328, 16171, 16014, 15857, 15700, 15542,
+	15385, 15228, 15070, 14912, 14755, 14597, 14439, 14282, 14124, 13966, 13809, 13651, 13493, 13336, 13178, 13021,
+	12864, 12706, 12549, 12392, 12235, 12079, 11922, 11766, 11609, 11453, 11298, 11142, 10986, 10831, 10676, 10521,
+	10367, 10213, 10059, 9905, 9751, 9598, 9446, 9293, 9141, 8989, 8838, 8687, 8536, 8386, 8236, 8086,
+	7937, 7788, 7640, 7492, 7345, 7198, 7051, 6905, 6759, 6614, 6470, 6326, 6182, 6039, 5897, 5755,
+	5613, 5472, 5332, 5192, 5053, 4915, 4777, 4640, 4503, 4367, 4231, 4096, 3962, 3829, 3696, 3564,
+	3432, 3301, 3171, 3041, 2913, 2785, 2657, 2531, 2405, 2279, 2155, 2031, 1908, 1786, 1665, 1544,
+	1424, 1305, 1187, 1069, 953, 837, 722, 608, 494, 381, 270, 159, 49, -60, -168, -276,
+	-382, -488, -593, -697, -800, -903, -1004, -1104, -1204, -1303, -1401, -1498, -1594, -1689, -1783, -1876,
+	-1969, -2060, -2150, -2240, -2329, -2416, -2503, -2589, -2674, -2758, -2841, -2923, -3004, -3084, -3163, -3241,
+	-3318, -3395, -3470, -3544, -3618, -3690, -3762, -3832, -3901, -3970, -4038, -4104, -4170, -4234, -4298, -4361,
+	-4422, -4483, -4543, -4602, -4659, -4716, -4772, -4827, -4881, -4934, -4986, -5037, -5087, -5136, -5184, -5231,
+	-5277, -5322, -5366, -5410, -5452, -5493, -5533, -5573, -5611, -5649, -5685, -5721, -5755, -5789, -5822, -5854,
+	-5885, -5914, -5943, -5971, -5999, -6025, -6050, -6074, -6098, -6120, -6142, -6163, -6182, -6201, -6219, -6236,
+	-6253, -6268, -6282, -6296, -6309, -6320, -6331, -6341, -6351, -6359, -6366, -6373, -6379, -6384, -6388, -6391,
+	-6394, -6396, -6396, -6397, -6396, -6394, -6392, -6389, -6385, -6380, -6375, -6368, -6361, -6354, -6345, -6336,
+	-6326, -6315, -6303, -6291, -6278, -6265, -6250, -6235, -6219, -6203, -6186, -6168, -6150, -6130, -6111, -6090,
+	-6069, -6047, -6025, -6002, -5978, -5954, -5929, -5903, -5877, -5851, -5823, -5796, -5767, -5738, -5709, -5679,
+	-5648, -5617, -5585, -5553, -5520, -5487, -5453, -5419, -5384, -5349, -5313, -5277, -5240, -5203, -5165, -5127,
+	-5089, -5050, -5011, -4971, -4931, -4890, -4849, -4808, -4766, -4724, -4682, -4639, -4596, -4553, -4509, -4465,
+	-4420, -4375, -4330, -4285, -4239, -4193, -4147, -4100, -4053, -4006, -3959, -3912, -3864, -3816, -3767, -3719,
+	-3670, -3621, -3572, -3523, -3474, -3424, -3374, -3324, -3274, -3224, -3173, -3123, -3072, -3021, -2970, -2919,
+	-2868, -2817, -2766, -2714, -2663, -2611, -2560, -2508, -2457, -2405, -2353, -2301, -2250, -2198, -2146, -2094,
+	-2042, -1990, -1939, -1887, -1835, -1783, -1732, -1680, -1628, -1577, -1526, -1474, -1423, -1372, -1321, -1269,
+	-1219, -1168, -1117, -1066, -1016, -966, -915, -865, -815, -766, -716, -667, -617, -568, -519, -470,
+	-422, -373, -325, -277, -229, -182, -135, -87, -41, 5, 52, 98, 144, 190, 235, 280,
+	325, 370, 414, 458, 502, 546, 589, 632, 675, 717, 759, 801, 843, 884, 925, 965,
+	1005, 1045, 1085, 1124, 1163, 1202, 1240, 1278, 1315, 1352, 1389, 1426, 1462, 1498, 1533, 1568,
+	1603, 1637, 1671, 1704, 1737, 1770, 1803, 1835, 1866, 1897, 1928, 1959, 1989, 2018, 2048, 2076,
+	2105, 2133, 2160, 2188, 2215, 2241, 2267, 2292, 2318, 2342, 2367, 2391, 2414, 2437, 2460, 2482,
+	2504, 2525, 2546, 2567, 2587, 2607, 2626, 2645, 2663, 2681, 2699, 2716, 2733, 2749, 2765, 2780,
+	2795, 2810, 2824, 2838, 2851, 2864, 2876, 2888, 2900, 2911, 2922, 2932, 2942, 2952, 2961, 2970,
+	2978, 2986, 2993, 3000, 3007, 3013, 3019, 3024, 3029, 3034, 3038, 3041, 3045, 3048, 3050, 3052,
+	3054, 3055, 3056, 3057, 3057, 3057, 3056, 3055, 3054, 3052, 3050, 3048, 3045, 3041, 3038, 3034,
+	3029, 3025, 3020, 3014, 3008, 3002, 2996, 2989, 2982, 2974, 2966, 2958, 2950, 2941, 2931, 2922,
+	2912, 2902, 2891, 2881, 2869, 2858, 2846, 2834, 2822, 2809, 2796, 2783, 2769, 2755, 2741, 2727,
+	2712, 2697, 2682, 2666, 2651, 2635, 2618, 2602, 2585, 2568, 2551, 2533, 2515, 2497, 2479, 2461,
+	2442, 2423, 2404, 2385, 2365, 2345, 2325, 2305, 2285, 2264, 2243, 2222, 2201, 2180, 2158, 2137,
+	2115, 2093, 2071, 2048, 2026, 2003, 1980, 1958, 1934, 1911, 1888, 1864, 1841, 1817, 1793, 1769,
+	1745, 1721, 1697, 1672, 1648, 1623, 1599, 1574, 1549, 1524, 1499, 1474, 1449, 1424, 1398, 1373,
+	1348, 1322, 1297, 1271, 1245, 1220, 1194, 1169, 1143, 1117, 1091, 1065, 1040, 1014, 988, 962,
+	936, 911, 885, 859, 833, 807, 782, 756, 730, 704, 679, 653, 627, 602, 576, 551,
+	525, 500, 475, 449, 424, 399, 374, 349, 324, 299, 275, 250, 225, 201, 176, 152,
+	128, 103, 79, 55, 32, 8, -15, -38, -62, -85, -108, -131, -154, -177, -200, -222,
+	-244, -267, -289, -311, -333, -354, -376, -397, -419, -440, -461, -481, -502, -523, -543, -563,
+	-583, -603, -622, -642, -661, -680, -699, -718, -737, -755, -773, -791, -809, -827, -844, -861,
+	-879, -895, -912, -929, -945, -961, -977, -993, -1008, -1024, -1039, -1054, -1068, -1083, -1097, -1111,
+	-1125, -1139, -1152, -1166, -1179, -1191, -1204, -1216, -1229, -1241, -1252, -1264, -1275, -1286, -1297, -1308,
+	-1318, -1329, -1339, -1348, -1358, -1367, -1377, -1386, -1394, -1403, -1411, -1419, -1427, -1434, -1442, -1449,
+	-1456, -1463, -1469, -1476, -1482, -1488, -1493, -1499, -1504, -1509, -1514, -1518, -1523, -1527, -1531, -1534,
+	-1538, -1541, -1544, -1547, -1550, -1552, -1554, -1556, -1558, -1560, -1561, -1562, -1563, -1564, -1565, -1565,
+	-1565, -1565, -1565, -1564, -1564, -1563, -1562, -1561, -1559, -1558, -1556, -1554, -1552, -1549, -1547, -1544,
+	-1541, -1538, -1535, -1531, -1527, -1524, -1520, -1515, -1511, -1506, -1502, -1497, -1492, -1487, -1481, -1476,
+	-1470, -1464, -1458, -1452, -1446, -1439, -1432, -1426, -1419, -1412, -1404, -1397, -1389, -1382, -1374, -1366,
+	-1358, -1350, -1341, -1333, -1324, -1315, -1307, -1298, -1288, -1279, -1270, -1260, -1251, -1241, -1231, -1221,
+	-1211, -1201, -1191, -1180, -1170, -1159, -1149, -1138, -1127, -1116, -1105, -1094, -1083, -1072, -1060, -1049,
+	-1037, -1026, -1014, -1002, -990, -978, -966, -954, -942, -930, -918, -906, -893, -881, -868, -856,
+	-843, -831, -818, -806, -793, -780, -767, -754, -742, -729, -716, -703, -690, -677, -664, -651,
+	-638, -625, -611, -598, -585, -572, -559, -546, -533, -519, -506, -493, -480, -467, -453, -440,
+	-427, -414, -401, -388, -375, -362, -349, -336, -322, -309, -297, -284, -271, -258, -245, -232,
+	-219, -206, -194, -181, -168, -156, -143, -131, -118, -106, -93, -81, -69, -57, -44, -32,
+	-20, -8, 3, 15, 26, 38, 50, 61, 73, 84, 96, 107, 119, 130, 141, 152,
+	163, 174, 185, 195, 206, 217, 227, 238, 248, 258, 269, 279, 289, 299, 308, 318,
+	328, 337, 347, 356, 365, 375, 384, 393, 402, 410, 419, 428, 436, 445, 453, 461,
+	469, 477, 485, 493, 501, 508, 516, 523, 530, 538, 545, 552, 558, 565, 572, 578,
+	585, 591, 597, 603, 609, 615, 621, 627, 632, 638, 643, 648, 653, 658, 663, 668,
+	672, 677, 681, 686, 690, 694, 698, 702, 706, 709, 713, 716, 720, 723, 726, 729,
+	732, 735, 737, 740, 742, 744, 747, 749, 751, 753, 755, 756, 758, 759, 761, 762,
+	763, 764, 765, 766, 767, 767, 768, 768, 768, 769, 769, 769, 769, 769, 768, 768,
+	767, 767, 766, 765, 765, 764, 763, 761, 760, 759, 757, 756, 754, 753, 751, 749,
+	747, 745, 743, 741, 738, 736, 733, 731, 728, 726, 723, 720, 717, 714, 711, 708,
+	704, 701, 698, 694, 691, 687, 683, 680, 676, 672, 668, 664, 660, 656, 651, 647,
+	643, 638, 634, 629, 625, 620, 616, 611, 606, 601, 596, 591, 586, 581, 576, 571,
+	566, 561, 555, 550, 545, 539, 534, 528, 523, 517, 512, 506, 500, 495, 489, 483,
+	477, 471, 466, 460, 454, 448, 442, 436, 430, 424, 418, 412, 405, 399, 393, 387,
+	381, 375, 368, 362, 356, 350, 343, 337, 331, 325, 318, 312, 306, 299, 293, 287,
+	280, 274, 268, 261, 255, 249, 243, 236, 230, 224, 217, 211, 205, 198, 192, 186,
+	180, 173, 167, 161, 155, 149, 143, 136, 130, 124, 118, 112, 106, 100, 94, 88,
+	82, 76, 70, 64, 58, 53, 47, 41, 35, 29, 24, 18, 12, 7, 1, -3,
+	-9, -14, -20, -25, -31, -36, -41, -46, -52, -57, -62, -67, -72, -77, -82, -87,
+	-92, -97, -102, -107, -111, -116, -121, -125, -130, -135, -139, -144, -148, -152, -157, -161,
+	-165, -169, -173, -177, -182, -186, -189, -193, -197, -201, -205, -208, -212, -216, -219, -223,
+	-226, -230, -233, -236, -239, -243, -246, -249, -252, -255, -258, -261, -263, -266, -269, -272,
+	-274, -277, -279, -282, -284, -287, -289, -291, -293, -295, -298, -300, -302, -304, -305, -307,
+	-309, -311, -312, -314, -316, -317, -319, -320, -321, -323, -324, -325, -326, -328, -329, -330,
+	-331, -331, -332, -333, -334, -335, -335, -336, -337, -337, -338, -338, -338, -339, -339, -339,
+	-339, -340, -340, -340, -340, -340, -340, -339, -339, -339, -339, -338, -338, -338, -337, -337,
+	-336, -336, -335, -334, -334, -333, -332, -331, -331, -330, -329, -328, -327, -326, -325, -324,
+	-322, -321, -320, -319, -318, -316, -315, -313, -312, -311, -309, -308, -306, -304, -303, -301,
+	-300, -298, -296, -294, -293, -291, -289, -287, -285, -283, -281, -279, -277, -275, -273, -271,
+	-269, -267, -265, -263, -260, -258, -256, -254, -251, -249, -247, -245, -242, -240, -237, -235,
+	-233, -230, -228, -225, -223, -220, -218, -215, -213, -210, -208, -205, -203, -200, -197, -195,
+	-192, -190, -187, -184, -182, -179, -176, -174, -171, -168, -166, -163, -160, -158, -155, -152,
+	-150, -147, -144, -142, -139, -136, -133, -131, -128, -125, -123, -120, -117, -114, -112, -109,
+	-106, -104, -101, -98, -96, -93, -90, -88, -85, -82, -80, -77, -74, -72, -69, -67,
+	-64, -61, -59, -56, -54, -51, -49, -46, -44, -41, -39, -36, -34, -31, -29, -26,
+	-24, -22, -19, -17, -14, -12, -10, -7, -5, -3, -1, 1, 3, 5, 7, 10,
+	12, 14, 16, 18, 20, 22, 25, 27, 29, 31, 33, 35, 37, 39, 40, 42,
+	44, 46, 48, 50, 52, 53, 55, 57, 59, 60, 62, 64, 65, 67, 69, 70,
+	72, 73, 75, 76, 78, 79, 81, 82, 83, 85, 86, 88, 89, 90, 91, 93,
+	94, 95, 96, 97, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
+	110, 111, 112, 113, 114, 114, 115, 116, 117, 117, 118, 119, 119, 120, 120, 121,
+	121, 122, 123, 123, 123, 124, 124, 125, 125, 125, 126, 126, 126, 127, 127, 127,
+	127, 127, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+	128, 128, 128, 128, 128, 127, 127, 127, 127, 127, 126, 126, 126, 126, 125, 125,
+	125, 124, 124, 123, 123, 123, 122, 122, 121, 121, 120, 120, 119, 119, 118, 118,
+	117, 117, 116, 115, 115, 114, 114, 113, 112, 112, 111, 110, 110, 109, 108, 107,
+	107, 106, 105, 105, 104, 103, 102, 101, 101, 100, 99, 98, 97, 97, 96, 95,
+	94, 93, 92, 91, 90, 90, 89, 88, 87, 86, 85, 84, 83, 82, 81, 80,
+	80, 79, 78, 77, 76, 75, 74, 73, 72, 71, 70, 69, 68, 67, 66, 65,
+	64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 50,
+	49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34,
+	33, 32, 31, 30, 29, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 20,
+	19, 18, 17, 16, 15, 14, 14, 13, 12, 11, 10, 9, 9, 8, 7, 6,
+	5, 5, 4, 3, 2, 2, 1, 0, 0, 0, -1, -2, -3, -3, -4, -5,
+	-5, -6, -7, -7, -8, -9, -9, -10, -10, -11, -12, -12, -13, -14, -14, -15,
+	-15, -16, -16, -17, -17, -18, -18, -19, -19, -20, -20, -21, -21, -22, -22, -23,
+	-23, -24, -24, -25, -25, -25, -26, -26, -26, -27, -27, -28, -28, -28, -29, -29,
+	-29, -30, -30, -30, -30, -31, -31, -31, -32, -32, -32, -32, -33, -33, -33, -33,
+	-33, -34, -34, -34, -34, -34, -34, -35, -35, -35, -35, -35, -35, -35, -36, -36,
+	-36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36,
+	-36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36, -36,
+	-36, -36, -35, -35, -35, -35, -35, -35, -35, -35, -34, -34, -34, -34, -34, -34,
+	-34, -33, -33, -33, -33, -33, -33, -32, -32, -32, -32, -32, -31, -31, -31, -31,
+	-31, -30, -30, -30, -30, -30, -29, -29, -29, -29, -28, -28, -28, -28, -28, -27,
+	-27, -27, -27, -26, -26, -26, -26, -25, -25, -25, -25, -24, -24, -24, -23, -23,
+	-23, -23, -22, -22, -22, -22, -21, -21, -21, -21, -20, -20, -20, -19, -19, -19,
+	-19, -18, -18, -18, -17, -17, -17, -17, -16, -16, -16, -16, -15, -15, -15, -14,
+	-14, -14, -14, -13, -13, -13, -13, -12, -12, -12, -12, -11, -11, -11, -11, -10,
+	-10, -10, -10, -9, -9, -9, -9, -8, -8, -8, -8, -7, -7, -7, -7, -6,
+	-6, -6, -6, -5, -5, -5, -5, -5, -4, -4, -4, -4, -3, -3, -3, -3,
+	-3, -2, -2, -2, -2, -2, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 2, 2,
+	2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 5, 5, 5,
+	5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	5, 5, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+	2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
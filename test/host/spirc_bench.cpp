@@ -0,0 +1,214 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ Spirc notify frames with a large queue. PlaybackState encodes frames with its cached
+ track list and is compared, for time and content, with the former path which copied
+ the list and encoded it again into a new vector for every frame. Then a burst of
+ volume changes is played through the notify coalescing rule of SpircHandler to count
+ frames and bytes sent with and without it.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CSpotContext.h"
+#include "NanoPBExtensions.h"
+#include "NanoPBHelper.h"
+#include "PlaybackState.h"
+#include "TrackReference.h"
+#include "pb_encode.h"
+#include "protobuf/spirc.pb.h"
+
+#define TRACKS 500
+#define FRAMES 200
+#define CHECK(cond, ...) if (!(cond)) { printf(__VA_ARGS__); printf("\n"); exit(1); }
+
+using namespace cspot;
+
+// former TrackReference::pbEncodeTrackList, list and references are copied
+static bool formerEncodeTrackList(pb_ostream_t* stream, const pb_field_t* field,
+                                  void* const* arg) {
+  auto trackQueue = *static_cast<std::vector<TrackReference>*>(*arg);
+  static TrackRef msg = TrackRef_init_zero;
+
+  msg.context.funcs.encode = &bell::nanopb::encodeString;
+  msg.uri.funcs.encode = &bell::nanopb::encodeString;
+  msg.gid.funcs.encode = &bell::nanopb::encodeVector;
+  msg.queued.funcs.encode = &bell::nanopb::encodeBoolean;
+
+  for (auto trackRef : trackQueue) {
+    if (!pb_encode_tag_for_field(stream, field)) {
+      return false;
+    }
+
+    msg.gid.arg = &trackRef.gid;
+    msg.uri.arg = &trackRef.uri;
+    msg.context.arg = &trackRef.context;
+    msg.queued.arg = &trackRef.queued;
+
+    if (!pb_encode_submessage(stream, TrackRef_fields, &msg)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// former encodeCurrentFrame, whole frame into a new vector
+static std::vector<uint8_t> formerEncode(PlaybackState& state,
+                                         std::vector<TrackReference>* tracks) {
+  auto track = state.innerFrame.state.track;
+
+  state.innerFrame.state.track.funcs.encode = &formerEncodeTrackList;
+  state.innerFrame.state.track.arg = tracks;
+  auto frame = pbEncode(Frame_fields, &state.innerFrame);
+  state.innerFrame.state.track = track;
+
+  return frame;
+}
+
+static void fillTracks(std::vector<TrackReference>& tracks, int salt) {
+  tracks.resize(TRACKS);
+  for (int i = 0; i < TRACKS; i++) {
+    tracks[i].gid.assign(16, (uint8_t)(i + salt));
+    tracks[i].uri = "spotify:track:" + std::to_string((i + salt) * 7919);
+    tracks[i].context = "spotify:playlist:37i9dQZF1DXcBWIGoYBM5M";
+    tracks[i].queued = i % 7 == 0;
+  }
+}
+
+// same rule as SpircHandler::notify and flushNotify, on a simulated clock
+struct Notifier {
+  const int NOTIFY_COALESCE_MS = 100;
+  bool coalesce, pending = false;
+  unsigned long long last = 0;
+  int frames = 0, lastSentStep = -1;
+
+  void notify(unsigned long long now, int step) {
+    if (coalesce && now - last < NOTIFY_COALESCE_MS) {
+      pending = true;
+      return;
+    }
+    last = now;
+    pending = false;
+    frames++;
+    lastSentStep = step;
+  }
+
+  void flush(unsigned long long now, int step) {
+    if (!pending || now - last < NOTIFY_COALESCE_MS) return;
+    last = now;
+    pending = false;
+    frames++;
+    lastSentStep = step;
+  }
+};
+
+// remote sends 'steps' volume changes 'interval' ms apart, each one is a packet that
+// wakes the session loop which otherwise returns every 200ms (DISPATCH_WAIT_MS)
+static int burst(bool coalesce, int steps, int interval) {
+  Notifier n{.coalesce = coalesce};
+  unsigned long long now = 1000, wake = now;
+  int step = 0;
+
+  while (step < steps || n.pending) {
+    unsigned long long next = step < steps ? 1000 + step * interval : ~0ULL;
+    if (next <= wake + 200) {
+      now = next;
+      n.notify(now, step++);
+    } else {
+      now = wake + 200;
+    }
+    n.flush(now, step - 1);
+    wake = now;
+  }
+
+  CHECK(n.lastSentStep == steps - 1, "last state of the burst was not sent");
+  return n.frames;
+}
+
+int main() {
+  std::vector<TrackReference> tracks;
+  std::vector<uint8_t> former, cached;
+  size_t bytes;
+  fillTracks(tracks, 0);
+
+  auto ctx = std::make_shared<Context>();
+  ctx->timeProvider = std::make_shared<TimeProvider>();
+  ctx->config.deviceId = "142137fd329622137a14901634264e6f332e2411";
+  ctx->config.deviceName = "squeezelite";
+  ctx->config.volume = 32768;
+
+  PlaybackState state(ctx);
+  state.setTrackList(&tracks);
+  state.innerFrame.state.context_uri = strdup(tracks[0].context.c_str());
+
+  // sets frame header and presence flags, with the list encoded once
+  bytes = state.encodeCurrentFrame(MessageType_kMessageTypeNotify).size();
+
+  // former path, timed on its own
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < FRAMES; i++) {
+    state.innerFrame.state.position_ms = i;
+    former = formerEncode(state, &tracks);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  // cached track list
+  for (int i = 0; i < FRAMES; i++) {
+    state.innerFrame.state.position_ms = i;
+    state.encodeCurrentFrame(MessageType_kMessageTypeNotify);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double formerUs =
+      std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+  double cachedUs =
+      std::chrono::duration<double, std::micro>(t2 - t1).count() / FRAMES;
+
+  // both paths give the same frame, also once the list has changed
+  for (int salt = 0; salt < 3; salt++) {
+    if (salt) {
+      fillTracks(tracks, salt);
+      if (salt == 2) tracks.resize(TRACKS / 3);
+      state.markTrackListChanged();
+    }
+    for (int i = 0; i < 2; i++) {
+      cached = state.encodeCurrentFrame(MessageType_kMessageTypeNotify);
+      former = formerEncode(state, &tracks);
+      CHECK(cached == former,
+            "list %d frame %d: %zu bytes instead of %zu, or content differs",
+            salt, i, cached.size(), former.size());
+    }
+  }
+
+  printf("%d tracks, %zu bytes per frame: %.1f us/frame before, %.1f us/frame "
+         "with cached list, identical\n",
+         TRACKS, bytes, formerUs, cachedUs);
+
+  // volume slides as sent by apps, and a slow one that needs no coalescing
+  int bursts[][2] = {{64, 20}, {32, 50}, {16, 250}};
+  for (auto& b : bursts) {
+    int before = burst(false, b[0], b[1]), after = burst(true, b[0], b[1]);
+    printf("%2d notifies %3d ms apart: %2d frames (%zu kB) before, %2d frames "
+           "(%zu kB) with coalescing\n",
+           b[0], b[1], before, before * bytes / 1024, after,
+           after * bytes / 1024);
+    CHECK(after <= before, "coalescing sent more frames");
+    CHECK(b[1] < 100 || after == before, "spaced notifies were held");
+  }
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ *  Squeezelite for esp32
+ *
+ *  (c) Philippe G. 2020, philippe_44@outlook.com
+ *
+ *  This software is released under the MIT License.
+ *  https://opensource.org/licenses/MIT
+ *
+ */
+
+/*
+ Task topology with stubbed FreeRTOS and NVS. The profile comes from NVS and switches
+ persist and re-prioritize running tasks, whose names FreeRTOS truncates. The report
+ shows CPU shares between two calls and truncates like memtrack_report, so the returned
+ length is always what is in the buffer. Then host threads are pinned from the table to
+ check where they run (trivially when there is a single CPU).
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "platform_config.h"
+#include "topology.h"
+
+#define CHECK(cond, ...) if (!(cond)) { printf(__VA_ARGS__); printf("\n"); exit(1); }
+
+static char nvs[32] = "LEGACY";
+static const char *running[] = { "decode", "mercury_dispatc", "output_i2s" };
+static UBaseType_t priorities[3];
+static uint32_t clock_us;
+
+size_t strlcpy(char *dst, const char *src, size_t size) {
+	size_t len = strlen(src);
+	if (size) {
+		size_t n = len < size ? len : size - 1;
+		memcpy(dst, src, n);
+		dst[n] = '\0';
+	}
+	return len;
+}
+
+void* config_alloc_get_default(nvs_type_t type, const char *key, void *default_value, size_t blob_size) {
+	return strdup(*nvs ? nvs : default_value);
+}
+
+int config_set_value(nvs_type_t type, const char *key, const void *value) {
+	strlcpy(nvs, value, sizeof(nvs));
+	return 0;
+}
+
+// FreeRTOS asserts on names it could not have stored
+TaskHandle_t xTaskGetHandle(const char *name) {
+	CHECK(strlen(name) < configMAX_TASK_NAME_LEN, "task name %s is too long", name);
+	for (int i = 0; i < sizeof(running) / sizeof(*running); i++) {
+		if (!strcmp(running[i], name)) return priorities + i;
+	}
+	return NULL;
+}
+
+void vTaskPrioritySet(TaskHandle_t handle, UBaseType_t priority) {
+	*(UBaseType_t*) handle = priority;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void) {
+	return 3;
+}
+
+// one more second at each call, output_i2s takes 25%, decode 10% and RTSP nothing
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t count, uint32_t *total) {
+	clock_us += 1000000;
+	status[0] = (TaskStatus_t) { "output_i2s", clock_us / 4 };
+	status[1] = (TaskStatus_t) { "decode", clock_us / 10 };
+	status[2] = (TaskStatus_t) { "RTSP", 0 };
+	*total = clock_us;
+	return 3;
+}
+
+static void *worker(void *arg) {
+	usleep(1000);
+	return (void*) (long) sched_getcpu();
+}
+
+int main(void) {
+	char full[2048], buf[2048];
+	size_t len;
+
+	// profile name in NVS is not case sensitive
+	CHECK(!strcmp(topology_profile(), "legacy"), "profile is %s", topology_profile());
+	CHECK(topology_core("output_i2s", 9) == 0, "legacy output_i2s core");
+	CHECK(topology_core("sb_displayer", 9) == tskNO_AFFINITY, "legacy sb_displayer core");
+
+	// lookups and defaults for unknown tasks
+	CHECK(!topology_set_profile("bogus") && !strcmp(nvs, "LEGACY"), "bogus profile accepted");
+	CHECK(topology_set_profile("Audio") && !strcmp(nvs, "audio"), "audio not stored, nvs has %s", nvs);
+	CHECK(topology_core("output_i2s", 9) == 1 && topology_priority("output_i2s", 9) == 15, "audio output_i2s");
+	CHECK(topology_core("nope", 9) == 9 && topology_priority("nope", 7) == 7 && !topology_get(NULL), "unknown task");
+	CHECK(topology_get("decode")->priority == 7 && !topology_get("decode")->psram, "audio decode");
+
+	// running tasks, including one with a truncated name, got their new priority
+	CHECK(priorities[0] == 7 && priorities[1] == 8 && priorities[2] == 15, "priorities %u %u %u",
+		  priorities[0], priorities[1], priorities[2]);
+
+	// first report has no CPU share, then it's measured between reports
+	topology_report(buf, sizeof(buf));
+	CHECK(strstr(buf, "     -\n"), "first report has a share\n%s", buf);
+	len = topology_report(full, sizeof(full));
+	CHECK(len == strlen(full) && len < sizeof(full) - 1, "report is %zu bytes, returned %zu", strlen(full), len);
+	CHECK(strstr(full, "output_i2s              1   15   25%\n") && strstr(full, "decode                  1    7   10%\n") &&
+		  strstr(full, "RTSP                    0    2    0%\n") && strstr(full, "stream                  0    6   n/a\n"),
+		  "wrong report\n%s", full);
+
+	// truncated anywhere, the returned length is what the buffer holds
+	for (size_t size = 1; size <= len + 1; size++) {
+		size_t n = topology_report(buf, size);
+		CHECK(n == strlen(buf) && n == (size <= len ? size - 1 : len) && !strncmp(buf, full, n),
+			  "size %zu: returned %zu for %zu bytes", size, n, strlen(buf));
+	}
+
+	// pin host threads as the table says and check where they actually ran
+	long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+	const char *names[] = { "output_i2s", "decode", "RTP_thread", "stream", "RTSP" };
+	for (int i = 0; i < sizeof(names) / sizeof(*names); i++) {
+		int core = topology_core(names[i], tskNO_AFFINITY);
+		pthread_attr_t attr;
+		cpu_set_t set;
+		pthread_t thread;
+		void *cpu;
+
+		CHECK(core != tskNO_AFFINITY, "%s is not pinned", names[i]);
+		pthread_attr_init(&attr);
+		CPU_ZERO(&set);
+		CPU_SET(core % ncpu, &set);
+		CHECK(!pthread_attr_setaffinity_np(&attr, sizeof(set), &set), "can't pin %s", names[i]);
+		CHECK(!pthread_create(&thread, &attr, worker, NULL), "can't create %s", names[i]);
+		pthread_join(thread, &cpu);
+		pthread_attr_destroy(&attr);
+		CHECK((long) cpu == core % ncpu, "%s ran on cpu %ld instead of %ld", names[i], (long) cpu, core % ncpu);
+	}
+
+	printf("%s%zu bytes report, truncated at every size, threads pinned on %ld cpu\n", full, len, ncpu);
+
+	return 0;
+}